@@ -113,6 +113,18 @@ void EngineBase::initHttpHeaderKeys(
 	}
 }
 
+ResultsBase* EngineBase::processBase(FlatEvidence *evidence) const {
+	if (evidence == nullptr) {
+		return processBase((EvidenceBase*)nullptr);
+	}
+	EvidenceBase copy;
+	for (size_t i = 0; i < evidence->getItemCount(); i++) {
+		copy[string(evidence->getItemKey(i))] =
+			string(evidence->getItemValue(i));
+	}
+	return processBase(&copy);
+}
+
 void EngineBase::setLicenseKey(const string &licenseKey) {
 	this->licenceKey.assign(licenseKey);
 }
@@ -34,6 +34,7 @@
 #include "ConfigBase.hpp"
 #include "MetaData.hpp"
 #include "EvidenceBase.hpp"
+#include "FlatEvidence.hpp"
 #include "ResultsBase.hpp"
 #include "dataset.h"
 #include "property.h"
@@ -113,6 +114,19 @@ namespace FiftyoneDegrees {
 			 */
 			virtual ResultsBase* processBase(EvidenceBase *evidence) const = 0;
 
+			/**
+			 * Processes the flat evidence provided and returns the result.
+			 * By default the evidence is copied to an #EvidenceBase which is
+			 * processed instead. Extending classes should override this to
+			 * pass the C structure from FlatEvidence::get to the C process
+			 * method so that nothing is copied.
+			 * @param evidence to process. The keys in getKeys() will be the
+			 * only ones considered by the engine.
+			 * @return a new results instance with the values for all requested
+			 * properties
+			 */
+			virtual ResultsBase* processBase(FlatEvidence *evidence) const;
+
 			/**
 			 * Refresh the data set from the original file location. This
 			 * should be implemented by the extending class.
@@ -38,11 +38,17 @@ EvidenceBase::~EvidenceBase() {
 }
 
 fiftyoneDegreesEvidenceKeyValuePairArray* EvidenceBase::get() {
-	if (evidence != NULL) {
-		EvidenceFree(evidence);
-		evidence = NULL;
+	if (evidence != NULL && evidence->capacity >= size()) {
+		// Reuse the existing evidence structure as it is large enough.
+		EvidenceReset(evidence);
+	}
+	else {
+		if (evidence != NULL) {
+			EvidenceFree(evidence);
+			evidence = NULL;
+		}
+		evidence = EvidenceCreate((uint32_t)size());
 	}
-	evidence = EvidenceCreate((uint32_t)size());
 	if (evidence != NULL) {
 		for (map<string, string>::const_iterator iterator = begin();
 			iterator != end();
@@ -74,18 +80,15 @@ bool EvidenceBase::isRelevant(
 
 void EvidenceBase::clear() {
 	map<string, string>::clear();
-	EvidenceFree(evidence);
-	evidence = NULL;
+	EvidenceReset(evidence);
 }
 
 void EvidenceBase::erase(iterator position) {
 	map<string, string>::erase(position);
-	EvidenceFree(evidence);
-	evidence = NULL;
+	EvidenceReset(evidence);
 }
 
 void EvidenceBase::erase(iterator first, iterator last) {
 	map<string, string>::erase(first, last);
-	EvidenceFree(evidence);
-	evidence = NULL;
+	EvidenceReset(evidence);
 }
\ No newline at end of file
@@ -91,6 +91,9 @@ namespace FiftyoneDegrees {
 			  * Get the underlying C structure containing the evidence. This
 			  * only includes evidence which is relevant to the engine. Any
 			  * evidence which is irrelevant will not be included in the result.
+			  * The C structure is reused if it has sufficient capacity so an
+			  * instance can be cleared and used for further requests without
+			  * allocating a new structure.
 			  * @return pointer to a populated C evidence structure
 			  */
 			fiftyoneDegreesEvidenceKeyValuePairArray* get();
@@ -102,7 +105,8 @@ namespace FiftyoneDegrees {
 			 */
 
 			 /**
-			  * Clear all evidence items from the instance.
+			  * Clear all evidence items from the instance. The memory used by
+			  * the underlying C structure is retained for reuse.
 			  */
 			void clear();
 
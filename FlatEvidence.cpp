@@ -0,0 +1,295 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "FlatEvidence.hpp"
+
+#include "fiftyone.h"
+#include <algorithm>
+
+using namespace FiftyoneDegrees::Common;
+
+// Initial number of pairs in the C structure.
+#define INITIAL_PAIR_CAPACITY 8
+
+// Initial number of slots in the hash table of keys.
+#define INITIAL_SLOT_CAPACITY 16
+
+FlatEvidence::FlatEvidence() {
+	pairs = nullptr;
+	pairCount = 0;
+}
+
+FlatEvidence::FlatEvidence(FlatEvidence &&other) noexcept
+	: arena(std::move(other.arena)),
+	items(std::move(other.items)),
+	slots(std::move(other.slots)) {
+	// Moving the arena keeps its memory so the pairs still point to it.
+	pairs = other.pairs;
+	pairCount = other.pairCount;
+	other.arena.clear();
+	other.items.clear();
+	other.slots.clear();
+	other.pairs = nullptr;
+	other.pairCount = 0;
+}
+
+FlatEvidence& FlatEvidence::operator=(FlatEvidence &&other) noexcept {
+	if (this != &other) {
+		if (pairs != nullptr) {
+			EvidenceFree(pairs);
+		}
+		arena = std::move(other.arena);
+		items = std::move(other.items);
+		slots = std::move(other.slots);
+		pairs = other.pairs;
+		pairCount = other.pairCount;
+		other.arena.clear();
+		other.items.clear();
+		other.slots.clear();
+		other.pairs = nullptr;
+		other.pairCount = 0;
+	}
+	return *this;
+}
+
+FlatEvidence::~FlatEvidence() {
+	if (pairs != nullptr) {
+		EvidenceFree(pairs);
+		pairs = nullptr;
+	}
+}
+
+size_t FlatEvidence::append(std::string_view characters) {
+	size_t offset = arena.size();
+	arena.insert(arena.end(), characters.begin(), characters.end());
+	arena.push_back('\0');
+	return offset;
+}
+
+size_t FlatEvidence::findSlot(std::string_view key, uint32_t hash) const {
+	size_t mask = slots.size() - 1;
+	size_t slot = hash & mask;
+	while (slots[slot] >= 0) {
+		const Item &item = items[slots[slot]];
+		if (item.hash == hash &&
+			item.keyLength == key.size() &&
+			key.compare(0, key.size(), arena.data() + item.key,
+				item.keyLength) == 0) {
+			break;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void FlatEvidence::setSlotCapacity(size_t capacity) {
+	size_t size = INITIAL_SLOT_CAPACITY;
+	while (size < capacity) {
+		size <<= 1;
+	}
+	slots.assign(size, -1);
+	for (size_t i = 0; i < items.size(); i++) {
+		size_t slot = items[i].hash & (size - 1);
+		while (slots[slot] >= 0) {
+			slot = (slot + 1) & (size - 1);
+		}
+		slots[slot] = (int)i;
+	}
+}
+
+void FlatEvidence::setPair(const Item &item) {
+	EvidenceKeyValuePair *pair = &pairs->items[item.pair];
+	pair->prefix = item.prefix;
+	pair->item.key = arena.data() + item.key + item.prefixLength;
+	pair->item.keyLength = item.keyLength - item.prefixLength;
+	pair->item.value = arena.data() + item.value;
+	pair->item.valueLength = item.valueLength;
+	pair->parsedValue = NULL;
+	pair->header = NULL;
+}
+
+void FlatEvidence::setPairCapacity(uint32_t capacity) {
+	EvidenceKeyValuePairArray *replacement = EvidenceCreate(capacity);
+	if (replacement == nullptr) {
+		throw StatusCodeException(FIFTYONE_DEGREES_STATUS_INSUFFICIENT_MEMORY);
+	}
+	if (pairs != nullptr) {
+		memcpy(
+			replacement->items,
+			pairs->items,
+			sizeof(EvidenceKeyValuePair) * pairCount);
+		EvidenceFree(pairs);
+	}
+	replacement->count = pairCount;
+	pairs = replacement;
+}
+
+void FlatEvidence::add(std::string_view key, std::string_view value) {
+	const char *base = arena.data();
+	const uint32_t hash = StringHash(key.data(), key.size());
+	Item *item = nullptr;
+
+	// Keep the hash table at most half full.
+	if (slots.size() < (items.size() + 1) * 2) {
+		setSlotCapacity((items.size() + 1) * 2);
+	}
+
+	// Replace the value of an existing item with the same key.
+	size_t slot = findSlot(key, hash);
+	if (slots[slot] >= 0) {
+		item = &items[slots[slot]];
+	}
+
+	if (item == nullptr) {
+		Item added;
+		added.key = append(key);
+		added.keyLength = key.size();
+		added.value = append(value);
+		added.valueLength = value.size();
+		added.valueCapacity = value.size();
+		added.prefixLength = 0;
+		added.hash = hash;
+		added.prefix = FIFTYONE_DEGREES_EVIDENCE_IGNORE;
+		added.pair = -1;
+		EvidencePrefixMap *map = EvidenceMapPrefix(arena.data() + added.key);
+		if (map != NULL && isRelevant(map->prefixEnum)) {
+			if (pairs == nullptr || pairCount >= pairs->capacity) {
+				setPairCapacity(pairs == nullptr || pairs->capacity == 0 ?
+					INITIAL_PAIR_CAPACITY : pairs->capacity * 2);
+			}
+			added.prefixLength = map->prefixLength;
+			added.prefix = map->prefixEnum;
+			added.pair = (int)pairCount++;
+			pairs->count = pairCount;
+		}
+		slots[slot] = (int)items.size();
+		items.push_back(added);
+		item = &items.back();
+	}
+	else if (value.size() <= item->valueCapacity) {
+		// Overwrite the old value in place as the new one fits.
+		memcpy(arena.data() + item->value, value.data(), value.size());
+		arena[item->value + value.size()] = '\0';
+		item->valueLength = value.size();
+	}
+	else {
+		item->value = append(value);
+		item->valueLength = value.size();
+		item->valueCapacity = value.size();
+	}
+
+	if (arena.data() != base) {
+		// The arena has moved so all the pairs need to point to it.
+		for (const Item &existing : items) {
+			if (existing.pair >= 0) {
+				setPair(existing);
+			}
+		}
+	}
+	else if (item->pair >= 0) {
+		setPair(*item);
+	}
+}
+
+std::string_view FlatEvidence::getValue(std::string_view key) const {
+	if (slots.empty() == false) {
+		int index = slots[findSlot(key, StringHash(key.data(), key.size()))];
+		if (index >= 0) {
+			return std::string_view(
+				arena.data() + items[index].value,
+				items[index].valueLength);
+		}
+	}
+	return std::string_view();
+}
+
+size_t FlatEvidence::getItemCount() const {
+	return items.size();
+}
+
+std::string_view FlatEvidence::getItemKey(size_t index) const {
+	return std::string_view(
+		arena.data() + items[index].key,
+		items[index].keyLength);
+}
+
+std::string_view FlatEvidence::getItemValue(size_t index) const {
+	return std::string_view(
+		arena.data() + items[index].value,
+		items[index].valueLength);
+}
+
+void FlatEvidence::reserve(size_t itemCount, size_t characters) {
+	items.reserve(itemCount);
+	if (slots.size() < itemCount * 2) {
+		setSlotCapacity(itemCount * 2);
+	}
+	const char *base = arena.data();
+	// Allow for the null terminators of each key and value.
+	arena.reserve(characters + itemCount * 2);
+	if (arena.data() != base) {
+		for (const Item &item : items) {
+			if (item.pair >= 0) {
+				setPair(item);
+			}
+		}
+	}
+	if (pairs == nullptr || pairs->capacity < itemCount) {
+		setPairCapacity((uint32_t)itemCount);
+	}
+}
+
+fiftyoneDegreesEvidenceKeyValuePairArray* FlatEvidence::get() {
+	if (pairs == nullptr) {
+		setPairCapacity(INITIAL_PAIR_CAPACITY);
+	}
+
+	// Remove anything added to the C structure by previous processing.
+	pairs->count = pairCount;
+	EvidenceReset(pairs->next);
+	for (uint32_t i = 0; i < pairCount; i++) {
+		pairs->items[i].parsedValue = NULL;
+		pairs->items[i].header = NULL;
+	}
+	return pairs;
+}
+
+#ifdef _MSC_VER
+#pragma warning (disable:4100)  
+#endif
+bool FlatEvidence::isRelevant(
+	fiftyoneDegreesEvidencePrefix prefix) {
+	return true;
+}
+#ifdef _MSC_VER
+#pragma warning (default:4100)  
+#endif
+
+void FlatEvidence::clear() {
+	arena.clear();
+	items.clear();
+	std::fill(slots.begin(), slots.end(), -1);
+	pairCount = 0;
+	if (pairs != nullptr) {
+		EvidenceReset(pairs);
+	}
+}
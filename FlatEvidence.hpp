@@ -0,0 +1,270 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_FLAT_EVIDENCE_HPP
+#define FIFTYONE_DEGREES_FLAT_EVIDENCE_HPP
+
+#include <string_view>
+#include <vector>
+#include "Exceptions.hpp"
+#include "evidence.h"
+
+namespace FiftyoneDegrees {
+	namespace Common {
+		/**
+		 * Evidence stored in a flat structure which keeps the underlying C
+		 * evidence structure up to date as each item is added.
+		 *
+		 * The keys and values are copied into a single arena of characters
+		 * and the items are held in a vector, rather than a tree of nodes
+		 * each with their own strings. Keys are found with a hash table of
+		 * the items. Clearing the instance retains the capacity of the
+		 * arena, the items, the hash table and the C structure, so once an
+		 * instance has been used for a request of a typical size further
+		 * requests are constructed without any heap operations.
+		 *
+		 * Unlike #EvidenceBase this is not a map. EngineBase::processBase
+		 * has an overload which takes this class. Engines override it to
+		 * pass the C structure returned by #get straight to their C process
+		 * method.
+		 *
+		 * An instance owns the C structure, so it can be moved but not
+		 * copied.
+		 *
+		 * ## Usage Example
+		 *
+		 * ```
+		 * using namespace FiftyoneDegrees::Common;
+		 * FlatEvidence evidence;
+		 *
+		 * for (each request) {
+		 *     // Add the evidence for the request
+		 *     evidence.add("header.user-agent", userAgent);
+		 *
+		 *     // Give the evidence to an engine for processing and do
+		 *     // something with the results
+		 *     ResultsBase *results = engine->processBase(&evidence);
+		 *     // ...
+		 *     delete results;
+		 *
+		 *     // Clear the evidence ready for the next request
+		 *     evidence.clear();
+		 * }
+		 * ```
+		 */
+		class FlatEvidence {
+		public:
+			/**
+			 * @name Constructors and Destructors
+			 * @{
+			 */
+
+			/**
+			 * Construct a new instance containing no evidence.
+			 */
+			FlatEvidence();
+
+			/**
+			 * Move the evidence and the C structure from another instance,
+			 * leaving it with no evidence.
+			 * @param other instance to move from
+			 */
+			FlatEvidence(FlatEvidence &&other) noexcept;
+
+			/**
+			 * Free the evidence of this instance and move the evidence and
+			 * the C structure from another instance, leaving it with no
+			 * evidence.
+			 * @param other instance to move from
+			 * @return this instance
+			 */
+			FlatEvidence& operator=(FlatEvidence &&other) noexcept;
+
+			/** Copying is not supported as the C structure is owned. */
+			FlatEvidence(const FlatEvidence&) = delete;
+
+			/** Copying is not supported as the C structure is owned. */
+			FlatEvidence& operator=(const FlatEvidence&) = delete;
+
+			/**
+			 * Free all the underlying memory containing the evidence.
+			 */
+			virtual ~FlatEvidence();
+
+			/**
+			 * @}
+			 * @name Evidence
+			 * @{
+			 */
+
+			/**
+			 * Add an item of evidence, replacing the value of any item that
+			 * already has the same key. A replacement value no longer than
+			 * the first value for the key is written over it. The key and
+			 * value are copied so must not refer to memory held by this
+			 * instance.
+			 * @param key of the evidence including the prefix, for example
+			 * "header.user-agent"
+			 * @param value of the evidence
+			 */
+			void add(std::string_view key, std::string_view value);
+
+			/**
+			 * Get the value of the item of evidence with the key provided.
+			 * The view is valid until the instance is cleared or more
+			 * evidence is added.
+			 * @param key of the evidence including the prefix
+			 * @return view of the value, or an empty view with a null data
+			 * pointer if there is no item with the key
+			 */
+			std::string_view getValue(std::string_view key) const;
+
+			/**
+			 * Get the number of items of evidence added, including any which
+			 * are not relevant to the engine.
+			 * @return number of items
+			 */
+			size_t getItemCount() const;
+
+			/**
+			 * Get the key of the item of evidence at the index provided.
+			 * The view is valid until the instance is cleared or more
+			 * evidence is added.
+			 * @param index of the item in the order added, less than
+			 * #getItemCount
+			 * @return view of the key including the prefix
+			 */
+			std::string_view getItemKey(size_t index) const;
+
+			/**
+			 * Get the value of the item of evidence at the index provided.
+			 * The view is valid until the instance is cleared or more
+			 * evidence is added.
+			 * @param index of the item in the order added, less than
+			 * #getItemCount
+			 * @return view of the value
+			 */
+			std::string_view getItemValue(size_t index) const;
+
+			/**
+			 * Reserve memory for the number of items and characters provided
+			 * so that they can be added without further allocation.
+			 * @param items number of items of evidence
+			 * @param characters total length of all the keys and values
+			 */
+			void reserve(size_t items, size_t characters);
+
+			/**
+			 * Get the underlying C structure containing the relevant
+			 * evidence. The structure is kept up to date as evidence is
+			 * added, so no work is needed other than removing any evidence
+			 * added to it by the previous processing.
+			 * @return pointer to a populated C evidence structure
+			 */
+			fiftyoneDegreesEvidenceKeyValuePairArray* get();
+
+			/**
+			 * Clear all evidence items from the instance. The memory used is
+			 * retained for reuse.
+			 */
+			void clear();
+
+			/**
+			 * @}
+			 */
+		protected:
+			/**
+			 * Get whether or not the evidence key prefix is relevant or not.
+			 * If the prefix is not relevant or not known then it is of no use
+			 * to the engine processing it.
+			 * @param prefix extracted from the evidence key
+			 * @return true if the key prefix relevant and should be used
+			 */
+			virtual bool isRelevant(fiftyoneDegreesEvidencePrefix prefix);
+		private:
+			/** An item of evidence with positions in the arena. */
+			typedef struct item_t {
+				size_t key; /**< Offset of the key in the arena */
+				size_t keyLength; /**< Length of the key */
+				size_t value; /**< Offset of the value in the arena */
+				size_t valueLength; /**< Length of the value */
+				size_t valueCapacity; /**< Characters available for the value
+									  before its null terminator */
+				size_t prefixLength; /**< Length of the key's prefix */
+				uint32_t hash; /**< Hash of the key */
+				fiftyoneDegreesEvidencePrefix prefix; /**< Prefix of the key */
+				int pair; /**< Index of the pair in the C structure, or -1 if
+						  the evidence is not relevant */
+			} Item;
+
+			/**
+			 * Appends the characters and a null terminator to the arena.
+			 * @return offset of the characters in the arena
+			 */
+			size_t append(std::string_view characters);
+
+			/**
+			 * Returns the slot in the hash table which holds the item with
+			 * the key, or the empty slot where it would be added.
+			 */
+			size_t findSlot(std::string_view key, uint32_t hash) const;
+
+			/**
+			 * Replaces the hash table with one of at least the capacity
+			 * provided, adding the items already added.
+			 */
+			void setSlotCapacity(size_t capacity);
+
+			/**
+			 * Points the pair in the C structure at the key and value of the
+			 * item in the arena.
+			 */
+			void setPair(const Item &item);
+
+			/**
+			 * Replaces the C structure with one of the capacity provided,
+			 * copying the pairs already added.
+			 */
+			void setPairCapacity(uint32_t capacity);
+
+			/** Keys and values each followed by a null terminator. */
+			std::vector<char> arena;
+
+			/** Items of evidence in the order they were added. */
+			std::vector<Item> items;
+
+			/**
+			 * Hash table of the index of each item, or -1 for an empty slot.
+			 * The number of slots is a power of two.
+			 */
+			std::vector<int> slots;
+
+			/** The underlying evidence structure. */
+			fiftyoneDegreesEvidenceKeyValuePairArray *pairs;
+
+			/** Number of pairs in the C structure added from the items. */
+			uint32_t pairCount;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,103 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_PROPERTY_HANDLE_HPP
+#define FIFTYONE_DEGREES_PROPERTY_HANDLE_HPP
+
+#include <string>
+
+using std::string;
+
+namespace FiftyoneDegrees {
+	namespace Common {
+		/**
+		 * A property name resolved to its index in the required properties
+		 * once, so that values can be fetched from many results without
+		 * looking up the name each time. Handles are returned by
+		 * ResultsBase::getPropertyHandle and are immutable.
+		 *
+		 * The index is checked against the name when the handle is used. If
+		 * the data set has been reloaded and the index no longer refers to the
+		 * same property, then the name is looked up again. A handle therefore
+		 * remains valid for the lifetime of the application.
+		 *
+		 * ## Usage Example
+		 * ```
+		 * using namespace FiftyoneDegrees::Common;
+		 * PropertyHandle isMobile = results->getPropertyHandle("IsMobile");
+		 *
+		 * // Use the handle for every subsequent results instance
+		 * Value<bool> value = results->getValueAsBool(isMobile);
+		 * ```
+		 */
+		class PropertyHandle {
+		public:
+			/**
+			 * @name Constructors
+			 * @{
+			 */
+
+			/**
+			 * Construct a new handle for the property name and the index
+			 * which it was resolved to.
+			 * @param name of the property
+			 * @param requiredPropertyIndex index of the property in the
+			 * required properties, or -1 if not available
+			 */
+			PropertyHandle(const string &name, int requiredPropertyIndex)
+				: name(name), requiredPropertyIndex(requiredPropertyIndex) {}
+
+			/**
+			 * @}
+			 * @name Getters
+			 * @{
+			 */
+
+			/**
+			 * Get the name of the property.
+			 * @return property name
+			 */
+			const string& getName() const { return name; }
+
+			/**
+			 * Get the index of the property in the required properties when
+			 * the handle was created.
+			 * @return 0 based index or -1 if the property was not available
+			 */
+			int getRequiredPropertyIndex() const {
+				return requiredPropertyIndex;
+			}
+
+			/**
+			 * @}
+			 */
+		private:
+			/** Name of the property */
+			const string name;
+
+			/** Index of the property in the required properties */
+			const int requiredPropertyIndex;
+		};
+	}
+}
+
+#endif
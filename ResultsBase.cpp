@@ -26,6 +26,19 @@
 
 using namespace FiftyoneDegrees::Common;
 
+// Returns a view of the stored string value in the item.
+static std::string_view getStringView(const Item &item) {
+	const StoredBinaryValue *value = (const StoredBinaryValue*)item.data.ptr;
+	return std::string_view(
+		&value->stringValue.value,
+		value->stringValue.size > 0 ? (size_t)value->stringValue.size - 1 : 0);
+}
+
+// Returns the first stored value in the list.
+static const StoredBinaryValue* getFirstStoredValue(const List *stored) {
+	return (const StoredBinaryValue*)stored->items[0].data.ptr;
+}
+
 ResultsBase::ResultsBase(
 	fiftyoneDegreesResultsBase *results,
 	shared_ptr<fiftyoneDegreesResourceManager> manager) {
@@ -72,6 +85,13 @@ string ResultsBase::getPropertyName(
 	return name;
 }
 
+PropertyHandle ResultsBase::getPropertyHandle(
+	const string &propertyName) {
+	return PropertyHandle(
+		propertyName,
+		getRequiredPropertyIndex(propertyName.c_str()));
+}
+
 FiftyoneDegrees::Common::Value<string> ResultsBase::getValueAsString(int requiredPropertyIndex) {
 	Value<string> result;
 	if (hasValuesInternal(requiredPropertyIndex) == false) {
@@ -82,6 +102,24 @@ FiftyoneDegrees::Common::Value<string> ResultsBase::getValueAsString(int require
 			getNoValueMessageInternal(reason));
 	}
 	else {
+		PropertyValueType storedValueType;
+		const List *stored = getStoredValuesInternal(
+			requiredPropertyIndex,
+			&storedValueType);
+		if (stored != nullptr &&
+			storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
+			if (stored->count != 0) {
+				string value;
+				for (uint32_t i = 0; i < stored->count; i++) {
+					if (i > 0) {
+						value.push_back('|');
+					}
+					value.append(getStringView(stored->items[i]));
+				}
+				result.setValue(value);
+			}
+			return result;
+		}
 		vector<string> values;
 		getValuesInternal(requiredPropertyIndex, values);
 		if (values.size() > 1) {
@@ -115,6 +153,10 @@ FiftyoneDegrees::Common::Value<string> ResultsBase::getValueAsString(const strin
 	return getValueAsString(propertyName->c_str());
 }
 
+FiftyoneDegrees::Common::Value<string> ResultsBase::getValueAsString(const PropertyHandle &property) {
+	return getValueAsString(getRequiredPropertyIndex(property));
+}
+
 FiftyoneDegrees::Common::Value<bool> ResultsBase::getValueAsBool(int requiredPropertyIndex) {
 	Value<bool> result;
 	if (hasValuesInternal(requiredPropertyIndex) == false) {
@@ -125,6 +167,29 @@ FiftyoneDegrees::Common::Value<bool> ResultsBase::getValueAsBool(int requiredPro
 			getNoValueMessageInternal(reason));
 	}
 	else {
+		PropertyValueType storedValueType;
+		const List *stored = getStoredValuesInternal(
+			requiredPropertyIndex,
+			&storedValueType);
+		if (stored != nullptr) {
+			if (stored->count > 1) {
+				result.setNoValueReason(
+					FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_TOO_MANY_VALUES,
+					nullptr);
+			}
+			else if (stored->count != 0) {
+				// Only the text "True" is true, so values which are not
+				// stored as strings are always false.
+				result.setValue(
+					storedValueType ==
+						FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING &&
+					StoredBinaryValueToBoolOrDefault(
+						getFirstStoredValue(stored),
+						storedValueType,
+						false));
+			}
+			return result;
+		}
 		vector<string> values;
 		getValuesInternal(requiredPropertyIndex, values);
 		if (values.size() > 1) {
@@ -151,6 +216,10 @@ FiftyoneDegrees::Common::Value<bool> ResultsBase::getValueAsBool(const string *p
 	return getValueAsBool(propertyName->c_str());
 }
 
+FiftyoneDegrees::Common::Value<bool> ResultsBase::getValueAsBool(const PropertyHandle &property) {
+	return getValueAsBool(getRequiredPropertyIndex(property));
+}
+
 FiftyoneDegrees::Common::Value<int> ResultsBase::getValueAsInteger(int requiredPropertyIndex) {
 	Value<int> result;
 	if (hasValuesInternal(requiredPropertyIndex) == false) {
@@ -161,6 +230,24 @@ FiftyoneDegrees::Common::Value<int> ResultsBase::getValueAsInteger(int requiredP
 			getNoValueMessageInternal(reason));
 	}
 	else {
+		PropertyValueType storedValueType;
+		const List *stored = getStoredValuesInternal(
+			requiredPropertyIndex,
+			&storedValueType);
+		if (stored != nullptr) {
+			if (stored->count > 1) {
+				result.setNoValueReason(
+					FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_TOO_MANY_VALUES,
+					nullptr);
+			}
+			else if (stored->count != 0) {
+				result.setValue(StoredBinaryValueToIntOrDefault(
+					getFirstStoredValue(stored),
+					storedValueType,
+					0));
+			}
+			return result;
+		}
 		vector<string> values;
 		getValuesInternal(requiredPropertyIndex, values);
 		if (values.size() > 1) {
@@ -187,6 +274,10 @@ FiftyoneDegrees::Common::Value<int> ResultsBase::getValueAsInteger(const string
 	return getValueAsInteger(propertyName->c_str());
 }
 
+FiftyoneDegrees::Common::Value<int> ResultsBase::getValueAsInteger(const PropertyHandle &property) {
+	return getValueAsInteger(getRequiredPropertyIndex(property));
+}
+
 FiftyoneDegrees::Common::Value<double> ResultsBase::getValueAsDouble(int requiredPropertyIndex) {
 	Value<double> result;
 	if (hasValuesInternal(requiredPropertyIndex) == false) {
@@ -197,6 +288,24 @@ FiftyoneDegrees::Common::Value<double> ResultsBase::getValueAsDouble(int require
 			getNoValueMessageInternal(reason));
 	}
 	else {
+		PropertyValueType storedValueType;
+		const List *stored = getStoredValuesInternal(
+			requiredPropertyIndex,
+			&storedValueType);
+		if (stored != nullptr) {
+			if (stored->count > 1) {
+				result.setNoValueReason(
+					FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_TOO_MANY_VALUES,
+					nullptr);
+			}
+			else if (stored->count != 0) {
+				result.setValue(StoredBinaryValueToDoubleOrDefault(
+					getFirstStoredValue(stored),
+					storedValueType,
+					0));
+			}
+			return result;
+		}
 		vector<string> values;
 		getValuesInternal(requiredPropertyIndex, values);
 		if (values.size() > 1) {
@@ -223,6 +332,112 @@ FiftyoneDegrees::Common::Value<double> ResultsBase::getValueAsDouble(const strin
 	return getValueAsDouble(propertyName->c_str());
 }
 
+FiftyoneDegrees::Common::Value<double> ResultsBase::getValueAsDouble(const PropertyHandle &property) {
+	return getValueAsDouble(getRequiredPropertyIndex(property));
+}
+
+FiftyoneDegrees::Common::Value<std::string_view> ResultsBase::getValueAsStringView(
+	int requiredPropertyIndex) {
+	Value<std::string_view> result;
+	if (hasValuesInternal(requiredPropertyIndex) == false) {
+		fiftyoneDegreesResultsNoValueReason reason =
+			getNoValueReasonInternal(requiredPropertyIndex);
+		result.setNoValueReason(
+			reason,
+			getNoValueMessageInternal(reason));
+	}
+	else {
+		PropertyValueType storedValueType;
+		const List *stored = getStoredValuesInternal(
+			requiredPropertyIndex,
+			&storedValueType);
+		if (stored == nullptr ||
+			storedValueType != FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
+			result.setNoValueReason(
+				FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_UNKNOWN,
+				getNoValueMessageInternal(
+					FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_UNKNOWN));
+		}
+		else if (stored->count > 1) {
+			result.setNoValueReason(
+				FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_TOO_MANY_VALUES,
+				nullptr);
+		}
+		else if (stored->count != 0) {
+			result.setValue(getStringView(stored->items[0]));
+		}
+	}
+	return result;
+}
+
+FiftyoneDegrees::Common::Value<std::string_view> ResultsBase::getValueAsStringView(
+	const PropertyHandle &property) {
+	return getValueAsStringView(getRequiredPropertyIndex(property));
+}
+
+size_t ResultsBase::getValueViews(
+	int requiredPropertyIndex,
+	std::string_view *views,
+	size_t capacity) {
+	PropertyValueType storedValueType;
+	const List *stored;
+	if (hasValuesInternal(requiredPropertyIndex) == false) {
+		return 0;
+	}
+	stored = getStoredValuesInternal(requiredPropertyIndex, &storedValueType);
+	if (stored == nullptr ||
+		storedValueType != FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
+		return 0;
+	}
+	for (uint32_t i = 0; i < stored->count && i < capacity; i++) {
+		views[i] = getStringView(stored->items[i]);
+	}
+	return stored->count;
+}
+
+void ResultsBase::addToColumns(fiftyoneDegreesColumns *columns) {
+	PropertyValueType storedValueType;
+	const List *stored;
+	vector<string> values;
+	string text;
+	EXCEPTION_CREATE;
+	ColumnsRowStart(columns, exception);
+	EXCEPTION_THROW;
+	for (int i = 0; i < (int)available->count; i++) {
+		if (hasValuesInternal(i) == false) {
+			continue;
+		}
+		stored = getStoredValuesInternal(i, &storedValueType);
+		if (stored != nullptr) {
+			ColumnsAddValues(
+				columns,
+				(uint32_t)i,
+				storedValueType,
+				stored,
+				exception);
+		}
+		else {
+			values.clear();
+			text.clear();
+			getValuesInternal(i, values);
+			for (size_t j = 0; j < values.size(); j++) {
+				if (j > 0) {
+					text.push_back('|');
+				}
+				text.append(values[j]);
+			}
+			ColumnsAddText(
+				columns,
+				(uint32_t)i,
+				text.c_str(),
+				text.size(),
+				exception);
+		}
+		EXCEPTION_THROW;
+	}
+	ColumnsRowEnd(columns);
+}
+
 FiftyoneDegrees::Common::Value<vector<string>> ResultsBase::getValues(
 	int requiredPropertyIndex) {
 	Value<vector<string>> result;
@@ -256,9 +471,42 @@ FiftyoneDegrees::Common::Value<vector<string>> ResultsBase::getValues(
 	return getValues(propertyName->c_str());
 }
 
+FiftyoneDegrees::Common::Value<vector<string>> ResultsBase::getValues(
+	const PropertyHandle &property) {
+	return getValues(getRequiredPropertyIndex(property));
+}
+
+#ifdef _MSC_VER
+#pragma warning (disable: 4100)
+#endif
+const fiftyoneDegreesList* ResultsBase::getStoredValuesInternal(
+	int requiredPropertyIndex,
+	fiftyoneDegreesPropertyValueType *storedValueType) {
+	return nullptr;
+}
+#ifdef _MSC_VER
+#pragma warning (default: 4100)
+#endif
+
 int ResultsBase::getRequiredPropertyIndex(
 	const char *propertyName) {
 	return PropertiesGetRequiredPropertyIndexFromName(
 		available,
 		propertyName);
 }
+
+int ResultsBase::getRequiredPropertyIndex(
+	const PropertyHandle &property) {
+	int index = property.getRequiredPropertyIndex();
+	const char *name;
+	if (index >= 0 && index < (int)available->count) {
+		name = STRING(PropertiesGetNameFromRequiredIndex( // name is string
+			available,
+			index));
+		if (name != nullptr &&
+			StringCompare(name, property.getName().c_str()) == 0) {
+			return index;
+		}
+	}
+	return getRequiredPropertyIndex(property.getName().c_str());
+}
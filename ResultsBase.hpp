@@ -27,10 +27,15 @@
 #include <vector>
 #include <memory>
 #include <sstream>
+#include <string_view>
 #include "Exceptions.hpp"
 #include "Value.hpp"
+#include "PropertyHandle.hpp"
 #include "RequiredPropertiesConfig.hpp"
 #include "results.h"
+#include "list.h"
+#include "columns.h"
+#include "propertyValueType.h"
 #include "resource.h"
 
 using std::shared_ptr;
@@ -147,6 +152,16 @@ namespace FiftyoneDegrees {
 			 */
 			string getPropertyName(int requiredPropertyIndex) const;
 
+			/**
+			 * Get a handle for the property name which can be passed to the
+			 * value getters of this and any other results instance from the
+			 * same engine. The name is looked up once when the handle is
+			 * created rather than every time a value is fetched.
+			 * @param propertyName name of the property
+			 * @return handle for the property
+			 */
+			PropertyHandle getPropertyHandle(const string &propertyName);
+
 			/**
 			 * @}
 			 * @name Value Getters
@@ -183,6 +198,15 @@ namespace FiftyoneDegrees {
 			 */
 			Value<vector<string>> getValues(const string *propertyName);
 
+			/**
+			 * Get a vector with all values associated with the property
+			 * handle. If the property is not valid an empty vector is
+			 * returned.
+			 * @param property handle from #getPropertyHandle
+			 * @return a vector of values for the property
+			 */
+			Value<vector<string>> getValues(const PropertyHandle &property);
+
 			/**
 			 * Get a vector with all values associated with the required
 			 * property index. If the index is not valid an empty vector is
@@ -222,6 +246,14 @@ namespace FiftyoneDegrees {
 			 */
 			Value<string> getValueAsString(const string *propertyName);
 
+			/**
+			 * Get a string representation of the value associated with the
+			 * property handle.
+			 * @param property handle from #getPropertyHandle
+			 * @return a string representation of the value for the property
+			 */
+			Value<string> getValueAsString(const PropertyHandle &property);
+
 			/**
 			 * Get a string representation of the value associated with the
 			 * required property index. If the index is not valid an empty
@@ -260,6 +292,14 @@ namespace FiftyoneDegrees {
 			 */
 			Value<bool> getValueAsBool(const string *propertyName);
 
+			/**
+			 * Get a boolean representation of the value associated with the
+			 * property handle.
+			 * @param property handle from #getPropertyHandle
+			 * @return a boolean representation of the value for the property
+			 */
+			Value<bool> getValueAsBool(const PropertyHandle &property);
+
 			/**
 			 * Get a boolean representation of the value associated with the
 			 * required property index. If the property index is not valid then
@@ -299,6 +339,14 @@ namespace FiftyoneDegrees {
 			 */
 			Value<int> getValueAsInteger(const string *propertyName);
 
+			/**
+			 * Get an integer representation of the value associated with the
+			 * property handle.
+			 * @param property handle from #getPropertyHandle
+			 * @return an integer representation of the value for the property
+			 */
+			Value<int> getValueAsInteger(const PropertyHandle &property);
+
 			/**
 			 * Get an integer representation of the value associated with the
 			 * required property index. If the property index is not valid then
@@ -339,6 +387,14 @@ namespace FiftyoneDegrees {
 			 */
 			Value<double> getValueAsDouble(const string *propertyName);
 
+			/**
+			 * Get a double representation of the value associated with the
+			 * property handle.
+			 * @param property handle from #getPropertyHandle
+			 * @return a double representation of the value for the property
+			 */
+			Value<double> getValueAsDouble(const PropertyHandle &property);
+
 			/**
 			 * Get a double representation of the value associated with the
 			 * required property index. If the property index is not valid then
@@ -349,6 +405,70 @@ namespace FiftyoneDegrees {
 			 */
 			virtual Value<double> getValueAsDouble(int requiredPropertyIndex);
 
+			/**
+			 * @}
+			 * @name Value Views
+			 * @{
+			 */
+
+			/**
+			 * Get a view of the value associated with the required property
+			 * index without copying it. The view points to memory held by
+			 * the results, so is only valid until the results are freed.
+			 * Views are only available for values stored as strings by an
+			 * engine which provides its stored values. If a view is not
+			 * available then the value should be fetched with
+			 * #getValueAsString.
+			 * @param requiredPropertyIndex in the required properties
+			 * @return a view of the value for the property
+			 */
+			Value<std::string_view> getValueAsStringView(
+				int requiredPropertyIndex);
+
+			/**
+			 * Get a view of the value associated with the property handle
+			 * without copying it.
+			 * @param property handle from #getPropertyHandle
+			 * @return a view of the value for the property
+			 */
+			Value<std::string_view> getValueAsStringView(
+				const PropertyHandle &property);
+
+			/**
+			 * Populate the array with views of all the values associated with
+			 * the required property index without copying them or allocating
+			 * memory. The views are only valid until the results are freed.
+			 * @param requiredPropertyIndex in the required properties
+			 * @param views array to populate with the views
+			 * @param capacity number of views the array can hold
+			 * @return the number of values available as views which might be
+			 * more than the capacity, or 0 if there are no values or they
+			 * are not available as views
+			 */
+			size_t getValueViews(
+				int requiredPropertyIndex,
+				std::string_view *views,
+				size_t capacity);
+
+			/**
+			 * @}
+			 * @name Bulk Values
+			 * @{
+			 */
+
+			/**
+			 * Add the values of all the required properties as a new row in
+			 * the columns. The column for each property is its required
+			 * property index, and properties without values are empty.
+			 * Stored values are written directly, so no strings are
+			 * allocated for engines which provide them. The columns are
+			 * owned by the caller and can be used to collect the rows for
+			 * many results before being reset for the next batch.
+			 * @param columns initialized with #fiftyoneDegreesColumnsInit
+			 * with at least #getAvailableProperties columns
+			 */
+			void addToColumns(fiftyoneDegreesColumns *columns);
+
 			/**
 			 * @}
 			 */
@@ -364,6 +484,14 @@ namespace FiftyoneDegrees {
 			 */
 			int getRequiredPropertyIndex(const char *propertyName);
 
+			/**
+			 * Get the index in the available properties for the property
+			 * handle provided. The index in the handle is used if it still
+			 * refers to the property name, otherwise the name is looked up.
+			 * @return 0 based index or -1 if not found
+			 */
+			int getRequiredPropertyIndex(const PropertyHandle &property);
+
 			/**
 			 * Get the values for the index in required properties and add them
 			 * to the values vector supplied. This is implemented by extending
@@ -409,6 +537,21 @@ namespace FiftyoneDegrees {
 			virtual fiftyoneDegreesResultsNoValueReason getNoValueReasonInternal(
 				int requiredPropertyIndex) = 0;
 
+			/**
+			 * Get the stored values for the index in required properties
+			 * without copying them. Engines which hold the values for the
+			 * results in a list override this so that the typed getters and
+			 * views read the stored values directly. The default returns
+			 * nullptr which causes getValuesInternal to be used instead.
+			 * Only called when the hasValuesInternal method returns true.
+			 * @param requiredPropertyIndex index in the available properties
+			 * @param storedValueType set to the type the values are stored as
+			 * @return list of stored values held by the results or nullptr
+			 */
+			virtual const fiftyoneDegreesList* getStoredValuesInternal(
+				int requiredPropertyIndex,
+				fiftyoneDegreesPropertyValueType *storedValueType);
+
 		private:
 			/** A shared pointer to the manager is passed around and referenced
 			by all instances that hold open a resource handle. This acts as a
@@ -41,6 +41,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include "memory.h"
 
 /**
@@ -64,11 +65,13 @@ typedef struct fiftyone_degrees_array_##t##_t { \
 #define FIFTYONE_DEGREES_ARRAY_SIZE(t, c) (sizeof(t##Array) + (sizeof(t) * (c)))
 
 /**
- * Initialises the array.
+ * Initialises the array. Any additional members are set to zero so that
+ * pointers added to the structure are NULL until they are set.
  */
 #define FIFTYONE_DEGREES_ARRAY_CREATE(t, i, c) \
 i = (t##Array*)fiftyoneDegreesMalloc(FIFTYONE_DEGREES_ARRAY_SIZE(t,c)); \
 if (i != NULL) { \
+memset(i, 0, sizeof(t##Array)); \
 i->items = c ? (t*)(i + 1) : NULL; \
 i->count = 0; \
 i->capacity = c; \
@@ -384,7 +384,8 @@ fiftyoneDegreesCacheNode* fiftyoneDegreesCacheGet(
 	fiftyoneDegreesException *exception) {
 	CacheNode *node;
 	int64_t keyHash = cache->hash(key);
-	CacheShard *shard = &cache->shards[abs((int)keyHash) % cache->concurrency];
+	CacheShard *shard = &cache->shards[
+		(uint32_t)keyHash % cache->concurrency];
 
 #ifndef FIFTYONE_DEGREES_NO_THREADING
 	FIFTYONE_DEGREES_MUTEX_LOCK(&shard->lock);
@@ -438,4 +439,16 @@ int64_t fiftyoneDegreesCacheHash32(const void *key) {
 
 int64_t fiftyoneDegreesCacheHash64(const void *key) {
 	return *(int64_t*)key;
+}
+
+int64_t fiftyoneDegreesCacheHash64Mixed(const void *key) {
+	// The 64 bit finaliser from MurmurHash3. Each step can be reversed so no
+	// two keys have the same hash, which the tree in each shard relies on.
+	uint64_t hash = *(const uint64_t*)key;
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	return (int64_t)hash;
 }
\ No newline at end of file
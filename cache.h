@@ -272,6 +272,17 @@ EXTERNAL int64_t fiftyoneDegreesCacheHash32(const void *key);
  */
 EXTERNAL int64_t fiftyoneDegreesCacheHash64(const void *key);
 
+/**
+ * Passed a pointer to a 64 bit / 8 byte data structure and returns a hash of
+ * the data for use in the cache. Used when cache keys are 64 bit integers
+ * whose low bits do not vary, for example because several values are packed
+ * into the key, so that the keys are still spread across the shards. Every
+ * key has a different hash.
+ * @param key to be used in the cache
+ * @return hash of the key as a 64 bit integer
+ */
+EXTERNAL int64_t fiftyoneDegreesCacheHash64Mixed(const void *key);
+
 /**
  * @}
  */
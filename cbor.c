@@ -0,0 +1,311 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "cbor.h"
+#include "fiftyone.h"
+#include <errno.h>
+#include <math.h>
+
+// CBOR major types shifted into the top three bits of the initial byte.
+#define MAJOR_UNSIGNED 0x00
+#define MAJOR_NEGATIVE 0x20
+#define MAJOR_BYTES 0x40
+#define MAJOR_TEXT 0x60
+#define MAJOR_ARRAY 0x80
+#define MAJOR_MAP 0xA0
+#define MAJOR_TAG 0xC0
+
+// Initial bytes for simple values, floats, and indefinite length items.
+#define FALSE_BYTE ((char)0xF4)
+#define TRUE_BYTE ((char)0xF5)
+#define NULL_BYTE ((char)0xF6)
+#define FLOAT_BYTE ((char)0xFA)
+#define DOUBLE_BYTE ((char)0xFB)
+#define INDEFINITE_ARRAY ((char)0x9F)
+#define INDEFINITE_MAP ((char)0xBF)
+#define BREAK_BYTE ((char)0xFF)
+
+// Tags for IP addresses from RFC 9164.
+#define TAG_IPV4 52
+#define TAG_IPV6 54
+
+// Adds the big endian bytes of the value.
+static void addBigEndian(
+	fiftyoneDegreesCbor* s,
+	char initial,
+	uint64_t value,
+	int bytes) {
+	char buffer[9];
+	buffer[0] = initial;
+	for (int i = bytes; i > 0; i--) {
+		buffer[i] = (char)(value & 0xFF);
+		value >>= 8;
+	}
+	StringBuilderAddChars(&s->builder, buffer, (size_t)bytes + 1);
+}
+
+// Adds the initial byte of a data item with the major type and argument
+// using the shortest encoding.
+static void addHead(fiftyoneDegreesCbor* s, int major, uint64_t argument) {
+	if (argument < 24) {
+		StringBuilderAddChar(&s->builder, (char)(major | (int)argument));
+	}
+	else if (argument <= UINT8_MAX) {
+		addBigEndian(s, (char)(major | 24), argument, 1);
+	}
+	else if (argument <= UINT16_MAX) {
+		addBigEndian(s, (char)(major | 25), argument, 2);
+	}
+	else if (argument <= UINT32_MAX) {
+		addBigEndian(s, (char)(major | 26), argument, 4);
+	}
+	else {
+		addBigEndian(s, (char)(major | 27), argument, 8);
+	}
+}
+
+static void addInteger(fiftyoneDegreesCbor* s, int64_t value) {
+	if (value >= 0) {
+		addHead(s, MAJOR_UNSIGNED, (uint64_t)value);
+	}
+	else {
+		addHead(s, MAJOR_NEGATIVE, (uint64_t)(-(value + 1)));
+	}
+}
+
+static void addFloat(fiftyoneDegreesCbor* s, float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	addBigEndian(s, FLOAT_BYTE, bits, 4);
+}
+
+static void addDouble(fiftyoneDegreesCbor* s, double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	addBigEndian(s, DOUBLE_BYTE, bits, 8);
+}
+
+static void addText(fiftyoneDegreesCbor* s, const char* value, size_t length) {
+	addHead(s, MAJOR_TEXT, length);
+	StringBuilderAddChars(&s->builder, value, length);
+}
+
+static void addBytes(fiftyoneDegreesCbor* s, const byte* value, size_t length) {
+	addHead(s, MAJOR_BYTES, length);
+	StringBuilderAddChars(&s->builder, (const char*)value, length);
+}
+
+// Adds the string as the type of the property if the whole string is a valid
+// value of the type. Returns false if the string was not added.
+static bool addTypedString(
+	fiftyoneDegreesCbor* s,
+	const char* value,
+	size_t length) {
+	char* end;
+	char buffer[32];
+	if (s->property == NULL || length == 0 || length >= sizeof(buffer)) {
+		return false;
+	}
+	switch (s->property->valueType) {
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_BOOLEAN:
+		if (length == 4 && StringCompareLength(value, "true", 4) == 0) {
+			StringBuilderAddChar(&s->builder, TRUE_BYTE);
+			return true;
+		}
+		if (length == 5 && StringCompareLength(value, "false", 5) == 0) {
+			StringBuilderAddChar(&s->builder, FALSE_BYTE);
+			return true;
+		}
+		return false;
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER: {
+		memcpy(buffer, value, length);
+		buffer[length] = '\0';
+		errno = 0;
+		long long integer = strtoll(buffer, &end, 10);
+		if (errno != 0 || end != buffer + length) {
+			return false;
+		}
+		addInteger(s, (int64_t)integer);
+		return true;
+	}
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DOUBLE: {
+		double number;
+		if (StringToDouble(value, length, &number) == false ||
+			isinf(number)) {
+			return false;
+		}
+		addDouble(s, number);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+// Adds the value in its native CBOR form.
+static void addValue(
+	fiftyoneDegreesCbor* s,
+	const StoredBinaryValue* value,
+	PropertyValueType storedValueType) {
+	Exception* exception = s->exception;
+	const VarLengthByteArray* bytes = &value->byteArrayValue;
+	switch (storedValueType) {
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING: {
+		size_t length = value->stringValue.size > 0 ?
+			(size_t)value->stringValue.size - 1 : 0;
+		if (addTypedString(s, &value->stringValue.value, length) == false) {
+			addText(s, &value->stringValue.value, length);
+		}
+		break;
+	}
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER:
+		addInteger(s, value->intValue);
+		break;
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_BYTE:
+		addInteger(s, value->byteValue);
+		break;
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT:
+		addFloat(s, (float)StoredBinaryValueToDoubleOrDefault(
+			value,
+			storedValueType,
+			0));
+		break;
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_AZIMUTH:
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DECLINATION:
+		addDouble(s, StoredBinaryValueToDoubleOrDefault(
+			value,
+			storedValueType,
+			0));
+		break;
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_IP_ADDRESS:
+		if (bytes->size == FIFTYONE_DEGREES_IPV4_LENGTH) {
+			addHead(s, MAJOR_TAG, TAG_IPV4);
+		}
+		else if (bytes->size == FIFTYONE_DEGREES_IPV6_LENGTH) {
+			addHead(s, MAJOR_TAG, TAG_IPV6);
+		}
+		else {
+			EXCEPTION_SET(INCORRECT_IP_ADDRESS_FORMAT);
+			return;
+		}
+		addBytes(s, &bytes->firstByte, (size_t)bytes->size);
+		break;
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB:
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB_R:
+		addBytes(s, &bytes->firstByte, (size_t)bytes->size);
+		break;
+	default:
+		EXCEPTION_SET(UNSUPPORTED_STORED_VALUE_TYPE);
+		break;
+	}
+}
+
+void fiftyoneDegreesCborDocumentStart(fiftyoneDegreesCbor* s) {
+	StringBuilderInit(&s->builder);
+	StringBuilderAddChar(&s->builder, INDEFINITE_MAP);
+}
+
+void fiftyoneDegreesCborDocumentEnd(fiftyoneDegreesCbor* s) {
+	StringBuilderAddChar(&s->builder, BREAK_BYTE);
+	StringBuilderFlush(&s->builder);
+}
+
+void fiftyoneDegreesCborPropertyStart(fiftyoneDegreesCbor* s) {
+	const StoredBinaryValue* name;
+	Item stringItem;
+	Exception* exception = s->exception;
+
+	// Check that the property is populated.
+	if (s->property == NULL) {
+		EXCEPTION_SET(NULL_POINTER);
+		return;
+	}
+
+	// Get the property name as a string.
+	DataReset(&stringItem.data);
+	name = StoredBinaryValueGet(
+		s->strings,
+		s->property->nameOffset,
+		FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING, // name is string
+		&stringItem,
+		exception);
+	if (name != NULL && EXCEPTION_OKAY) {
+		addText(
+			s,
+			&name->stringValue.value,
+			name->stringValue.size > 0 ?
+				(size_t)name->stringValue.size - 1 : 0);
+		if (s->property->isList) {
+			StringBuilderAddChar(&s->builder, INDEFINITE_ARRAY);
+		}
+		COLLECTION_RELEASE(s->strings, &stringItem);
+	}
+}
+
+void fiftyoneDegreesCborPropertyEnd(fiftyoneDegreesCbor* s) {
+	if (s->property == NULL) {
+		Exception* exception = s->exception;
+		EXCEPTION_SET(NULL_POINTER);
+		return;
+	}
+	if (s->property->isList) {
+		StringBuilderAddChar(&s->builder, BREAK_BYTE);
+	}
+}
+
+void fiftyoneDegreesCborPropertyValues(fiftyoneDegreesCbor* s) {
+	const StoredBinaryValue* value;
+	Exception* exception = s->exception;
+
+	// Check that the values is populated.
+	if (s->values == NULL) {
+		EXCEPTION_SET(NULL_POINTER);
+		return;
+	}
+
+	// A property which isn't a list is followed by exactly one data item in
+	// the map, otherwise the keys and values after it would be out of step.
+	// If there is no value this is null, and if there are several they are
+	// written as an array.
+	if (s->property != NULL && s->property->isList == false) {
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < s->values->count; i++) {
+			if (s->values->items[i].data.ptr != NULL) {
+				count++;
+			}
+		}
+		if (count == 0) {
+			StringBuilderAddChar(&s->builder, NULL_BYTE);
+			return;
+		}
+		if (count > 1) {
+			addHead(s, MAJOR_ARRAY, count);
+		}
+	}
+
+	for (uint32_t i = 0; i < s->values->count && EXCEPTION_OKAY; i++) {
+		value = (const StoredBinaryValue*)s->values->items[i].data.ptr;
+		if (value != NULL) {
+			addValue(s, value, s->storedPropertyType);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_CBOR_H_INCLUDED
+#define FIFTYONE_DEGREES_CBOR_H_INCLUDED
+
+ /**
+  * @ingroup FiftyOneDegreesCommon
+  * @defgroup FiftyOneDegreesCbor CBOR
+  *
+  * CBOR methods
+  *
+  * ## Introduction
+  *
+  * Contains methods to create compact binary documents in the Concise Binary
+  * Object Representation (CBOR, RFC 8949) with the same structure as the
+  * documents created by the JSON methods. The document is a map of property
+  * names to either a single value or, for list properties, an array of
+  * values.
+  *
+  * ## Values
+  *
+  * Values are written in their native form rather than formatted as text.
+  * Integers and single bytes are CBOR integers, single precision floats are
+  * CBOR single precision floats, and coordinates such as azimuth and
+  * declination are CBOR double precision floats. IP addresses are byte
+  * strings tagged as IPv4 (52) or IPv6 (54) addresses as described in
+  * RFC 9164, and well known binary geometries are untagged byte strings.
+  * Values stored as strings for boolean properties are CBOR booleans, and
+  * those for integer or double properties are CBOR numbers when the whole
+  * string is a valid number. All other values are CBOR text strings.
+  *
+  * A property which is not a list always has one data item after its name.
+  * This is null if the property has no values, and a definite length array
+  * if it has more than one value.
+  *
+  * ## Output
+  *
+  * The output is written to a #fiftyoneDegreesStringBuilder in the same way
+  * as JSON. The builder can use a sink to stream the output in chunks. The
+  * map and arrays are indefinite length so that the number of properties or
+  * values does not need to be known before writing starts. A null terminator
+  * is not added to the output so the length is the added member of the
+  * builder.
+  *
+  * @{
+  */
+
+#include <stdint.h>
+#include "property.h"
+#include "stringBuilder.h"
+#include "list.h"
+#include "collection.h"
+#include "common.h"
+#include "exceptions.h"
+
+/**
+ * Structure used to populate a CBOR document for all required properties and
+ * values. The members are the same as #fiftyoneDegreesJson.
+ */
+typedef struct fiftyone_degrees_cbor_t {
+	fiftyoneDegreesStringBuilder builder; /**< Output buffer */
+	fiftyoneDegreesCollection* strings; /**< Collection of strings */
+	fiftyoneDegreesProperty* property; /**< The property being added */
+	fiftyoneDegreesList* values; /**< The values for the property */
+	fiftyoneDegreesException* exception; /**< Exception */
+	fiftyoneDegreesPropertyValueType storedPropertyType; /**< Stored type of
+														 the values for the
+														 property */
+} fiftyoneDegreesCbor;
+
+/**
+ * Writes the start of the CBOR document to the buffer in cbor.
+ * @param cbor data structure
+ */
+EXTERNAL void fiftyoneDegreesCborDocumentStart(fiftyoneDegreesCbor* cbor);
+
+/**
+ * Writes the end of the CBOR document to the buffer in cbor and passes any
+ * remaining output to the sink if the builder has one.
+ * @param cbor data structure
+ */
+EXTERNAL void fiftyoneDegreesCborDocumentEnd(fiftyoneDegreesCbor* cbor);
+
+/**
+ * Writes the name of the property in cbor->property, and the start of the
+ * array for list properties, to the buffer in cbor.
+ * @param cbor data structure
+ */
+EXTERNAL void fiftyoneDegreesCborPropertyStart(fiftyoneDegreesCbor* cbor);
+
+/**
+ * Writes the end of the property in cbor->property to the buffer in cbor.
+ * @param cbor data structure
+ */
+EXTERNAL void fiftyoneDegreesCborPropertyEnd(fiftyoneDegreesCbor* cbor);
+
+/**
+ * Writes the values in the cbor->values list to the buffer in cbor. Unlike
+ * JSON no separator is needed between properties or values. If the property
+ * in cbor->property is not a list then null is written when there are no
+ * values, and an array when there is more than one.
+ * @param cbor data structure
+ */
+EXTERNAL void fiftyoneDegreesCborPropertyValues(fiftyoneDegreesCbor* cbor);
+
+/**
+ * @}
+ */
+
+#endif
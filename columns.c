@@ -0,0 +1,309 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+
+#include "columns.h"
+#include "fiftyone.h"
+#include <math.h>
+
+// Separator between the values of list properties.
+#define SEPARATOR '|'
+
+// Returns the number if the whole string is a valid decimal number, otherwise
+// NaN. The decimal separator is always '.' whatever the C locale.
+static double parseNumber(const char *text, size_t length) {
+	double number;
+	if (StringToDouble(text, length, &number) == false) {
+		return NAN;
+	}
+	return number;
+}
+
+// Returns the value as a number, or NaN if it is not numeric.
+static double getNumber(
+	const StoredBinaryValue *value,
+	PropertyValueType storedValueType) {
+	switch (storedValueType) {
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING:
+		return parseNumber(
+			&value->stringValue.value,
+			value->stringValue.size > 0 ?
+				(size_t)value->stringValue.size - 1 : 0);
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER:
+		return (double)value->intValue;
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_BYTE:
+		return (double)value->byteValue;
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT:
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_AZIMUTH:
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DECLINATION:
+		return StoredBinaryValueToDoubleOrDefault(value, storedValueType, 0);
+	default:
+		return NAN;
+	}
+}
+
+// Replaces the offsets and numbers with memory for the number of rows
+// provided, copying the cells already written.
+static void setRowCapacity(
+	Columns *columns,
+	uint32_t rowCapacity,
+	Exception *exception) {
+	uint32_t *offsets;
+	double *numbers;
+	const size_t cells = (size_t)rowCapacity * columns->columnCount;
+	if (cells >= UINT32_MAX) {
+		EXCEPTION_SET(INSUFFICIENT_CAPACITY);
+		return;
+	}
+	offsets = (uint32_t*)Malloc(sizeof(uint32_t) * (cells + 1));
+	numbers = (double*)Malloc(sizeof(double) * (cells > 0 ? cells : 1));
+	if (offsets == NULL || numbers == NULL) {
+		if (offsets != NULL) {
+			Free(offsets);
+		}
+		if (numbers != NULL) {
+			Free(numbers);
+		}
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return;
+	}
+	if (columns->offsets != NULL) {
+		memcpy(
+			offsets,
+			columns->offsets,
+			sizeof(uint32_t) * ((size_t)columns->next + 1));
+		Free(columns->offsets);
+	}
+	else {
+		offsets[0] = 0;
+	}
+	if (columns->numbers != NULL) {
+		memcpy(numbers, columns->numbers, sizeof(double) * columns->next);
+		Free(columns->numbers);
+	}
+	columns->offsets = offsets;
+	columns->numbers = numbers;
+	columns->rowCapacity = rowCapacity;
+}
+
+// Sets the cells from the next cell up to, but not including, the cell
+// provided to empty.
+static void skipTo(Columns *columns, uint32_t cell) {
+	const uint32_t offset = columns->offsets[columns->next];
+	while (columns->next < cell) {
+		columns->numbers[columns->next] = NAN;
+		columns->next++;
+		columns->offsets[columns->next] = offset;
+	}
+}
+
+// Removes any characters added to the blob after the end of the last cell.
+static void rollBack(Columns *columns) {
+	StringBuilderTruncate(&columns->blob, columns->offsets[columns->next]);
+}
+
+// Returns the index of the cell for the column in the current row after
+// setting any cells skipped to empty.
+static uint32_t startCell(
+	Columns *columns,
+	uint32_t column,
+	Exception *exception) {
+	uint32_t cell;
+	if (columns->rowCount >= columns->rowCapacity) {
+		EXCEPTION_SET(INSUFFICIENT_CAPACITY);
+		return 0;
+	}
+	cell = columns->rowCount * columns->columnCount + column;
+	if (column >= columns->columnCount || cell < columns->next) {
+		EXCEPTION_SET(INVALID_INPUT);
+		return 0;
+	}
+	skipTo(columns, cell);
+	return cell;
+}
+
+// Records the end of the cell's text in the blob and its number.
+static void endCell(
+	Columns *columns,
+	uint32_t cell,
+	double number,
+	Exception *exception) {
+	if (columns->blob.full) {
+		rollBack(columns);
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return;
+	}
+	if (columns->blob.added > UINT32_MAX) {
+		rollBack(columns);
+		EXCEPTION_SET(INSUFFICIENT_CAPACITY);
+		return;
+	}
+	columns->numbers[cell] = number;
+	columns->offsets[cell + 1] = (uint32_t)columns->blob.added;
+	columns->next = cell + 1;
+}
+
+void fiftyoneDegreesColumnsInit(
+	fiftyoneDegreesColumns *columns,
+	uint32_t columnCount,
+	uint32_t rowCapacity,
+	fiftyoneDegreesException *exception) {
+	columns->columnCount = columnCount;
+	columns->rowCount = 0;
+	columns->rowCapacity = 0;
+	columns->next = 0;
+	columns->offsets = NULL;
+	columns->numbers = NULL;
+	columns->blob.ptr = NULL;
+	columns->blob.length = 0;
+	columns->blob.sink = NULL;
+	columns->blob.sinkState = NULL;
+	columns->blob.allocated = NULL;
+	StringBuilderInitGrowable(&columns->blob, NULL);
+	setRowCapacity(columns, rowCapacity > 0 ? rowCapacity : 1, exception);
+}
+
+void fiftyoneDegreesColumnsReset(fiftyoneDegreesColumns *columns) {
+	columns->rowCount = 0;
+	columns->next = 0;
+	StringBuilderInit(&columns->blob);
+}
+
+void fiftyoneDegreesColumnsRowStart(
+	fiftyoneDegreesColumns *columns,
+	fiftyoneDegreesException *exception) {
+	if (columns->next > columns->rowCount * columns->columnCount) {
+		// Discard the cells of a row which was not completed.
+		columns->next = columns->rowCount * columns->columnCount;
+		rollBack(columns);
+	}
+	if (columns->rowCount >= columns->rowCapacity) {
+		if (columns->rowCapacity > UINT32_MAX / 2) {
+			EXCEPTION_SET(INSUFFICIENT_CAPACITY);
+			return;
+		}
+		setRowCapacity(columns, columns->rowCapacity * 2, exception);
+	}
+}
+
+void fiftyoneDegreesColumnsAddValues(
+	fiftyoneDegreesColumns *columns,
+	uint32_t column,
+	fiftyoneDegreesPropertyValueType storedValueType,
+	const fiftyoneDegreesList *values,
+	fiftyoneDegreesException *exception) {
+	const StoredBinaryValue *value;
+	double number = NAN;
+	const uint32_t cell = startCell(columns, column, exception);
+	if (EXCEPTION_FAILED) {
+		return;
+	}
+	for (uint32_t i = 0; i < values->count; i++) {
+		value = (const StoredBinaryValue*)values->items[i].data.ptr;
+		if (i > 0) {
+			StringBuilderAddChar(&columns->blob, SEPARATOR);
+		}
+		StringBuilderAddStringValue(
+			&columns->blob,
+			value,
+			storedValueType,
+			MAX_DOUBLE_DECIMAL_PLACES,
+			exception);
+		if (EXCEPTION_FAILED) {
+			rollBack(columns);
+			return;
+		}
+	}
+	if (values->count == 1) {
+		number = getNumber(
+			(const StoredBinaryValue*)values->items[0].data.ptr,
+			storedValueType);
+	}
+	endCell(columns, cell, number, exception);
+}
+
+void fiftyoneDegreesColumnsAddText(
+	fiftyoneDegreesColumns *columns,
+	uint32_t column,
+	const char *text,
+	size_t length,
+	fiftyoneDegreesException *exception) {
+	const uint32_t cell = startCell(columns, column, exception);
+	if (EXCEPTION_FAILED) {
+		return;
+	}
+	StringBuilderAddChars(&columns->blob, text, length);
+	endCell(
+		columns,
+		cell,
+		memchr(text, SEPARATOR, length) == NULL ?
+			parseNumber(text, length) : NAN,
+		exception);
+}
+
+void fiftyoneDegreesColumnsRowEnd(fiftyoneDegreesColumns *columns) {
+	if (columns->rowCount < columns->rowCapacity) {
+		skipTo(columns, (columns->rowCount + 1) * columns->columnCount);
+		columns->rowCount++;
+	}
+}
+
+const char* fiftyoneDegreesColumnsGetText(
+	const fiftyoneDegreesColumns *columns,
+	uint32_t row,
+	uint32_t column,
+	size_t *length) {
+	uint32_t cell;
+	if (row >= columns->rowCount || column >= columns->columnCount) {
+		*length = 0;
+		return NULL;
+	}
+	cell = row * columns->columnCount + column;
+	*length = columns->offsets[cell + 1] - columns->offsets[cell];
+	return columns->blob.ptr != NULL ?
+		columns->blob.ptr + columns->offsets[cell] : "";
+}
+
+double fiftyoneDegreesColumnsGetNumber(
+	const fiftyoneDegreesColumns *columns,
+	uint32_t row,
+	uint32_t column) {
+	if (row >= columns->rowCount || column >= columns->columnCount) {
+		return NAN;
+	}
+	return columns->numbers[row * columns->columnCount + column];
+}
+
+void fiftyoneDegreesColumnsFree(fiftyoneDegreesColumns *columns) {
+	if (columns->offsets != NULL) {
+		Free(columns->offsets);
+		columns->offsets = NULL;
+	}
+	if (columns->numbers != NULL) {
+		Free(columns->numbers);
+		columns->numbers = NULL;
+	}
+	StringBuilderFree(&columns->blob);
+	columns->rowCount = 0;
+	columns->rowCapacity = 0;
+	columns->next = 0;
+}
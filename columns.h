@@ -0,0 +1,221 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+
+#ifndef FIFTYONE_DEGREES_COLUMNS_H_INCLUDED
+#define FIFTYONE_DEGREES_COLUMNS_H_INCLUDED
+
+ /**
+  * @ingroup FiftyOneDegreesCommon
+  * @defgroup FiftyOneDegreesColumns Columns
+  *
+  * Columnar storage of the values of many results.
+  *
+  * ## Introduction
+  *
+  * Contains methods to write the values of all the required properties for
+  * one or more results into a single caller owned structure. Each result is a
+  * row and each required property is a column. The structure can be reused
+  * for any number of batches without allocating memory once it has grown to
+  * the size needed.
+  *
+  * ## Layout
+  *
+  * The cell for a row and column is at index row * columnCount + column. The
+  * text of every cell is stored in one contiguous blob, and the text of cell
+  * i is the bytes from offsets[i] up to offsets[i + 1]. There is one more
+  * offset than there are cells. The values of list properties are separated
+  * with the '|' character in the same way as the string values returned by
+  * results. The text is not null terminated.
+  *
+  * Numeric values are also stored in a typed column of doubles. A cell
+  * containing a single value which is stored as a number, or as a string that
+  * is a valid number in its entirety, has that number in the numbers member.
+  * All other cells contain NaN so that numeric columns can be processed
+  * without parsing the text.
+  *
+  * ## Usage
+  *
+  * ```
+  * fiftyoneDegreesColumns columns;
+  * fiftyoneDegreesColumnsInit(&columns, propertyCount, 100, exception);
+  * for (each result) {
+  *     fiftyoneDegreesColumnsRowStart(&columns, exception);
+  *     for (each required property with values) {
+  *         fiftyoneDegreesColumnsAddValues(
+  *             &columns,
+  *             requiredPropertyIndex,
+  *             storedValueType,
+  *             values,
+  *             exception);
+  *     }
+  *     fiftyoneDegreesColumnsRowEnd(&columns);
+  * }
+  * // Use the rows.
+  * fiftyoneDegreesColumnsReset(&columns);
+  * // Add the next batch of rows.
+  * fiftyoneDegreesColumnsFree(&columns);
+  * ```
+  *
+  * @{
+  */
+
+#include <stdint.h>
+#include "stringBuilder.h"
+#include "list.h"
+#include "common.h"
+#include "exceptions.h"
+#include "propertyValueType.h"
+
+/**
+ * Columnar values for a number of rows. All members are read only to the
+ * caller.
+ */
+typedef struct fiftyone_degrees_columns_t {
+	uint32_t columnCount; /**< Number of columns in each row */
+	uint32_t rowCount; /**< Number of rows completed */
+	uint32_t rowCapacity; /**< Number of rows that can be added before the
+						  offsets and numbers need to grow */
+	uint32_t next; /**< Index of the next cell to be written */
+	uint32_t *offsets; /**< Offsets of the text of each cell in the blob with
+					   one more entry than the number of cells */
+	double *numbers; /**< Numeric value of each cell, or NaN */
+	fiftyoneDegreesStringBuilder blob; /**< Growable builder containing the
+									   text of all the cells */
+} fiftyoneDegreesColumns;
+
+/**
+ * Initializes the columns and allocates memory for the number of rows
+ * provided. The columns must be freed with #fiftyoneDegreesColumnsFree.
+ * @param columns to initialize
+ * @param columnCount number of columns in each row, usually the number of
+ * required properties
+ * @param rowCapacity initial number of rows to allocate memory for
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ */
+EXTERNAL void fiftyoneDegreesColumnsInit(
+	fiftyoneDegreesColumns *columns,
+	uint32_t columnCount,
+	uint32_t rowCapacity,
+	fiftyoneDegreesException *exception);
+
+/**
+ * Removes all the rows without releasing memory so that the columns can be
+ * reused for the next batch.
+ * @param columns to reset
+ */
+EXTERNAL void fiftyoneDegreesColumnsReset(fiftyoneDegreesColumns *columns);
+
+/**
+ * Starts a new row, growing the memory used for offsets and numbers if the
+ * row capacity has been reached. The cells of any row which was started but
+ * not completed are discarded.
+ * @param columns to add the row to
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ */
+EXTERNAL void fiftyoneDegreesColumnsRowStart(
+	fiftyoneDegreesColumns *columns,
+	fiftyoneDegreesException *exception);
+
+/**
+ * Sets the cell for the column in the current row to the values provided.
+ * Columns must be added in ascending order. Any columns skipped are empty.
+ * @param columns to add the values to
+ * @param column index of the column, usually the required property index
+ * @param storedValueType type of the values in the list
+ * @param values list of stored values
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ */
+EXTERNAL void fiftyoneDegreesColumnsAddValues(
+	fiftyoneDegreesColumns *columns,
+	uint32_t column,
+	fiftyoneDegreesPropertyValueType storedValueType,
+	const fiftyoneDegreesList *values,
+	fiftyoneDegreesException *exception);
+
+/**
+ * Sets the cell for the column in the current row to the text provided. Used
+ * when the values are only available as text. Columns must be added in
+ * ascending order. Any columns skipped are empty.
+ * @param columns to add the text to
+ * @param column index of the column, usually the required property index
+ * @param text characters for the cell which do not need to be null
+ * terminated
+ * @param length number of characters
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ */
+EXTERNAL void fiftyoneDegreesColumnsAddText(
+	fiftyoneDegreesColumns *columns,
+	uint32_t column,
+	const char *text,
+	size_t length,
+	fiftyoneDegreesException *exception);
+
+/**
+ * Completes the current row. Any columns not added are empty.
+ * @param columns containing the row
+ */
+EXTERNAL void fiftyoneDegreesColumnsRowEnd(fiftyoneDegreesColumns *columns);
+
+/**
+ * Gets the text of a cell in a completed row.
+ * @param columns containing the cell
+ * @param row index of the row
+ * @param column index of the column
+ * @param length set to the number of characters in the text
+ * @return pointer to the text which is not null terminated, or NULL if the
+ * row or column is out of range
+ */
+EXTERNAL const char* fiftyoneDegreesColumnsGetText(
+	const fiftyoneDegreesColumns *columns,
+	uint32_t row,
+	uint32_t column,
+	size_t *length);
+
+/**
+ * Gets the numeric value of a cell in a completed row.
+ * @param columns containing the cell
+ * @param row index of the row
+ * @param column index of the column
+ * @return the number, or NaN if the cell is not numeric or the row or column
+ * is out of range
+ */
+EXTERNAL double fiftyoneDegreesColumnsGetNumber(
+	const fiftyoneDegreesColumns *columns,
+	uint32_t row,
+	uint32_t column);
+
+/**
+ * Releases the memory used by the columns.
+ * @param columns to free
+ */
+EXTERNAL void fiftyoneDegreesColumnsFree(fiftyoneDegreesColumns *columns);
+
+/**
+ * @}
+ */
+
+#endif
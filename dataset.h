@@ -131,6 +131,12 @@ typedef struct fiftyone_degrees_dataset_base_t {
 															   look up profile 
 															   values by 
 															   property */
+	fiftyoneDegreesIndicesPropertyValue* indexPropertyValue; /**< Index to look
+															 up values by name
+															 for each
+															 available
+															 property, or NULL
+															 if not created */
     const void *config; /**< Pointer to the config used to create the dataset */
 } fiftyoneDegreesDataSetBase;
 
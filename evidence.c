@@ -147,6 +147,64 @@ static EvidenceKeyValuePair* findHeaderEvidence(
 	return state.pair;
 }
 
+/**
+ * Resolves the pair to the header it relates to and records the pair against
+ * the header index if it is the first pair for the header. Always returns 
+ * true to continue iterating.
+ */
+static bool indexHeaderEvidenceCallback(
+	void* state,
+	EvidenceKeyValuePair* pair) {
+	EvidenceHeaderIndex* index = (EvidenceHeaderIndex*)state;
+	Header* header = pair->header;
+	int headerIndex;
+
+	// Use the header already set for the pair if it is from the same headers,
+	// otherwise use the hash of the header names. The length check ensures 
+	// that HTTP_ prefixed keys are treated in the same way as 
+	// findHeaderEvidence which requires the key to be the header name.
+	if (header == NULL ||
+		header->index >= index->headers->count ||
+		header != &index->headers->items[header->index]) {
+		headerIndex = HeaderGetIndex(
+			index->headers,
+			pair->item.key,
+			pair->item.keyLength);
+		if (headerIndex < 0 || 
+			index->headers->items[headerIndex].nameLength != 
+			pair->item.keyLength) {
+			return true;
+		}
+		header = &index->headers->items[headerIndex];
+		pair->header = header;
+	}
+
+	// Only the first pair for the header is used to match the behaviour of
+	// findHeaderEvidence.
+	if (header->index < index->count && index->pairs[header->index] == NULL) {
+		index->pairs[header->index] = pair;
+	}
+	return true;
+}
+
+/**
+ * Gets the evidence pair that matches the header using the index if 
+ * available, otherwise finds the pair in the evidence. Returns null if a pair
+ * does not exist.
+ */
+static EvidenceKeyValuePair* getHeaderEvidence(
+	EvidenceKeyValuePairArray* evidence,
+	int prefixes,
+	EvidenceHeaderIndex* index,
+	Header* header) {
+	if (index != NULL &&
+		header->index < index->count &&
+		header == &index->headers->items[header->index]) {
+		return index->pairs[header->index];
+	}
+	return findHeaderEvidence(evidence, prefixes, header);
+}
+
 // Safe-copies the pair parsed value to the buffer checking that there are
 // sufficient bytes remaining in the buffer for the parsed value.
 static void addPairValueToBuffer(
@@ -165,6 +223,7 @@ static void addPairValueToBuffer(
 static bool addHeaderValueToBuilder(
 	fiftyoneDegreesEvidenceKeyValuePairArray* evidence,
 	int prefixes,
+	fiftyoneDegreesEvidenceHeaderIndex* index,
 	fiftyoneDegreesHeader* header,
 	StringBuilder* builder,
     bool prependSeparator) {
@@ -172,9 +231,10 @@ static bool addHeaderValueToBuilder(
 	// Get the evidence that corresponds to the header. If it doesn't exist
 	// then there is no evidence for the header and a call back will not be
 	// possible.
-	EvidenceKeyValuePair* pair = findHeaderEvidence(
+	EvidenceKeyValuePair* pair = getHeaderEvidence(
 		evidence, 
 		prefixes, 
+		index,
 		header);
 	if (pair == NULL) {
 		return false;
@@ -200,6 +260,7 @@ static bool addHeaderValueToBuilder(
 static bool processPseudoHeader(
 	EvidenceKeyValuePairArray* evidence,
 	int prefixes,
+	EvidenceHeaderIndex* index,
 	Header* header,
 	StringBuilder* builder,
 	void* state,
@@ -217,6 +278,7 @@ static bool processPseudoHeader(
 		bool success = addHeaderValueToBuilder(
 			evidence, 
 			prefixes, 
+			index,
 			header->segmentHeaders->items[i], 
 			builder, 
 			prependSeparator);
@@ -251,6 +313,7 @@ static bool processPseudoHeader(
 static bool processHeader(
 	EvidenceKeyValuePairArray* evidence,
 	int prefixes,
+	EvidenceHeaderIndex* index,
 	Header* header,
 	void* state,
 	fiftyoneDegreesEvidenceIterateMethod callback) {
@@ -258,9 +321,10 @@ static bool processHeader(
 	// Get the evidence that corresponds to the header. If it doesn't exist
 	// then there is no evidence for the header and a call back will not be
 	// possible.
-	EvidenceKeyValuePair* pair = findHeaderEvidence(
+	EvidenceKeyValuePair* pair = getHeaderEvidence(
 		evidence,
 		prefixes,
+		index,
 		header);
 	if (pair == NULL) {
 		return true;
@@ -270,6 +334,155 @@ static bool processHeader(
 	return callback(state, pair);
 }
 
+// Returns true if the character is optional white space in an HTTP header.
+static bool isHeaderSpace(char c) {
+	return c == ' ' || c == '\t';
+}
+
+// Returns the end of the line that starts at current excluding any line 
+// ending characters. Sets next to the start of the following line.
+static const char* getLineEnd(
+	const char* current,
+	const char* end,
+	const char** next) {
+	const char* lineEnd = (const char*)memchr(
+		current, 
+		'\n', 
+		(size_t)(end - current));
+	if (lineEnd == NULL) {
+		*next = end;
+		lineEnd = end;
+	}
+	else {
+		*next = lineEnd + 1;
+	}
+	if (lineEnd > current && *(lineEnd - 1) == '\r') {
+		lineEnd--;
+	}
+	return lineEnd;
+}
+
+// Adds a pair to the evidence for the key and value which are not copied.
+static void addBlockPair(
+	EvidenceKeyValuePairArray* evidence,
+	EvidencePrefix prefix,
+	const char* key,
+	size_t keyLength,
+	const char* value,
+	size_t valueLength) {
+	KeyValuePair pair = { key, keyLength, value, valueLength };
+	EvidenceAddPair(evidence, prefix, pair);
+}
+
+// Adds the parameters in the query string of the request line target as 
+// query evidence. Returns the number of pairs added.
+static uint32_t addRequestLineQuery(
+	EvidenceKeyValuePairArray* evidence,
+	const char* current,
+	const char* end) {
+	uint32_t count = 0;
+	const char *target, *targetEnd, *param, *paramEnd, *equals;
+
+	// The target is between the first and second space of the request line.
+	target = (const char*)memchr(current, ' ', (size_t)(end - current));
+	if (target == NULL) {
+		return 0;
+	}
+	target++;
+	targetEnd = (const char*)memchr(target, ' ', (size_t)(end - target));
+	if (targetEnd == NULL) {
+		targetEnd = end;
+	}
+
+	// Find the start of the query string within the target.
+	param = (const char*)memchr(target, '?', (size_t)(targetEnd - target));
+	if (param == NULL) {
+		return 0;
+	}
+	param++;
+
+	// Add each of the parameters separated by & as a key and value.
+	while (param < targetEnd) {
+		paramEnd = (const char*)memchr(
+			param, 
+			'&', 
+			(size_t)(targetEnd - param));
+		if (paramEnd == NULL) {
+			paramEnd = targetEnd;
+		}
+		equals = (const char*)memchr(param, '=', (size_t)(paramEnd - param));
+		if (equals == NULL) {
+			equals = paramEnd;
+		}
+		if (equals > param) {
+			addBlockPair(
+				evidence,
+				FIFTYONE_DEGREES_EVIDENCE_QUERY,
+				param,
+				(size_t)(equals - param),
+				equals < paramEnd ? equals + 1 : paramEnd,
+				equals < paramEnd ? (size_t)(paramEnd - equals - 1) : 0);
+			count++;
+		}
+		param = paramEnd + 1;
+	}
+	return count;
+}
+
+// Iterates over the headers calling the callback for each header or pseudo
+// header with evidence. Uses the index if provided to find the evidence for
+// each header. Pseudo headers are assembled in the builder if provided.
+static bool iterateForHeaders(
+	EvidenceKeyValuePairArray* evidence,
+	int prefixes,
+	EvidenceHeaderIndex* index,
+	HeaderPtrs* headers,
+	StringBuilder* builder,
+	void* state,
+	EvidenceIterateMethod callback) {
+	Header* header;
+
+	// For each of the headers process as either a standard header, or a pseudo
+	// header.
+	for (uint32_t i = 0; i < headers->count; i++) {
+		header = headers->items[i];
+
+		// Try and process the header as a standard header.
+		if (processHeader(
+			evidence,
+			prefixes,
+			index,
+			header,
+			state,
+			callback) == false) {
+			return true;
+		}
+
+		// If the header is a pseudo header then attempt to assemble a complete
+		// value from the evidence and process it. Note: if there is only one
+		// segment then that will be the header that was already processed in 
+		// processHeader therefore there is no point processing the same value
+		// a second time as a pseudo header.
+		if (builder != NULL && 
+			header->segmentHeaders != NULL &&
+			header->segmentHeaders->count > 1) {
+			StringBuilderInit(builder);
+			if (processPseudoHeader(
+				evidence,
+				prefixes,
+				index,
+				header,
+				builder,
+				state,
+				callback) == false) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 fiftyoneDegreesEvidenceKeyValuePairArray*
 fiftyoneDegreesEvidenceCreate(uint32_t capacity) {
 	fiftyoneDegreesEvidenceKeyValuePairArray *evidence;
@@ -278,6 +491,7 @@ fiftyoneDegreesEvidenceCreate(uint32_t capacity) {
 	if (evidence != NULL) {
 		evidence->next = NULL;
 		evidence->prev = NULL;
+		evidence->allocated = true;
 		for (i = 0; i < evidence->capacity; i++) {
 			evidence->items[i].item.key = NULL;
 			evidence->items[i].item.keyLength = 0;
@@ -303,11 +517,50 @@ void fiftyoneDegreesEvidenceFree(
 	}
 	while (current != NULL) {
 		evidence = current->prev;
-		Free(current);
+		if (current->allocated) {
+			Free(current);
+		}
+		else {
+			current->next = NULL;
+		}
 		current = evidence;
 	}
 }
 
+size_t fiftyoneDegreesEvidenceSize(uint32_t capacity) {
+	return FIFTYONE_DEGREES_ARRAY_SIZE(EvidenceKeyValuePair, capacity);
+}
+
+fiftyoneDegreesEvidenceKeyValuePairArray* fiftyoneDegreesEvidenceInit(
+	void* memory,
+	size_t size) {
+	EvidenceKeyValuePairArray* evidence = 
+		(EvidenceKeyValuePairArray*)memory;
+	if (memory == NULL || size < sizeof(EvidenceKeyValuePairArray)) {
+		return NULL;
+	}
+	evidence->capacity = (uint32_t)(
+		(size - sizeof(EvidenceKeyValuePairArray)) / 
+		sizeof(EvidenceKeyValuePair));
+	evidence->items = evidence->capacity > 0 ? 
+		(EvidenceKeyValuePair*)(evidence + 1) : NULL;
+	evidence->count = 0;
+	evidence->next = NULL;
+	evidence->prev = NULL;
+	evidence->allocated = false;
+	return evidence;
+}
+
+void fiftyoneDegreesEvidenceReset(
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence) {
+	// Reset every array in the chain. An empty array does not mean the rest
+	// are empty as an array with no capacity is always empty.
+	while (evidence != NULL) {
+		evidence->count = 0;
+		evidence = evidence->next;
+	}
+}
+
 fiftyoneDegreesEvidenceKeyValuePair* fiftyoneDegreesEvidenceAddPair(
 	fiftyoneDegreesEvidenceKeyValuePairArray *evidence,
 	fiftyoneDegreesEvidencePrefix prefix,
@@ -398,44 +651,134 @@ bool fiftyoneDegreesEvidenceIterateForHeaders(
 	size_t const length,
 	void* state,
 	fiftyoneDegreesEvidenceIterateMethod callback) {
-	Header* header;
 	StringBuilder builder = { buffer, length };
+	return iterateForHeaders(
+		evidence,
+		prefixes,
+		NULL,
+		headers,
+		buffer != NULL ? &builder : NULL,
+		state,
+		callback);
+}
 
-	// For each of the headers process as either a standard header, or a pseudo
-	// header.
-	for (uint32_t i = 0; i < headers->count; i++) {
-		header = headers->items[i];
+bool fiftyoneDegreesEvidenceIterateForHeadersWithBuilder(
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence,
+	int prefixes,
+	fiftyoneDegreesEvidenceHeaderIndex* index,
+	fiftyoneDegreesHeaderPtrs* headers,
+	fiftyoneDegreesStringBuilder* builder,
+	void* state,
+	fiftyoneDegreesEvidenceIterateMethod callback) {
+	if (index != NULL) {
+		evidence = index->evidence;
+		prefixes = index->prefixes;
+	}
+	return iterateForHeaders(
+		evidence,
+		prefixes,
+		index,
+		headers,
+		builder,
+		state,
+		callback);
+}
 
-		// Try and process the header as a standard header.
-		if (processHeader(
-			evidence,
-			prefixes,
-			header,
-			state,
-			callback) == false) {
-			return true;
+uint32_t fiftyoneDegreesEvidenceHeaderIndexInit(
+	fiftyoneDegreesEvidenceHeaderIndex* index,
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence,
+	int prefixes,
+	fiftyoneDegreesHeaders* headers,
+	fiftyoneDegreesEvidenceKeyValuePair** pairs,
+	uint32_t count) {
+	uint32_t i;
+	index->evidence = evidence;
+	index->prefixes = prefixes;
+	index->headers = headers;
+	index->pairs = pairs;
+	index->count = count < headers->count ? count : headers->count;
+	for (i = 0; i < index->count; i++) {
+		index->pairs[i] = NULL;
+	}
+	return evidenceIterate(
+		evidence,
+		prefixes,
+		index,
+		indexHeaderEvidenceCallback);
+}
+
+bool fiftyoneDegreesEvidenceIterateForHeadersIndexed(
+	fiftyoneDegreesEvidenceHeaderIndex* index,
+	fiftyoneDegreesHeaderPtrs* headers,
+	char* const buffer,
+	size_t const length,
+	void* state,
+	fiftyoneDegreesEvidenceIterateMethod callback) {
+	StringBuilder builder = { buffer, length };
+	return iterateForHeaders(
+		index->evidence,
+		index->prefixes,
+		index,
+		headers,
+		buffer != NULL ? &builder : NULL,
+		state,
+		callback);
+}
+
+uint32_t fiftyoneDegreesEvidenceAddHeaderBlock(
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence,
+	const char* block,
+	size_t length,
+	bool addQuery) {
+	uint32_t count = 0;
+	const char *end = block + length, *current = block, *next, *lineEnd, 
+		*colon, *name, *value, *valueEnd;
+	bool firstLine = true;
+
+	while (current < end) {
+		lineEnd = getLineEnd(current, end, &next);
+
+		// An empty line marks the end of the header block.
+		if (lineEnd == current) {
+			break;
 		}
 
-		// If the header is a pseudo header then attempt to assemble a complete
-		// value from the evidence and process it. Note: if there is only one
-		// segment then that will be the header that was already processed in 
-		// processHeader therefore there is no point processing the same value
-		// a second time as a pseudo header.
-		if (buffer != NULL && 
-			header->segmentHeaders != NULL &&
-			header->segmentHeaders->count > 1) {
-			StringBuilderInit(&builder);
-			if (processPseudoHeader(
-				evidence,
-				prefixes,
-				header,
-				&builder,
-				state,
-				callback) == false) {
-				return true;
+		// Find the separator between the name and the value. A valid field
+		// name does not contain white space so a line without a separator, or
+		// one with white space before it, is either the request line or is 
+		// not a header.
+		name = current;
+		colon = name;
+		while (colon < lineEnd && *colon != ':' && 
+			isHeaderSpace(*colon) == false) {
+			colon++;
+		}
+		if (colon < lineEnd && *colon == ':' && colon > name) {
+
+			// Trim the optional white space around the value.
+			value = colon + 1;
+			valueEnd = lineEnd;
+			while (value < valueEnd && isHeaderSpace(*value)) {
+				value++;
+			}
+			while (valueEnd > value && isHeaderSpace(*(valueEnd - 1))) {
+				valueEnd--;
 			}
+			addBlockPair(
+				evidence,
+				FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING,
+				name,
+				(size_t)(colon - name),
+				value,
+				(size_t)(valueEnd - value));
+			count++;
+		}
+		else if (firstLine && addQuery) {
+			count += addRequestLineQuery(evidence, current, lineEnd);
 		}
-	}
 
-	return false;
+		firstLine = false;
+		current = next;
+	}
+	return count;
 }
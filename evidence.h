@@ -46,6 +46,14 @@
  * method. This takes the maximum number of evidence items which the structure
  * can store.
  *
+ * Where evidence is processed repeatedly, for example by a worker thread,
+ * #fiftyoneDegreesEvidenceReset removes all the items whilst retaining the
+ * memory so that the same structure can be used for the next request without
+ * allocating memory. #fiftyoneDegreesEvidenceInit creates the structure in
+ * memory provided by the caller, such as an arena or the stack, where
+ * #fiftyoneDegreesEvidenceSize returns the number of bytes needed for the
+ * capacity required.
+ *
  * ## Prefixes
  *
  * Evidence keys contain a prefix and the key within that prefix. For example,
@@ -69,6 +77,11 @@
  * #fiftyoneDegreesEvidenceAddString method. This then parses the string value
  * it is provided into the correct type which is determined by the prefix.
  *
+ * Where the raw HTTP/1.x header block of a request is available the
+ * #fiftyoneDegreesEvidenceAddHeaderBlock method adds every header, and 
+ * optionally the query string parameters from the request line, without 
+ * copying the block.
+ *
  * ## Iterate
  *
  * The evidence a particular evidence structure can be iterated over using the
@@ -77,6 +90,16 @@
  * called for each evidence item which matches the filter. The number of
  * matching items is then returned.
  *
+ * ## Header Index
+ *
+ * When the same evidence is examined for many headers and pseudo headers
+ * #fiftyoneDegreesEvidenceHeaderIndexInit resolves every evidence pair to
+ * the header it relates to in a single pass. The resulting index relates the
+ * header index to the evidence pair so that
+ * #fiftyoneDegreesEvidenceIterateForHeadersIndexed does not need to search
+ * the evidence for each header, or each segment of a pseudo header. The
+ * memory for the index is provided by the caller.
+ *
  * ## Free
  *
  * An evidence structure is freed using the #fiftyoneDegreesEvidenceFree
@@ -180,7 +203,9 @@ typedef struct fiftyone_degrees_array_fiftyoneDegreesEvidenceKeyValuePair_t
  */
 #define FIFTYONE_DEGREES_ARRAY_EVIDENCE_MEMBER \
 	fiftyoneDegreesEvidenceKeyValuePairArray *next; \
-	fiftyoneDegreesEvidenceKeyValuePairArray *prev;
+	fiftyoneDegreesEvidenceKeyValuePairArray *prev; \
+	bool allocated; /**< True if the array was allocated by 
+					#fiftyoneDegreesEvidenceCreate and must be freed */
 
 /**
  * Array of evidence key value pairs and a pointer to the next array if present
@@ -210,12 +235,47 @@ EXTERNAL fiftyoneDegreesEvidenceKeyValuePairArray*
 
 /**
  * Frees the memory used by an evidence array and any other arrays pointed to
- * by the instance passed via the next member.
+ * by the instance passed via the next member. Arrays initialised in caller
+ * provided memory with #fiftyoneDegreesEvidenceInit are not freed.
  * @param evidence pointer to the array to be freed
  */
 EXTERNAL void fiftyoneDegreesEvidenceFree(
 	fiftyoneDegreesEvidenceKeyValuePairArray *evidence);
 
+/**
+ * Returns the number of bytes needed to initialise an evidence array with 
+ * the capacity requested using #fiftyoneDegreesEvidenceInit.
+ * @param capacity maximum number of evidence items
+ * @return number of bytes needed
+ */
+EXTERNAL size_t fiftyoneDegreesEvidenceSize(uint32_t capacity);
+
+/**
+ * Initialises an evidence array in memory provided by the caller. The 
+ * capacity of the array is the number of items that fit in the memory after
+ * the array structure. The memory must be suitably aligned for the evidence
+ * array, remain valid for the lifetime of the evidence, and is not freed by
+ * #fiftyoneDegreesEvidenceFree. If more items are added than the capacity 
+ * then further arrays are allocated which #fiftyoneDegreesEvidenceFree must
+ * be used to free.
+ * @param memory to initialise the evidence array in
+ * @param size of the memory in bytes
+ * @return pointer to the evidence array, or NULL if the memory is too small
+ */
+EXTERNAL fiftyoneDegreesEvidenceKeyValuePairArray* fiftyoneDegreesEvidenceInit(
+	void* memory,
+	size_t size);
+
+/**
+ * Removes all the evidence items so that the evidence array can be used 
+ * again. The memory used by the array, and any further arrays pointed to via
+ * the next member, is retained so that no memory is allocated when the 
+ * evidence is next added unless more items are added than before.
+ * @param evidence pointer to the array to reset
+ */
+EXTERNAL void fiftyoneDegreesEvidenceReset(
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence);
+
 /**
  * Adds a new entry to the evidence. The memory associated with the 
  * field and original value parameters must not be freed until after the 
@@ -252,6 +312,30 @@ EXTERNAL fiftyoneDegreesEvidenceKeyValuePair* fiftyoneDegreesEvidenceAddPair(
 	fiftyoneDegreesEvidencePrefix prefix,
 	fiftyoneDegreesKeyValuePair pair);
 
+/**
+ * Parses a raw HTTP/1.x header block adding a header evidence entry for each
+ * header field. If the block starts with the request line and addQuery is
+ * true then each parameter of the query string in the request target is added
+ * as query evidence. Parsing stops at the first empty line or at the end of
+ * the block. The keys and values point into the block and are NOT null 
+ * terminated, so the key and value lengths must be used. Query parameters are
+ * not URL decoded. The block must not be freed or modified until after the
+ * evidence collection has been freed. If there is insufficient capacity in 
+ * the evidence array then another array will be created as for
+ * #fiftyoneDegreesEvidenceAddPair.
+ * @param evidence pointer to the evidence array to add the entries to
+ * @param block start of the raw header block
+ * @param length number of characters in the block
+ * @param addQuery true if the query string from the request line should be 
+ * added
+ * @return the number of entries added to the evidence
+ */
+EXTERNAL uint32_t fiftyoneDegreesEvidenceAddHeaderBlock(
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence,
+	const char* block,
+	size_t length,
+	bool addQuery);
+
 /**
  * Determines the evidence map prefix from the key.
  * @param key the evidence key including the evidence prefix .i.e. header
@@ -311,6 +395,100 @@ EXTERNAL bool fiftyoneDegreesEvidenceIterateForHeaders(
 	void* state,
 	fiftyoneDegreesEvidenceIterateMethod callback);
 
+/**
+ * Relates the index of each header in a headers structure to the first
+ * evidence pair for the header. Initialised with
+ * #fiftyoneDegreesEvidenceHeaderIndexInit.
+ */
+typedef struct fiftyone_degrees_evidence_header_index_t {
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence; /**< Evidence that has
+														been indexed */
+	int prefixes; /**< Prefixes of the evidence that has been indexed */
+	fiftyoneDegreesHeaders* headers; /**< Headers the index relates to */
+	fiftyoneDegreesEvidenceKeyValuePair** pairs; /**< Caller provided array of
+												 the first pair for each
+												 header index, or NULL if no
+												 pair exists */
+	uint32_t count; /**< Number of elements in the pairs array */
+} fiftyoneDegreesEvidenceHeaderIndex;
+
+/**
+ * Initialises the header index by resolving each evidence pair that matches
+ * the prefixes to its header in a single pass of the evidence. The header
+ * member of each resolved pair is also set. The pairs array must remain valid
+ * for the lifetime of the index, and should contain at least headers->count
+ * elements. Headers with an index greater than or equal to count are not
+ * indexed and will be searched for when the index is used. The evidence must
+ * not be modified whilst the index is in use.
+ *
+ * @param index to be initialised
+ * @param evidence key value pairs including prefixes
+ * @param prefixes one or more prefix flags to index values for
+ * @param headers all the headers that the evidence could relate to
+ * @param pairs array to store the pair for each header index in
+ * @param count number of elements in the pairs array
+ * @return the number of evidence pairs matching the prefixes examined
+ */
+EXTERNAL uint32_t fiftyoneDegreesEvidenceHeaderIndexInit(
+	fiftyoneDegreesEvidenceHeaderIndex* index,
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence,
+	int prefixes,
+	fiftyoneDegreesHeaders* headers,
+	fiftyoneDegreesEvidenceKeyValuePair** pairs,
+	uint32_t count);
+
+/**
+ * As #fiftyoneDegreesEvidenceIterateForHeaders but using a header index to
+ * find the evidence for each header and pseudo header segment without
+ * searching the evidence.
+ *
+ * @param index initialised with #fiftyoneDegreesEvidenceHeaderIndexInit
+ * @param headers to return evidence for if available
+ * @param buffer that MIGHT be used with the callback, null to disable
+ * assembling headers
+ * @param length of the buffer
+ * @param state pointer passed to the callback method
+ * @param callback method called when a matching prefix is found
+ * @return true if the callback was called successfully, otherwise false
+ */
+EXTERNAL bool fiftyoneDegreesEvidenceIterateForHeadersIndexed(
+	fiftyoneDegreesEvidenceHeaderIndex* index,
+	fiftyoneDegreesHeaderPtrs* headers,
+	char* const buffer,
+	size_t const length,
+	void* state,
+	fiftyoneDegreesEvidenceIterateMethod callback);
+
+/**
+ * As #fiftyoneDegreesEvidenceIterateForHeaders but assembling pseudo headers
+ * in a string builder provided by the caller. If the builder was initialized
+ * with #fiftyoneDegreesStringBuilderInitGrowable then pseudo headers of any
+ * length are assembled, and the memory of the builder can be reused across
+ * requests. The builder is initialized before each pseudo header is
+ * assembled.
+ *
+ * @param evidence key value pairs including prefixes, ignored if index is
+ * provided
+ * @param prefixes one or more prefix flags to return values for, ignored if
+ * index is provided
+ * @param index initialised with #fiftyoneDegreesEvidenceHeaderIndexInit, or
+ * NULL to search the evidence for each header
+ * @param headers to return evidence for if available
+ * @param builder used to assemble pseudo headers, or NULL to disable
+ * assembling headers
+ * @param state pointer passed to the callback method
+ * @param callback method called when a matching prefix is found
+ * @return true if the callback was called successfully, otherwise false
+ */
+EXTERNAL bool fiftyoneDegreesEvidenceIterateForHeadersWithBuilder(
+	fiftyoneDegreesEvidenceKeyValuePairArray* evidence,
+	int prefixes,
+	fiftyoneDegreesEvidenceHeaderIndex* index,
+	fiftyoneDegreesHeaderPtrs* headers,
+	fiftyoneDegreesStringBuilder* builder,
+	void* state,
+	fiftyoneDegreesEvidenceIterateMethod callback);
+
 /**
  * @}
  */
@@ -73,6 +73,7 @@
 #include "overrides.h"
 #include "tree.h"
 #include "ip.h"
+#include "ipRange.h"
 #include "float.h"
 #include "snprintf.h"
 #include "bool.h"
@@ -81,7 +82,10 @@
 #include "yamlfile.h"
 #include "indices.h"
 #include "json.h"
+#include "cbor.h"
+#include "columns.h"
 #include "wkbtot.h"
+#include "wkbtotCache.h"
 #include "constants.h"
 
 /**
@@ -132,6 +136,7 @@ MAP_TYPE(ResourceManager)
 MAP_TYPE(EvidenceKeyValuePair)
 MAP_TYPE(EvidencePrefixMap)
 MAP_TYPE(EvidencePrefix)
+MAP_TYPE(EvidenceHeaderIndex)
 MAP_TYPE(Headers)
 MAP_TYPE(ResourceHandle)
 MAP_TYPE(InterlockDoubleWidth)
@@ -151,6 +156,7 @@ MAP_TYPE(DataSetInitFromFileMethod)
 MAP_TYPE(String)
 MAP_TYPE(VarLengthByteArray)
 MAP_TYPE(StoredBinaryValue)
+MAP_TYPE(StoredBinaryValueTarget)
 MAP_TYPE(Property)
 MAP_TYPE(PropertyTypeRecord)
 MAP_TYPE(Component)
@@ -173,6 +179,7 @@ MAP_TYPE(Headers)
 MAP_TYPE(HeaderID)
 MAP_TYPE(HeaderPtr)
 MAP_TYPE(HeaderPtrs)
+MAP_TYPE(HeaderHashSlot)
 MAP_TYPE(OverridesFilterMethod)
 MAP_TYPE(Mutex)
 MAP_TYPE(Signal)
@@ -184,13 +191,26 @@ MAP_TYPE(Float)
 MAP_TYPE(KeyValuePair)
 MAP_TYPE(HeaderID)
 MAP_TYPE(IndicesPropertyProfile)
+MAP_TYPE(IndicesPropertyValue)
+MAP_TYPE(IndicesPropertyValueSlot)
 MAP_TYPE(StringBuilder)
+MAP_TYPE(StringBuilderSinkMethod)
+MAP_TYPE(StringBuilderAllocator)
 MAP_TYPE(Json)
+MAP_TYPE(JsonFragment)
+MAP_TYPE(JsonFragmentName)
+MAP_TYPE(JsonFragments)
+MAP_TYPE(Cbor)
+MAP_TYPE(Columns)
 MAP_TYPE(KeyValuePairArray)
 MAP_TYPE(IpType)
 MAP_TYPE(IpAddress)
+MAP_TYPE(IpRangeIndex)
 MAP_TYPE(WkbtotResult)
 MAP_TYPE(WkbtotReductionMode)
+MAP_TYPE(WkbtotCache)
+MAP_TYPE(WkbCoordinates)
+MAP_TYPE(WkbCoordinatesCallback)
 
 #define ProfileGetFinalSize fiftyoneDegreesProfileGetFinalSize /**< Synonym for #fiftyoneDegreesProfileGetFinalSize function. */
 #define ProfileGetOffsetForProfileId fiftyoneDegreesProfileGetOffsetForProfileId /**< Synonym for #fiftyoneDegreesProfileGetOffsetForProfileId function. */
@@ -213,6 +233,7 @@ MAP_TYPE(WkbtotReductionMode)
 #define ProfileIterateProfilesForPropertyAndValue fiftyoneDegreesProfileIterateProfilesForPropertyAndValue /**< Synonym for #fiftyoneDegreesProfileIterateProfilesForPropertyAndValue function. */
 #define ProfileIterateProfilesForPropertyWithTypeAndValue fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValue /**< Synonym for #fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValue function. */
 #define ProfileIterateProfilesForPropertyWithTypeAndValueAndOffsetExtractor fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValueAndOffsetExtractor /**< Synonym for #fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValueAndOffsetExtractor function. */
+#define ProfileIterateProfilesForPropertyAndValueWithIndex fiftyoneDegreesProfileIterateProfilesForPropertyAndValueWithIndex /**< Synonym for #fiftyoneDegreesProfileIterateProfilesForPropertyAndValueWithIndex function. */
 #define ProfileOffsetAsPureOffset fiftyoneDegreesProfileOffsetAsPureOffset /**< Synonym for #fiftyoneDegreesProfileOffsetAsPureOffset function. */
 #define ProfileOffsetToPureOffset fiftyoneDegreesProfileOffsetToPureOffset /**< Synonym for #fiftyoneDegreesProfileOffsetToPureOffset function. */
 #define PropertiesGetPropertyIndexFromName fiftyoneDegreesPropertiesGetPropertyIndexFromName /**< Synonym for #fiftyoneDegreesPropertiesGetPropertyIndexFromName function. */
@@ -228,13 +249,22 @@ MAP_TYPE(WkbtotReductionMode)
 #define OverridePropertiesCreate fiftyoneDegreesOverridePropertiesCreate /**< Synonym for #fiftyoneDegreesOverridePropertiesCreate function. */
 #define EvidenceCreate fiftyoneDegreesEvidenceCreate /**< Synonym for #fiftyoneDegreesEvidenceCreate function. */
 #define EvidenceFree fiftyoneDegreesEvidenceFree /**< Synonym for #fiftyoneDegreesEvidenceFree function. */
+#define EvidenceSize fiftyoneDegreesEvidenceSize /**< Synonym for #fiftyoneDegreesEvidenceSize function. */
+#define EvidenceInit fiftyoneDegreesEvidenceInit /**< Synonym for #fiftyoneDegreesEvidenceInit function. */
+#define EvidenceReset fiftyoneDegreesEvidenceReset /**< Synonym for #fiftyoneDegreesEvidenceReset function. */
 #define OverridesGetOverridingRequiredPropertyIndex fiftyoneDegreesOverridesGetOverridingRequiredPropertyIndex /**< Synonym for #fiftyoneDegreesOverridesGetOverridingRequiredPropertyIndex function. */
 #define StringCompareLength fiftyoneDegreesStringCompareLength /**< Synonym for #fiftyoneDegreesStringCompareLength function. */
 #define StringCompare fiftyoneDegreesStringCompare /**< Synonym for #fiftyoneDegreesStringCompare function. */
+#define StringToDouble fiftyoneDegreesStringToDouble /**< Synonym for #fiftyoneDegreesStringToDouble function. */
 #define StringSubString fiftyoneDegreesStringSubString /**< Synonym for #fiftyoneDegreesSubString function. */
+#define StringHash fiftyoneDegreesStringHash /**< Synonym for #fiftyoneDegreesStringHash function. */
+#define StringHashCaseInsensitive fiftyoneDegreesStringHashCaseInsensitive /**< Synonym for #fiftyoneDegreesStringHashCaseInsensitive function. */
 #define OverridesExtractFromEvidence fiftyoneDegreesOverridesExtractFromEvidence /**< Synonym for #fiftyoneDegreesOverridesExtractFromEvidence function. */
 #define EvidenceIterate fiftyoneDegreesEvidenceIterate /**< Synonym for #fiftyoneDegreesEvidenceIterate function. */
 #define EvidenceIterateForHeaders fiftyoneDegreesEvidenceIterateForHeaders /**< Synonym for #fiftyoneDegreesEvidenceIterateForHeaders function. */
+#define EvidenceIterateForHeadersIndexed fiftyoneDegreesEvidenceIterateForHeadersIndexed /**< Synonym for #fiftyoneDegreesEvidenceIterateForHeadersIndexed function. */
+#define EvidenceIterateForHeadersWithBuilder fiftyoneDegreesEvidenceIterateForHeadersWithBuilder /**< Synonym for fiftyoneDegreesEvidenceIterateForHeadersWithBuilder */
+#define EvidenceHeaderIndexInit fiftyoneDegreesEvidenceHeaderIndexInit /**< Synonym for #fiftyoneDegreesEvidenceHeaderIndexInit function. */
 #define CacheRelease fiftyoneDegreesCacheRelease /**< Synonym for #fiftyoneDegreesCacheRelease function. */
 #define DataReset fiftyoneDegreesDataReset /**< Synonym for #fiftyoneDegreesDataReset function. */
 #define CacheFree fiftyoneDegreesCacheFree /**< Synonym for #fiftyoneDegreesCacheFree function. */
@@ -242,6 +272,7 @@ MAP_TYPE(WkbtotReductionMode)
 #define FileHandleRelease fiftyoneDegreesFileHandleRelease /**< Synonym for #fiftyoneDegreesFileHandleRelease function. */
 #define DataMalloc fiftyoneDegreesDataMalloc /**< Synonym for #fiftyoneDegreesDataMalloc function. */
 #define CacheGet fiftyoneDegreesCacheGet /**< Synonym for #fiftyoneDegreesCacheGet function. */
+#define CacheHash64Mixed fiftyoneDegreesCacheHash64Mixed /**< Synonym for #fiftyoneDegreesCacheHash64Mixed function. */
 #define CacheCreate fiftyoneDegreesCacheCreate /**< Synonym for #fiftyoneDegreesCacheCreate function. */
 #define MemoryAdvance fiftyoneDegreesMemoryAdvance /**< Synonym for #fiftyoneDegreesMemoryAdvance function. */
 #define MemoryTrackingReset fiftyoneDegreesMemoryTrackingReset /**< Synonym for #fiftyoneDegreesMemoryTrackingReset function. */
@@ -302,6 +333,8 @@ MAP_TYPE(WkbtotReductionMode)
 #define StoredBinaryValueGet fiftyoneDegreesStoredBinaryValueGet /**< Synonym for #fiftyoneDegreesStoredBinaryValueGet function. */
 #define StoredBinaryValueRead fiftyoneDegreesStoredBinaryValueRead /**< Synonym for #fiftyoneDegreesStoredBinaryValueRead function. */
 #define StoredBinaryValueCompareWithString fiftyoneDegreesStoredBinaryValueCompareWithString /**< Synonym for #fiftyoneDegreesStoredBinaryValueCompareWithString function. */
+#define StoredBinaryValueTargetInit fiftyoneDegreesStoredBinaryValueTargetInit /**< Synonym for #fiftyoneDegreesStoredBinaryValueTargetInit function. */
+#define StoredBinaryValueCompareWithTarget fiftyoneDegreesStoredBinaryValueCompareWithTarget /**< Synonym for #fiftyoneDegreesStoredBinaryValueCompareWithTarget function. */
 #define StoredBinaryValueToIntOrDefault fiftyoneDegreesStoredBinaryValueToIntOrDefault /**< Synonym for #fiftyoneDegreesStoredBinaryValueToIntOrDefault function. */
 #define StoredBinaryValueToDoubleOrDefault fiftyoneDegreesStoredBinaryValueToDoubleOrDefault /**< Synonym for #fiftyoneDegreesStoredBinaryValueToDoubleOrDefault function. */
 #define StoredBinaryValueToBoolOrDefault fiftyoneDegreesStoredBinaryValueToBoolOrDefault /**< Synonym for #fiftyoneDegreesStoredBinaryValueToBoolOrDefault function. */
@@ -311,7 +344,9 @@ MAP_TYPE(WkbtotReductionMode)
 #define EvidencePrefixString fiftyoneDegreesEvidencePrefixString /**< Synonym for #fiftyoneDegreesEvidencePrefixString function. */
 #define EvidenceAddPair fiftyoneDegreesEvidenceAddPair /**< Synonym for #fiftyoneDegreesEvidenceAddPair function. */
 #define EvidenceAddString fiftyoneDegreesEvidenceAddString /**< Synonym for #fiftyoneDegreesEvidenceAddString function. */
+#define EvidenceAddHeaderBlock fiftyoneDegreesEvidenceAddHeaderBlock /**< Synonym for #fiftyoneDegreesEvidenceAddHeaderBlock function. */
 #define PropertiesGetRequiredPropertyIndexFromName fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName /**< Synonym for #fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName function. */
+#define PropertiesGetRequiredPropertyIndexFromPropertyIndex fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex /**< Synonym for #fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex function. */
 #define PropertiesGetNameFromRequiredIndex fiftyoneDegreesPropertiesGetNameFromRequiredIndex /**< Synonym for #fiftyoneDegreesPropertiesGetNameFromRequiredIndex function. */
 #define PropertiesIsSetHeaderAvailable fiftyoneDegreesPropertiesIsSetHeaderAvailable /**< Synonym for #fiftyoneDegreesPropertiesIsSetHeaderAvailable */
 #define CollectionHeaderFromFile fiftyoneDegreesCollectionHeaderFromFile /**< Synonym for #fiftyoneDegreesCollectionHeaderFromFile function. */
@@ -375,12 +410,32 @@ MAP_TYPE(WkbtotReductionMode)
 #define IndicesPropertyProfileCreate fiftyoneDegreesIndicesPropertyProfileCreate /**< Synonym for fiftyoneDegreesIndicesPropertyProfileCreate */
 #define IndicesPropertyProfileFree fiftyoneDegreesIndicesPropertyProfileFree /**< Synonym for fiftyoneDegreesIndicesPropertyProfileFree */
 #define IndicesPropertyProfileLookup fiftyoneDegreesIndicesPropertyProfileLookup /**< Synonym for fiftyoneDegreesIndicesPropertyProfileLookup */
+#define IndicesPropertyValueCreate fiftyoneDegreesIndicesPropertyValueCreate /**< Synonym for fiftyoneDegreesIndicesPropertyValueCreate */
+#define IndicesPropertyValueFree fiftyoneDegreesIndicesPropertyValueFree /**< Synonym for fiftyoneDegreesIndicesPropertyValueFree */
+#define IndicesPropertyValueLookup fiftyoneDegreesIndicesPropertyValueLookup /**< Synonym for fiftyoneDegreesIndicesPropertyValueLookup */
 #define JsonDocumentStart fiftyoneDegreesJsonDocumentStart /**< Synonym for fiftyoneDegreesJsonDocumentStart */
 #define JsonDocumentEnd fiftyoneDegreesJsonDocumentEnd /**< Synonym for fiftyoneDegreesJsonDocumentEnd */
 #define JsonPropertyStart fiftyoneDegreesJsonPropertyStart /**< Synonym for fiftyoneDegreesJsonPropertyStart */
 #define JsonPropertyEnd fiftyoneDegreesJsonPropertyEnd /**< Synonym for fiftyoneDegreesJsonPropertyEnd */
 #define JsonPropertyValues fiftyoneDegreesJsonPropertyValues /**< Synonym for fiftyoneDegreesJsonPropertyValues */
 #define JsonPropertySeparator fiftyoneDegreesJsonPropertySeparator /**< Synonym for fiftyoneDegreesJsonPropertySeparator */
+#define JsonPropertyValueIndexes fiftyoneDegreesJsonPropertyValueIndexes /**< Synonym for fiftyoneDegreesJsonPropertyValueIndexes */
+#define JsonFragmentsCreate fiftyoneDegreesJsonFragmentsCreate /**< Synonym for fiftyoneDegreesJsonFragmentsCreate */
+#define JsonFragmentsFree fiftyoneDegreesJsonFragmentsFree /**< Synonym for fiftyoneDegreesJsonFragmentsFree */
+#define CborDocumentStart fiftyoneDegreesCborDocumentStart /**< Synonym for fiftyoneDegreesCborDocumentStart */
+#define CborDocumentEnd fiftyoneDegreesCborDocumentEnd /**< Synonym for fiftyoneDegreesCborDocumentEnd */
+#define CborPropertyStart fiftyoneDegreesCborPropertyStart /**< Synonym for fiftyoneDegreesCborPropertyStart */
+#define CborPropertyEnd fiftyoneDegreesCborPropertyEnd /**< Synonym for fiftyoneDegreesCborPropertyEnd */
+#define CborPropertyValues fiftyoneDegreesCborPropertyValues /**< Synonym for fiftyoneDegreesCborPropertyValues */
+#define ColumnsInit fiftyoneDegreesColumnsInit /**< Synonym for fiftyoneDegreesColumnsInit */
+#define ColumnsReset fiftyoneDegreesColumnsReset /**< Synonym for fiftyoneDegreesColumnsReset */
+#define ColumnsRowStart fiftyoneDegreesColumnsRowStart /**< Synonym for fiftyoneDegreesColumnsRowStart */
+#define ColumnsAddValues fiftyoneDegreesColumnsAddValues /**< Synonym for fiftyoneDegreesColumnsAddValues */
+#define ColumnsAddText fiftyoneDegreesColumnsAddText /**< Synonym for fiftyoneDegreesColumnsAddText */
+#define ColumnsRowEnd fiftyoneDegreesColumnsRowEnd /**< Synonym for fiftyoneDegreesColumnsRowEnd */
+#define ColumnsGetText fiftyoneDegreesColumnsGetText /**< Synonym for fiftyoneDegreesColumnsGetText */
+#define ColumnsGetNumber fiftyoneDegreesColumnsGetNumber /**< Synonym for fiftyoneDegreesColumnsGetNumber */
+#define ColumnsFree fiftyoneDegreesColumnsFree /**< Synonym for fiftyoneDegreesColumnsFree */
 #define StringBuilderInit fiftyoneDegreesStringBuilderInit /**< Synonym for fiftyoneDegreesStringBuilderInit */
 #define StringBuilderAddChar fiftyoneDegreesStringBuilderAddChar /**< Synonym for fiftyoneDegreesStringBuilderAddChar */
 #define StringBuilderAddInteger fiftyoneDegreesStringBuilderAddInteger /**< Synonym for fiftyoneDegreesStringBuilderAddInteger */
@@ -389,12 +444,30 @@ MAP_TYPE(WkbtotReductionMode)
 #define StringBuilderAddIpAddress fiftyoneDegreesStringBuilderAddIpAddress /**< Synonym for fiftyoneDegreesStringBuilderAddIpAddress */
 #define StringBuilderAddStringValue fiftyoneDegreesStringBuilderAddStringValue /**< Synonym for fiftyoneDegreesStringBuilderAddStringValue */
 #define StringBuilderComplete fiftyoneDegreesStringBuilderComplete /**< Synonym for fiftyoneDegreesStringBuilderComplete */
+#define StringBuilderFlush fiftyoneDegreesStringBuilderFlush /**< Synonym for fiftyoneDegreesStringBuilderFlush */
+#define StringBuilderTruncate fiftyoneDegreesStringBuilderTruncate /**< Synonym for fiftyoneDegreesStringBuilderTruncate */
+#define StringBuilderInitGrowable fiftyoneDegreesStringBuilderInitGrowable /**< Synonym for fiftyoneDegreesStringBuilderInitGrowable */
+#define StringBuilderReserve fiftyoneDegreesStringBuilderReserve /**< Synonym for fiftyoneDegreesStringBuilderReserve */
+#define StringBuilderFree fiftyoneDegreesStringBuilderFree /**< Synonym for fiftyoneDegreesStringBuilderFree */
 #define EvidenceIterateMethod fiftyoneDegreesEvidenceIterateMethod /**< Synonym for fiftyoneDegreesEvidenceIterateMethod */
 #define OverrideHasValueForRequiredPropertyIndex fiftyoneDegreesOverrideHasValueForRequiredPropertyIndex /**< Synonym for fiftyoneDegreesOverrideHasValueForRequiredPropertyIndex */
 #define IpAddressParse fiftyoneDegreesIpAddressParse /**< Synonym for fiftyoneDegreesIpAddressParse */
+#define IpAddressesParse fiftyoneDegreesIpAddressesParse /**< Synonym for fiftyoneDegreesIpAddressesParse */
 #define IpAddressesCompare fiftyoneDegreesIpAddressesCompare /**< Synonym for fiftyoneDegreesIpAddressesCompare */
+#define IpRangeIndexSize fiftyoneDegreesIpRangeIndexSize /**< Synonym for fiftyoneDegreesIpRangeIndexSize */
+#define IpRangeIndexCreate fiftyoneDegreesIpRangeIndexCreate /**< Synonym for fiftyoneDegreesIpRangeIndexCreate */
+#define IpRangeIndexCreateFromMemory fiftyoneDegreesIpRangeIndexCreateFromMemory /**< Synonym for fiftyoneDegreesIpRangeIndexCreateFromMemory */
+#define IpRangeIndexFree fiftyoneDegreesIpRangeIndexFree /**< Synonym for fiftyoneDegreesIpRangeIndexFree */
+#define IpRangeIndexLookup fiftyoneDegreesIpRangeIndexLookup /**< Synonym for fiftyoneDegreesIpRangeIndexLookup */
 #define ConvertWkbToWkt fiftyoneDegreesConvertWkbToWkt /**< Synonym for fiftyoneDegreesConvertWkbToWkt */
 #define WriteWkbAsWktToStringBuilder fiftyoneDegreesWriteWkbAsWktToStringBuilder /**< Synonym for fiftyoneDegreesWriteWkbAsWktToStringBuilder */
+#define ConvertWkbToGeoJson fiftyoneDegreesConvertWkbToGeoJson /**< Synonym for fiftyoneDegreesConvertWkbToGeoJson */
+#define WriteWkbAsGeoJsonToStringBuilder fiftyoneDegreesWriteWkbAsGeoJsonToStringBuilder /**< Synonym for fiftyoneDegreesWriteWkbAsGeoJsonToStringBuilder */
+#define WkbIterateCoordinates fiftyoneDegreesWkbIterateCoordinates /**< Synonym for fiftyoneDegreesWkbIterateCoordinates */
+#define WkbtotCacheCreate fiftyoneDegreesWkbtotCacheCreate /**< Synonym for fiftyoneDegreesWkbtotCacheCreate */
+#define WkbtotCacheFree fiftyoneDegreesWkbtotCacheFree /**< Synonym for fiftyoneDegreesWkbtotCacheFree */
+#define WkbtotCacheGet fiftyoneDegreesWkbtotCacheGet /**< Synonym for fiftyoneDegreesWkbtotCacheGet */
+#define WkbtotCacheWriteToStringBuilder fiftyoneDegreesWkbtotCacheWriteToStringBuilder /**< Synonym for fiftyoneDegreesWkbtotCacheWriteToStringBuilder */
 
 /* <-- only one asterisk to avoid inclusion in documentation
  * Shortened constants.
@@ -72,6 +72,8 @@ static void freeHeader(Header* header) {
  * Sets all the header elements to default settings.
  */
 static void initHeaders(Headers* headers) {
+	headers->hashSlots = NULL;
+	headers->hashMask = 0;
 	for (uint32_t i = 0; i < headers->capacity; i++) {
 		Header* h = &headers->items[i];
 		h->index = i;
@@ -517,6 +519,41 @@ static Headers* trimHeaders(Headers* source, Exception* exception) {
 	return trimmed;
 }
 
+/**
+ * Creates the hash table used to find the index of a header from its name.
+ * The table has at least twice as many slots as there are headers so that 
+ * probe sequences are short.
+ */
+static bool createHashSlots(Headers* headers, Exception* exception) {
+	uint32_t size = 2, slot, hash;
+	while (size < headers->count * 2) {
+		size <<= 1;
+	}
+	headers->hashSlots = (HeaderHashSlot*)Malloc(
+		sizeof(HeaderHashSlot) * size);
+	if (headers->hashSlots == NULL) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return false;
+	}
+	headers->hashMask = size - 1;
+	for (slot = 0; slot < size; slot++) {
+		headers->hashSlots[slot].hash = 0;
+		headers->hashSlots[slot].index = -1;
+	}
+	for (uint32_t i = 0; i < headers->count; i++) {
+		hash = StringHashCaseInsensitive(
+			headers->items[i].name,
+			headers->items[i].nameLength);
+		slot = hash & headers->hashMask;
+		while (headers->hashSlots[slot].index >= 0) {
+			slot = (slot + 1) & headers->hashMask;
+		}
+		headers->hashSlots[slot].hash = hash;
+		headers->hashSlots[slot].index = (int32_t)i;
+	}
+	return true;
+}
+
 fiftyoneDegreesHeaders* fiftyoneDegreesHeadersCreate(
 	bool expectUpperPrefixedHeaders,
 	void *state,
@@ -557,6 +594,13 @@ fiftyoneDegreesHeaders* fiftyoneDegreesHeadersCreate(
 
 		// Set the prefixed headers flag.
 		headers->expectUpperPrefixedHeaders = expectUpperPrefixedHeaders;
+
+		// Index the header names so that they can be found with a single
+		// hash.
+		if (createHashSlots(headers, exception) == false) {
+			HeadersFree(headers);
+			return NULL;
+		}
 	}
 	return headers;
 }
@@ -565,7 +609,7 @@ int fiftyoneDegreesHeaderGetIndex(
 	fiftyoneDegreesHeaders *headers,
 	const char* httpHeaderName,
 	size_t length) {
-	uint32_t i;
+	uint32_t hash, slot;
 	Header* header;
 
 	// Check if header is from a Perl or PHP wrapper in the form of HTTP_*
@@ -580,15 +624,21 @@ int fiftyoneDegreesHeaderGetIndex(
 		httpHeaderName += sizeof(HTTP_PREFIX_UPPER) - 1;
 	}
 
-	// Perform a case insensitive compare of the remaining characters.
-	for (i = 0; i < headers->count; i++) {
-		header = &headers->items[i];
-		if (header->nameLength == length &&
-			StringCompareLength(
-				httpHeaderName, 
-				header->name,
-				length) == 0) {
-			return i;
+	// Probe the hash table performing a case insensitive compare of the
+	// remaining characters for any header with the same hash.
+	hash = StringHashCaseInsensitive(httpHeaderName, length);
+	for (slot = hash & headers->hashMask;
+		headers->hashSlots[slot].index >= 0;
+		slot = (slot + 1) & headers->hashMask) {
+		if (headers->hashSlots[slot].hash == hash) {
+			header = &headers->items[headers->hashSlots[slot].index];
+			if (header->nameLength == length &&
+				StringCompareLength(
+					httpHeaderName,
+					header->name,
+					length) == 0) {
+				return headers->hashSlots[slot].index;
+			}
 		}
 	}
 
@@ -613,6 +663,9 @@ void fiftyoneDegreesHeadersFree(fiftyoneDegreesHeaders *headers) {
 		for (i = 0; i < headers->count; i++) {
 			freeHeader(&headers->items[i]);
 		}
+		if (headers->hashSlots != NULL) {
+			Free((void*)headers->hashSlots);
+		}
 		Free((void*)headers);
 		headers = NULL;
 	}
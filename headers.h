@@ -151,10 +151,22 @@ struct fiftyone_degrees_header_t {
 												  header */
 };
 
+/**
+ * Slot in the hash table used to find the index of a header from its name.
+ */
+typedef struct fiftyone_degrees_header_hash_slot_t {
+	uint32_t hash; /**< Case insensitive hash of the header name */
+	int32_t index; /**< Index of the header in the headers array, or -1 if the
+				   slot is empty */
+} fiftyoneDegreesHeaderHashSlot;
+
 #define FIFTYONE_DEGREES_HEADERS_MEMBERS \
 bool expectUpperPrefixedHeaders; /**< True if the headers structure should
 								 expect input header to be prefixed with
-								 'HTTP_' */
+								 'HTTP_' */ \
+fiftyoneDegreesHeaderHashSlot* hashSlots; /**< Open addressing hash table of
+										  the case folded header names */ \
+uint32_t hashMask; /**< Number of hash slots minus one */
 
 /**
  * Array of Headers which should always be ordered in ascending order of 
@@ -205,7 +217,9 @@ EXTERNAL fiftyoneDegreesHeaders* fiftyoneDegreesHeadersCreate(
 
 /**
  * Provides the integer index of the HTTP header name, or -1 if there is no 
- * matching header.
+ * matching header. The name is found with a single case insensitive hash and
+ * one verification compare. If the headers expect upper prefixed headers then
+ * a leading 'HTTP_' is ignored.
  * @param headers structure created by #fiftyoneDegreesHeadersCreate
  * @param httpHeaderName of the header whose index is required
  * @param length number of characters in httpHeaderName
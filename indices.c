@@ -25,11 +25,7 @@
 #include "collectionKeyTypes.h"
 #include "fiftyone.h"
 
-// Working data structure used to construct the index.
-typedef struct map_t {
-	uint32_t availableProperty; // available property index
-	int16_t propertyIndex; // index in the properties collection
-} map;
+MAP_TYPE(Collection)
 
 // Gets the index of the profile id in the property profile index.
 static uint32_t getProfileIdIndex(
@@ -43,11 +39,12 @@ static uint32_t getProfileIdIndex(
 // profile.
 static void addProfileValuesMethod(
 	IndicesPropertyProfile* index, // index in use or null if not available
-	map* propertyIndexes, // property indexes in ascending order
+	PropertiesAvailable* available, // properties available
 	fiftyoneDegreesCollection* values, // collection of values
 	Profile* profile, 
 	Exception* exception) {
-	uint32_t valueIndex;
+	int requiredPropertyIndex;
+	int16_t lastPropertyIndex = -1;
 	Item valueItem; // The current value memory
 	Value* value; // The current value pointer
 	DataReset(&valueItem.data);
@@ -61,34 +58,28 @@ static void addProfileValuesMethod(
 		CollectionKeyType_Value,
 	};
 	// For each of the values associated with the profile check to see if it
-	// relates to a new property index. If it does then record the first value
-	// index and advance the current index to the next pointer.
-	for (uint32_t i = 0, p = 0;
+	// is the first value for a required property. If it is then record the
+	// value index. The values are ordered by property so the loop can end
+	// once all the required properties have been found.
+	for (uint32_t i = 0, found = 0;
 		i < profile->valueCount &&
-		p < index->availablePropertyCount &&
+		found < index->availablePropertyCount &&
 		EXCEPTION_OKAY;
 		i++) {
 		valueKey.indexOrOffset.offset = *(first + i);
 		value = values->get(values, &valueKey, &valueItem, exception);
 		if (value != NULL && EXCEPTION_OKAY) {
-
-			// If the value doesn't relate to the next property index then 
-			// move to the next property index.
-			while (p < index->availablePropertyCount && // first check validity 
-				// of the subscript and then use it
-                propertyIndexes[p].propertyIndex < value->propertyIndex) {
-				p++;
-			}
-
-			// If the value relates to the next property index being sought 
-			// then record the first value in the profile associated with the
-			// property.
-			if (p < index->availablePropertyCount &&
-				value->propertyIndex == propertyIndexes[p].propertyIndex) {
-				valueIndex = base + propertyIndexes[p].availableProperty;
-				index->valueIndexes[valueIndex] = i;
-				p++;
-				index->filled++;
+			if (value->propertyIndex != lastPropertyIndex) {
+				lastPropertyIndex = value->propertyIndex;
+				requiredPropertyIndex =
+					PropertiesGetRequiredPropertyIndexFromPropertyIndex(
+						available,
+						(uint32_t)value->propertyIndex);
+				if (requiredPropertyIndex >= 0) {
+					index->valueIndexes[base + requiredPropertyIndex] = i;
+					found++;
+					index->filled++;
+				}
 			}
 			COLLECTION_RELEASE(values, &valueItem);
 		}
@@ -99,7 +90,7 @@ static void iterateProfiles(
 	fiftyoneDegreesCollection* profiles,
 	fiftyoneDegreesCollection* profileOffsets,
 	IndicesPropertyProfile* index, // index in use or null if not available
-	map* propertyIndexes, // property indexes in ascending order
+	PropertiesAvailable* available, // properties available
 	fiftyoneDegreesCollection* values, // collection of values
 	Exception *exception) {
 	Profile* profile; // The current profile pointer
@@ -135,7 +126,7 @@ static void iterateProfiles(
 			if (profile != NULL && EXCEPTION_OKAY) {
 				addProfileValuesMethod(
 					index,
-					propertyIndexes,
+					available,
 					values,
 					profile,
 					exception);
@@ -172,27 +163,6 @@ static uint32_t getProfileId(
 	return profileId;
 }
 
-static int comparePropertyIndexes(const void* a, const void* b) {
-	return ((map*)a)->propertyIndex - ((map*)b)->propertyIndex;
-}
-
-// Build an ascending ordered array of the property indexes.
-static map* createPropertyIndexes(
-	PropertiesAvailable* available,
-	Exception* exception) {
-	map* index = (map*)Malloc(sizeof(map) * available->count);
-	if (index == NULL) {
-		EXCEPTION_SET(FIFTYONE_DEGREES_STATUS_INSUFFICIENT_MEMORY);
-		return NULL;
-	}
-	for (uint32_t i = 0; i < available->count; i++) {
-		index[i].availableProperty = i;
-		index[i].propertyIndex = (int16_t)available->items[i].propertyIndex;
-	}
-	qsort(index, available->count, sizeof(map*), comparePropertyIndexes);
-	return index;
-}
-
 fiftyoneDegreesIndicesPropertyProfile*
 fiftyoneDegreesIndicesPropertyProfileCreate(
 	fiftyoneDegreesCollection* profiles,
@@ -201,12 +171,6 @@ fiftyoneDegreesIndicesPropertyProfileCreate(
 	fiftyoneDegreesCollection* values,
 	fiftyoneDegreesException* exception) {
 
-	// Create the ordered list of property indexes.
-	map* propertyIndexes = createPropertyIndexes(available, exception);
-	if (propertyIndexes == NULL) {
-		return NULL;
-	}
-
 	// Allocate memory for the index and set the fields.
 	IndicesPropertyProfile* index = (IndicesPropertyProfile*)Malloc(
 		sizeof(IndicesPropertyProfile));
@@ -219,7 +183,6 @@ fiftyoneDegreesIndicesPropertyProfileCreate(
 	index->minProfileId = getProfileId(profileOffsets, 0, exception);
 	if (!EXCEPTION_OKAY) {
 		Free(index);
-		Free(propertyIndexes);
 		return NULL;
 	}
 	index->maxProfileId = getProfileId(
@@ -228,7 +191,6 @@ fiftyoneDegreesIndicesPropertyProfileCreate(
 		exception);
 	if (!EXCEPTION_OKAY) {
 		Free(index);
-		Free(propertyIndexes);
 		return NULL;
 	}
 	index->availablePropertyCount = available->count;
@@ -240,7 +202,6 @@ fiftyoneDegreesIndicesPropertyProfileCreate(
 	if (index->valueIndexes == NULL) {
 		EXCEPTION_SET(FIFTYONE_DEGREES_STATUS_INSUFFICIENT_MEMORY);
 		Free(index);
-		Free(propertyIndexes);
 		return NULL;
 	}
 
@@ -250,10 +211,9 @@ fiftyoneDegreesIndicesPropertyProfileCreate(
 		profiles, 
 		profileOffsets, 
 		index, 
-		propertyIndexes,
+		available,
 		values,
 		exception);
-	Free(propertyIndexes);
 
 	// Return the index or free the memory if there was an exception.
 	if (EXCEPTION_OKAY) {
@@ -282,3 +242,355 @@ uint32_t fiftyoneDegreesIndicesPropertyProfileLookup(
 	assert(valueIndex < index->size);
 	return index->valueIndexes[valueIndex];
 }
+
+// Marks a slot in the value name hash table as empty.
+#define EMPTY_SLOT UINT32_MAX
+
+// Maximum length of the text form of any value which can be indexed. The
+// longest is an IPv6 address.
+#define MAX_INDEXED_VALUE_LENGTH 64
+
+// True if the text form of the stored type does not depend on the number of
+// decimal places requested and can therefore be indexed by name.
+static bool isIndexableType(PropertyValueType storedValueType) {
+	switch (storedValueType) {
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING:
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER:
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_BYTE:
+	case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_IP_ADDRESS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Returns the smallest power of 2 which is at least twice the count so that
+// the hash table for the property is never more than half full.
+static uint32_t getSlotCount(uint32_t count) {
+	uint32_t size = 2;
+	while (size < count * 2) {
+		size <<= 1;
+	}
+	return size;
+}
+
+// Hashes the text form of the value at the value index. Returns false if the
+// value could not be fetched or formatted.
+static bool hashValue(
+	const Collection* values,
+	const Collection* strings,
+	PropertyValueType storedValueType,
+	uint32_t valueIndex,
+	uint32_t* hash,
+	Exception* exception) {
+	Item valueItem, nameItem;
+	const StoredBinaryValue* content;
+	char buffer[MAX_INDEXED_VALUE_LENGTH];
+	StringBuilder builder = { buffer, sizeof(buffer) };
+	bool result = false;
+	DataReset(&valueItem.data);
+	DataReset(&nameItem.data);
+	const Value* value = ValueGet(values, valueIndex, &valueItem, exception);
+	if (value == NULL || EXCEPTION_FAILED) {
+		return false;
+	}
+	content = ValueGetContent(
+		strings,
+		value,
+		storedValueType,
+		&nameItem,
+		exception);
+	if (content != NULL && EXCEPTION_OKAY) {
+		if (storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
+			*hash = StringHash(
+				&content->stringValue.value,
+				content->stringValue.size > 0 ? 
+					content->stringValue.size - 1 : 0);
+			result = true;
+		}
+		else {
+			StringBuilderInit(&builder);
+			StringBuilderAddStringValue(
+				&builder,
+				content,
+				storedValueType,
+				MAX_DOUBLE_DECIMAL_PLACES,
+				exception);
+			if (EXCEPTION_OKAY && builder.full == false) {
+				*hash = StringHash(buffer, builder.added);
+				result = true;
+			}
+		}
+		COLLECTION_RELEASE(strings, &nameItem);
+	}
+	COLLECTION_RELEASE(values, &valueItem);
+	return result;
+}
+
+// Adds all the values of the property to the hash table starting at the first
+// slot provided. If any value can't be hashed then the table for the property
+// is emptied and its mask set to 0 so that lookups use the binary search
+// rather than a table which is missing values.
+static void addPropertyValues(
+	IndicesPropertyValue* index,
+	uint32_t availablePropertyIndex,
+	const Collection* values,
+	const Collection* strings,
+	Exception* exception) {
+	uint32_t hash, slot, added = 0;
+	const Property* property = &index->properties[availablePropertyIndex];
+	IndicesPropertyValueSlot* slots = 
+		index->slots + index->firstSlots[availablePropertyIndex];
+	uint32_t mask = index->masks[availablePropertyIndex];
+	for (uint32_t v = property->firstValueIndex;
+		v <= property->lastValueIndex && EXCEPTION_OKAY;
+		v++) {
+		if (hashValue(
+			values,
+			strings,
+			index->storedValueTypes[availablePropertyIndex],
+			v,
+			&hash,
+			exception) == false) {
+			for (slot = 0; slot <= mask; slot++) {
+				slots[slot].hash = 0;
+				slots[slot].valueIndex = EMPTY_SLOT;
+			}
+			index->filled -= added;
+			index->masks[availablePropertyIndex] = 0;
+			return;
+		}
+		slot = hash & mask;
+		while (slots[slot].valueIndex != EMPTY_SLOT) {
+			slot = (slot + 1) & mask;
+		}
+		slots[slot].hash = hash;
+		slots[slot].valueIndex = v;
+		index->filled++;
+		added++;
+	}
+}
+
+// Copies the available properties from the properties collection and sets the
+// stored value type, and the slots needed, for each of them. Returns the total
+// number of slots needed.
+static uint32_t initPropertyValueProperties(
+	IndicesPropertyValue* index,
+	Collection* properties,
+	Collection* propertyTypes,
+	PropertiesAvailable* available,
+	Exception* exception) {
+	Item propertyItem;
+	Property* property;
+	uint32_t size = 0;
+	DataReset(&propertyItem.data);
+	for (uint32_t i = 0; i < available->count && EXCEPTION_OKAY; i++) {
+		property = PropertyGet(
+			properties,
+			available->items[i].propertyIndex,
+			&propertyItem,
+			exception);
+		if (property == NULL || EXCEPTION_FAILED) {
+			return 0;
+		}
+		memcpy(&index->properties[i], property, sizeof(Property));
+		COLLECTION_RELEASE(properties, &propertyItem);
+		index->storedValueTypes[i] = propertyTypes == NULL ?
+			FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING :
+			PropertyGetStoredTypeByIndex(
+				propertyTypes,
+				available->items[i].propertyIndex,
+				exception);
+		index->firstSlots[i] = size;
+		index->masks[i] = 0;
+		if ((int)index->properties[i].firstValueIndex != -1 &&
+			index->properties[i].lastValueIndex >= 
+				index->properties[i].firstValueIndex &&
+			isIndexableType(index->storedValueTypes[i])) {
+			index->masks[i] = getSlotCount(
+				index->properties[i].lastValueIndex -
+				index->properties[i].firstValueIndex + 1) - 1;
+			size += index->masks[i] + 1;
+		}
+	}
+	return size;
+}
+
+fiftyoneDegreesIndicesPropertyValue*
+fiftyoneDegreesIndicesPropertyValueCreate(
+	fiftyoneDegreesCollection* properties,
+	fiftyoneDegreesCollection* propertyTypes,
+	fiftyoneDegreesCollection* values,
+	fiftyoneDegreesCollection* strings,
+	fiftyoneDegreesPropertiesAvailable* available,
+	fiftyoneDegreesException* exception) {
+
+	// Allocate memory for the index and the per property arrays.
+	IndicesPropertyValue* index = (IndicesPropertyValue*)Malloc(
+		sizeof(IndicesPropertyValue));
+	if (index == NULL) {
+		EXCEPTION_SET(FIFTYONE_DEGREES_STATUS_INSUFFICIENT_MEMORY);
+		return NULL;
+	}
+	index->slots = NULL;
+	index->filled = 0;
+	index->size = 0;
+	index->availablePropertyCount = available->count;
+	index->firstSlots = (uint32_t*)Malloc(sizeof(uint32_t) * available->count);
+	index->masks = (uint32_t*)Malloc(sizeof(uint32_t) * available->count);
+	index->storedValueTypes = (PropertyValueType*)Malloc(
+		sizeof(PropertyValueType) * available->count);
+	index->properties = (Property*)Malloc(sizeof(Property) * available->count);
+	if (index->firstSlots == NULL ||
+		index->masks == NULL ||
+		index->storedValueTypes == NULL ||
+		index->properties == NULL) {
+		EXCEPTION_SET(FIFTYONE_DEGREES_STATUS_INSUFFICIENT_MEMORY);
+		IndicesPropertyValueFree(index);
+		return NULL;
+	}
+
+	// Work out the number of slots needed for all the properties.
+	index->size = initPropertyValueProperties(
+		index,
+		properties,
+		propertyTypes,
+		available,
+		exception);
+	if (EXCEPTION_FAILED) {
+		IndicesPropertyValueFree(index);
+		return NULL;
+	}
+
+	// Allocate the slots marking them all as empty.
+	if (index->size > 0) {
+		index->slots = (IndicesPropertyValueSlot*)Malloc(
+			sizeof(IndicesPropertyValueSlot) * index->size);
+		if (index->slots == NULL) {
+			EXCEPTION_SET(FIFTYONE_DEGREES_STATUS_INSUFFICIENT_MEMORY);
+			IndicesPropertyValueFree(index);
+			return NULL;
+		}
+		for (uint32_t i = 0; i < index->size; i++) {
+			index->slots[i].hash = 0;
+			index->slots[i].valueIndex = EMPTY_SLOT;
+		}
+	}
+
+	// Add the values for each of the indexed properties.
+	for (uint32_t i = 0; i < available->count && EXCEPTION_OKAY; i++) {
+		if (index->masks[i] > 0) {
+			addPropertyValues(index, i, values, strings, exception);
+		}
+	}
+
+	// Return the index or free the memory if there was an exception.
+	if (EXCEPTION_OKAY) {
+		return index;
+	}
+	IndicesPropertyValueFree(index);
+	return NULL;
+}
+
+void fiftyoneDegreesIndicesPropertyValueFree(
+	fiftyoneDegreesIndicesPropertyValue* index) {
+	if (index->slots != NULL) {
+		Free(index->slots);
+	}
+	if (index->firstSlots != NULL) {
+		Free(index->firstSlots);
+	}
+	if (index->masks != NULL) {
+		Free(index->masks);
+	}
+	if (index->storedValueTypes != NULL) {
+		Free(index->storedValueTypes);
+	}
+	if (index->properties != NULL) {
+		Free(index->properties);
+	}
+	Free(index);
+}
+
+long fiftyoneDegreesIndicesPropertyValueLookup(
+	fiftyoneDegreesIndicesPropertyValue* index,
+	const fiftyoneDegreesCollection* values,
+	const fiftyoneDegreesCollection* strings,
+	uint32_t availablePropertyIndex,
+	const char* valueName,
+	fiftyoneDegreesException* exception) {
+	Item valueItem, nameItem;
+	const Value* value;
+	const StoredBinaryValue* content;
+	char buffer[MAX_INDEXED_VALUE_LENGTH];
+	StringBuilder builder = { buffer, sizeof(buffer) };
+	assert(availablePropertyIndex < index->availablePropertyCount);
+	const PropertyValueType storedValueType = 
+		index->storedValueTypes[availablePropertyIndex];
+	const uint32_t mask = index->masks[availablePropertyIndex];
+
+	// If the property has no values then there is nothing to find.
+	if ((int)index->properties[availablePropertyIndex].firstValueIndex == -1) {
+		return -1;
+	}
+
+	// If the property is not indexed then use the binary search.
+	if (mask == 0) {
+		return ValueGetIndexByNameAndType(
+			values,
+			strings,
+			&index->properties[availablePropertyIndex],
+			storedValueType,
+			valueName,
+			exception);
+	}
+
+	// Probe the hash table for the property verifying the name of any value 
+	// with the same hash.
+	const bool isString = 
+		storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING;
+	const uint32_t hash = StringHash(valueName, strlen(valueName));
+	StoredBinaryValueTarget target;
+	StoredBinaryValueTargetInit(&target, valueName);
+	const IndicesPropertyValueSlot* slots = 
+		index->slots + index->firstSlots[availablePropertyIndex];
+	DataReset(&valueItem.data);
+	DataReset(&nameItem.data);
+	for (uint32_t slot = hash & mask;
+		slots[slot].valueIndex != EMPTY_SLOT;
+		slot = (slot + 1) & mask) {
+		if (slots[slot].hash != hash) {
+			continue;
+		}
+		value = ValueGet(
+			values,
+			slots[slot].valueIndex,
+			&valueItem,
+			exception);
+		if (value == NULL || EXCEPTION_FAILED) {
+			return -1;
+		}
+		content = ValueGetContent(
+			strings,
+			value,
+			storedValueType,
+			&nameItem,
+			exception);
+		COLLECTION_RELEASE(values, &valueItem);
+		if (content == NULL || EXCEPTION_FAILED) {
+			return -1;
+		}
+		StringBuilderInit(&builder);
+		const int difference = StoredBinaryValueCompareWithTarget(
+			content,
+			storedValueType,
+			&target,
+			isString ? NULL : &builder,
+			exception);
+		COLLECTION_RELEASE(strings, &nameItem);
+		if (difference == 0 && EXCEPTION_OKAY) {
+			return (long)slots[slot].valueIndex;
+		}
+	}
+	return -1;
+}
@@ -58,6 +58,20 @@
   * data set. In most use cases the caller only requires a sub set of 
   * properties to be available for retrieval.
   * 
+  * ## Value Names
+  * 
+  * Values are also looked up by their name, for example when applying
+  * overrides or finding the profiles associated with a value. Without an
+  * index a binary search over the values of the property is needed with the
+  * value name being fetched, and possibly formatted, at every step. 
+  * fiftyoneDegreesIndicesPropertyValueCreate builds a hash table for each of
+  * the available properties that maps the value name to the value index so
+  * that a single probe, and one verification compare, is needed.
+  * 
+  * Only values where the text form is independent of the number of decimal
+  * places requested are indexed (strings, integers, bytes and IP addresses).
+  * Lookups for other stored types fall back to the binary search.
+  * 
   * ## Create
   * 
   * fiftyoneDegreesIndicesPropertyProfileCreate should be called once the data
@@ -163,6 +177,85 @@ EXTERNAL uint32_t fiftyoneDegreesIndicesPropertyProfileLookup(
 	uint32_t profileId,
 	uint32_t availablePropertyIndex);
 
+/**
+ * Single slot in the value name hash table of a property.
+ */
+typedef struct fiftyone_degrees_index_property_value_slot_t {
+	uint32_t hash; /**< Hash of the value name */
+	uint32_t valueIndex; /**< Index in the values collection, or UINT32_MAX if
+						 the slot is empty */
+} fiftyoneDegreesIndicesPropertyValueSlot;
+
+/**
+ * Maps the available property index and the name of a value to the index of
+ * the value in the values collection. Each available property has its own
+ * open addressing hash table within the slots array.
+ */
+typedef struct fiftyone_degrees_index_property_value_t {
+	fiftyoneDegreesIndicesPropertyValueSlot* slots; // all hash table slots
+	uint32_t* firstSlots; // first slot for each available property
+	uint32_t* masks; // slot count - 1 for each property, 0 if not indexed
+	fiftyoneDegreesPropertyValueType* storedValueTypes; // stored type for
+														// each property
+	fiftyoneDegreesProperty* properties; // copy of each available property
+										 // used when not indexed
+	uint32_t availablePropertyCount; // number of available properties
+	uint32_t size; // number of elements in the slots array
+	uint32_t filled; // number of slots with values
+} fiftyoneDegreesIndicesPropertyValue;
+
+/**
+ * Create an index for the values of the available properties such that the
+ * index of a value can be returned from the name by calling
+ * fiftyoneDegreesIndicesPropertyValueLookup.
+ * @param properties collection of all properties in the data set
+ * @param propertyTypes collection of property stored types, or NULL if all
+ * values are stored as strings
+ * @param values collection to be indexed
+ * @param strings collection containing the value names
+ * @param available properties provided by the caller
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h
+ * @return pointer to the index memory structure
+ */
+EXTERNAL fiftyoneDegreesIndicesPropertyValue*
+fiftyoneDegreesIndicesPropertyValueCreate(
+	fiftyoneDegreesCollection* properties,
+	fiftyoneDegreesCollection* propertyTypes,
+	fiftyoneDegreesCollection* values,
+	fiftyoneDegreesCollection* strings,
+	fiftyoneDegreesPropertiesAvailable* available,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Frees an index previously created by
+ * fiftyoneDegreesIndicesPropertyValueCreate.
+ * @param index to be freed
+ */
+EXTERNAL void fiftyoneDegreesIndicesPropertyValueFree(
+	fiftyoneDegreesIndicesPropertyValue* index);
+
+/**
+ * For a given available property index and value name returns the index of
+ * the value in the values collection. The values and strings collections must
+ * be the ones provided to fiftyoneDegreesIndicesPropertyValueCreate.
+ * @param index from fiftyoneDegreesIndicesPropertyValueCreate to use
+ * @param values collection containing the values
+ * @param strings collection containing the value names
+ * @param availablePropertyIndex in the list of required properties
+ * @param valueName name of the value to find
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h
+ * @return the 0 based index of the value if found, otherwise -1
+ */
+EXTERNAL long fiftyoneDegreesIndicesPropertyValueLookup(
+	fiftyoneDegreesIndicesPropertyValue* index,
+	const fiftyoneDegreesCollection* values,
+	const fiftyoneDegreesCollection* strings,
+	uint32_t availablePropertyIndex,
+	const char* valueName,
+	fiftyoneDegreesException* exception);
+
 /**
  * @}
  */
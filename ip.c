@@ -23,30 +23,6 @@
 #include "ip.h"
 #include "fiftyone.h"
 
-typedef void(*parseIterator)(
-	void *state,
-	IpType segmentType,
-	const char *start,
-	const char *end);
-
-/**
- * State is an integer which is increased every time the method is called.
- */
-static void callbackIpAddressCount(
-	void * const state,
-	const IpType segmentType,
-	const char * const start,
-	const char * const end) {
-	if (start <= end) {
-		if (segmentType != IP_TYPE_INVALID) {
-			(*(int*)state)++;
-			if (segmentType == IP_TYPE_IPV6) {
-				(*(int*)state)++;
-			}
-		}
-	}
-}
-
 /*
  * Make sure each byte in the Ipv4 or Ipv6 address
  * stays within the bound 0,255
@@ -65,269 +41,268 @@ static byte getIpByte(int parsedValue) {
 	return (byte)parsedValue;
 }
 
-typedef struct {
-	IpAddress * const address;
-	byte *current;
-	int bytesPresent;
-	int abbreviationsFilled;
-} fiftyoneDegreeIpAddressBuildState;
-typedef fiftyoneDegreeIpAddressBuildState IpAddressBuildState;
-
-static void parseIpV6Segment(
-	IpAddressBuildState * const buildState,
-	const char * const start,
-	const char * const end) {
-	int i;
-	char first[3], second[3], val; // "FF" + '\0'
-	if (start > end) {
-		// This is an abbreviation, so fill it in.
-		if (buildState->abbreviationsFilled) {
-			return;
-		}
-		buildState->abbreviationsFilled++;
-		for (i = 0; i < IPV6_LENGTH - buildState->bytesPresent; i++) {
-			*buildState->current = (byte)0;
-			buildState->current++;
-		}
-	}
-	else {
-		// Add the two bytes of the segment.
-		first[2] = '\0';
-		second[2] = '\0';
-		for (i = 0; i < IPV4_LENGTH; i++) {
-			if (end - i >= start) val = end[-i];
-			else val = '0';
-
-			if (i < 2) second[1 - i] = val;
-			else first[3 - i] = val;
-		}
-		*buildState->current = getIpByte((int)strtol(first, NULL, 16));
-		buildState->current++;
-		*buildState->current = getIpByte((int)strtol(second, NULL, 16));
-		buildState->current++;
+/*
+ * Returns true if the character marks the end of an IP address.
+ */
+static bool isAddressEnd(const char c) {
+	switch (c) {
+	case ',':
+	case ' ':
+	case ']':
+	case '/':
+	case '\0':
+	case '\n':
+		return true;
+	default:
+		return false;
 	}
 }
 
-static void callbackIpAddressBuild(
-	void * const state,
-	const IpType segmentType,
-	const char * const start,
-	const char * const end) {
-	fiftyoneDegreeIpAddressBuildState *const buildState = state;
-	if (segmentType == IP_TYPE_IPV4) {
-		*buildState->current = getIpByte(atoi(start));
-		buildState->current++;
+/*
+ * Returns the value of the hexadecimal character, or -1 if the character is
+ * not hexadecimal.
+ */
+static int getHexValue(const char c) {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
 	}
-	else if (segmentType == IP_TYPE_IPV6) {
-		parseIpV6Segment(buildState, start, end);
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
 	}
-}
-
-static IpType getIpTypeFromSeparator(const char separator) {
-	switch (separator) {
-		case '.':
-			return IP_TYPE_IPV4;
-		case ':':
-			return IP_TYPE_IPV6;
-		default:
-			return IP_TYPE_INVALID;
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
 	}
+	return -1;
 }
 
-static IpType getSegmentTypeWithSeparator(
-	const char separator,
-	const IpType ipType,
-	const IpType lastSeparatorType) {
-	switch (ipType) {
-		case IP_TYPE_IPV4:
-			return IP_TYPE_IPV4;
-		case IP_TYPE_IPV6:
-			switch (separator) {
-				case ':':
-					return IP_TYPE_IPV6;
-				case '.':
-					return IP_TYPE_IPV4;
-				default:
-					return lastSeparatorType;
+/*
+ * Parses four dotted decimal segments into the bytes provided. Segments can
+ * be up to three digits and values greater than 255 are limited to 255.
+ * @return the character after the last segment, or NULL if not valid
+ */
+static const char* parseIpV4(
+	const char *current,
+	const char * const end,
+	byte * const bytes) {
+	int segment, value, digits;
+	for (segment = 0; segment < IPV4_LENGTH; segment++) {
+		if (segment > 0) {
+			if (current >= end || *current != '.') {
+				return NULL;
 			}
-		default:
-			return getIpTypeFromSeparator(separator);
-	}
-}
-
-typedef enum {
-	FIFTYONE_DEGREES_IP_NON_BREAK_CHAR = 0,
-	FIFTYONE_DEGREES_IP_SEGMENT_BREAK_CHAR,
-	FIFTYONE_DEGREES_IP_ADDRESS_BREAK_CHAR,
-	FIFTYONE_DEGREES_IP_INVALID_CHAR,
-} IpStringSeparatorType;
-
-#define IP_NON_BREAK_CHAR FIFTYONE_DEGREES_IP_NON_BREAK_CHAR
-#define IP_SEGMENT_BREAK_CHAR FIFTYONE_DEGREES_IP_SEGMENT_BREAK_CHAR
-#define IP_ADDRESS_BREAK_CHAR FIFTYONE_DEGREES_IP_ADDRESS_BREAK_CHAR
-#define IP_INVALID_CHAR FIFTYONE_DEGREES_IP_INVALID_CHAR
-
-static IpStringSeparatorType getSeparatorCharType(
-	const char ipChar,
-	const IpType ipType) {
-
-	switch (ipChar) {
-		case ':':
-			return ((ipType == IP_TYPE_IPV4)
-				? IP_ADDRESS_BREAK_CHAR : IP_SEGMENT_BREAK_CHAR);
-		case '.':
-			return IP_SEGMENT_BREAK_CHAR;
-		case ',':
-		case ' ':
-		case ']':
-		case '/':
-		case '\0':
-		case '\n':
-			return IP_ADDRESS_BREAK_CHAR;
-		default:
-			break;
-	}
-	if ('0' <= ipChar && ipChar <= '9') {
-		return IP_NON_BREAK_CHAR;
-	}
-	if (('a' <= ipChar && ipChar <= 'f') || ('A' <= ipChar && ipChar <= 'F')) {
-		return (ipType == IP_TYPE_IPV4
-			? IP_INVALID_CHAR : IP_NON_BREAK_CHAR);
+			current++;
+		}
+		value = 0;
+		digits = 0;
+		while (current < end && *current >= '0' && *current <= '9') {
+			if (++digits > 3) {
+				return NULL;
+			}
+			value = value * 10 + (*current - '0');
+			current++;
+		}
+		if (digits == 0) {
+			return NULL;
+		}
+		bytes[segment] = getIpByte(value);
 	}
-	return IP_INVALID_CHAR;
-}
-
-static int8_t getMaxSegmentLengthForIpType(const IpType ipType) {
-	return (ipType == IP_TYPE_IPV4) ? 3 : 4; // "255" or "FFFF"
+	return current;
 }
 
-/**
- * Calls the callback method every time a byte is identified in the value
- * when parsed left to right.
+/*
+ * Parses colon separated groups of up to four hexadecimal characters into
+ * the bytes provided. A single :: abbreviation is expanded to the number of 
+ * zero bytes needed, and the last 32 bits can be an embedded dotted decimal 
+ * IPv4 address.
+ * @return the character after the address, or NULL if not valid
  */
-static IpType iterateIpAddress(
-	const char *start,
+static const char* parseIpV6(
+	const char *current,
 	const char * const end,
-	void * const state,
-	int * const springCount,
-	IpType type,
-	const parseIterator foundSegment) {
-
-	const char * const postEnd = end + 1;
-
-	*springCount = 0;
-	if (*start == '[') {
-		if (type == IP_TYPE_IPV4) {
-			return IP_TYPE_INVALID;
+	byte * const bytes) {
+	const char *group;
+	int count = 0, abbreviation = -1, value, digits, hex;
+
+	// A leading colon is only valid as part of an abbreviation.
+	if (current < end && *current == ':') {
+		if (current + 1 >= end || current[1] != ':') {
+			return NULL;
 		}
-		start++;
+		abbreviation = 0;
+		current += 2;
 	}
 
-	IpType currentSegmentType =
-		IP_TYPE_INVALID;
-
-	const char *current = start;
-	const char *nextSegment = current;
-	for (; current <= postEnd && nextSegment <= postEnd; ++current) {
-		char nextChar = 0;
-		if (current < postEnd) {
-			nextChar = *current;
-		}
-		IpStringSeparatorType separatorType =
-			getSeparatorCharType(nextChar, type);
-		if (!separatorType) {
-			continue;
+	while (current < end && isAddressEnd(*current) == false) {
+		group = current;
+		value = 0;
+		digits = 0;
+		while (current < end && (hex = getHexValue(*current)) >= 0) {
+			if (++digits > 4) {
+				return NULL;
+			}
+			value = (value << 4) | hex;
+			current++;
 		}
-		if (separatorType == IP_INVALID_CHAR) {
-			return IP_TYPE_INVALID;
+		if (digits == 0) {
+			return NULL;
 		}
 
-		currentSegmentType = getSegmentTypeWithSeparator(
-			nextChar, type, currentSegmentType);
-		if (type == IP_TYPE_INVALID) {
-			type = currentSegmentType;
+		// If the group is followed by a dot then it is the start of an
+		// embedded IPv4 address which must be the last part of the address.
+		if (current < end && *current == '.') {
+			if (count + IPV4_LENGTH > IPV6_LENGTH) {
+				return NULL;
+			}
+			current = parseIpV4(group, end, bytes + count);
+			if (current == NULL) {
+				return NULL;
+			}
+			count += IPV4_LENGTH;
+			break;
 		}
 
-		if (current - nextSegment > getMaxSegmentLengthForIpType(type)) {
-			return IP_TYPE_INVALID;
+		if (count + 2 > IPV6_LENGTH) {
+			return NULL;
 		}
+		bytes[count++] = (byte)(value >> 8);
+		bytes[count++] = (byte)(value & 0xFF);
 
-		// Check if it is leading abbreviation
-		if (current - 1 >= start) {
-			foundSegment(state, currentSegmentType,
-				nextSegment, current - 1);
+		if (current >= end || *current != ':') {
+			break;
 		}
-		if (separatorType == IP_ADDRESS_BREAK_CHAR) {
-			return type;
+		current++;
+		if (current < end && *current == ':') {
+			if (abbreviation >= 0) {
+				return NULL;
+			}
+			abbreviation = count;
+			current++;
 		}
-		if (current == nextSegment && current != start) {
-			++*springCount;
+		else if (current >= end || isAddressEnd(*current)) {
+			return NULL;
 		}
-		nextSegment = current + 1;
 	}
-	if (nextSegment < current
-		&& type != IP_TYPE_INVALID) {
 
-		foundSegment(state, currentSegmentType,
-			nextSegment, current - 1);
+	// Move the groups after the abbreviation to the end of the address and
+	// fill the gap with zeros. The abbreviation must stand for at least one
+	// group so it is invalid if all eight groups are present.
+	if (abbreviation >= 0) {
+		if (count == IPV6_LENGTH) {
+			return NULL;
+		}
+		memmove(
+			bytes + IPV6_LENGTH - (count - abbreviation),
+			bytes + abbreviation,
+			(size_t)(count - abbreviation));
+		memset(bytes + abbreviation, 0, (size_t)(IPV6_LENGTH - count));
+	}
+	else if (count != IPV6_LENGTH) {
+		return NULL;
+	}
+	return current;
+}
+
+/*
+ * Parses a single IP address between start and the character before end in a
+ * single pass. The type of address is determined from the first separator.
+ * IPv4 addresses can be followed by a port, and IPv6 addresses can be 
+ * enclosed in square brackets.
+ */
+static bool parseIpAddress(
+	const char *current,
+	const char * const end,
+	IpAddress * const address) {
+	byte bytes[IPV6_LENGTH];
+	const char *separator;
+
+	if (current < end && *current == '[') {
+		current++;
+	}
+
+	// Find the first separator to determine the type of address.
+	separator = current;
+	while (separator < end && getHexValue(*separator) >= 0) {
+		separator++;
+	}
+	if (separator >= end) {
+		return false;
+	}
+
+	switch (*separator) {
+	case '.':
+		current = parseIpV4(current, end, bytes);
+		if (current == NULL ||
+			(current < end && 
+				isAddressEnd(*current) == false && 
+				*current != ':')) {
+			return false;
+		}
+		memcpy(address->value, bytes, IPV4_LENGTH);
+		address->type = IP_TYPE_IPV4;
+		return true;
+	case ':':
+		current = parseIpV6(current, end, bytes);
+		if (current == NULL ||
+			(current < end && isAddressEnd(*current) == false)) {
+			return false;
+		}
+		memcpy(address->value, bytes, IPV6_LENGTH);
+		address->type = IP_TYPE_IPV6;
+		return true;
+	default:
+		return false;
 	}
-	return type;
 }
 
 bool fiftyoneDegreesIpAddressParse(
 	const char * const start,
 	const char * const end,
 	IpAddress * const address) {
-
 	if (!start) {
 		return false;
 	}
+	return parseIpAddress(start, end + 1, address);
+}
 
-	int byteCount = 0;
-	int springCount = 0;
-	IpType type = iterateIpAddress(
-		start,
-		end,
-		&byteCount,
-		&springCount,
-		IP_TYPE_INVALID,
-		callbackIpAddressCount);
-
-	switch (type) {
-		case IP_TYPE_IPV4:
-			if (byteCount != IPV4_LENGTH || springCount) {
-				return false;
-			}
-			break;
-		case IP_TYPE_IPV6:
-			if (byteCount > IPV6_LENGTH ||
-				springCount > 1 ||
-				(byteCount < IPV6_LENGTH && !springCount)) {
-				return false;
-			}
-			break;
-		default:
-			return false;
+uint32_t fiftyoneDegreesIpAddressesParse(
+	const char * const start,
+	const char * const end,
+	IpAddress * const addresses,
+	const uint32_t capacity) {
+	const char *current = start, *next, *last;
+	const char * const postEnd = end + 1;
+	uint32_t count = 0;
+	if (!start) {
+		return 0;
 	}
+	while (current < postEnd && *current != '\0' && count < capacity) {
 
-	address->type = type;
-	IpAddressBuildState buildState = {
-		address,
-		address->value,
-		byteCount,
-		0,
-	};
+		// Find the end of the address and the start of the next one.
+		next = current;
+		while (next < postEnd && *next != ',' && *next != '\0') {
+			next++;
+		}
 
-	// Add the bytes from the source value and get the type of address.
-	iterateIpAddress(
-		start,
-		end,
-		&buildState,
-		&springCount,
-		type,
-		callbackIpAddressBuild);
+		// Trim white space either side of the address.
+		last = next;
+		while (current < last && (*current == ' ' || *current == '\t')) {
+			current++;
+		}
+		while (last > current && (last[-1] == ' ' || last[-1] == '\t')) {
+			last--;
+		}
 
-	return true;
+		// Add the address marking it as invalid if it can't be parsed so that
+		// the position of each address is retained.
+		if (current < last) {
+			if (parseIpAddress(current, last, &addresses[count]) == false) {
+				addresses[count].type = IP_TYPE_INVALID;
+			}
+			count++;
+		}
+		current = next < postEnd && *next == ',' ? next + 1 : postEnd;
+	}
+	return count;
 }
 
 int fiftyoneDegreesIpAddressesCompare(
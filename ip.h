@@ -33,6 +33,9 @@
  *
  * IP v4 and v6 addresses can be parsed using the
  * #fiftyoneDegreesIpAddressParse and #fiftyoneDegreesIpAddressesParse methods.
+ * Both parse the characters in a single pass without any intermediate 
+ * buffers. IPv6 addresses can contain a single :: abbreviation and end with 
+ * an embedded dotted decimal IPv4 address.
  *
  * @{
  */
@@ -84,6 +87,26 @@ EXTERNAL bool fiftyoneDegreesIpAddressParse(
 	const char *end,
 	fiftyoneDegreesIpAddress *address);
 
+/**
+ * Parse a comma separated list of IP addresses, for example the value of an
+ * X-Forwarded-For header, into the array provided in a single pass. White
+ * space around each address is ignored and empty entries are skipped. An
+ * entry which is not a valid address is added with the type
+ * #FIFTYONE_DEGREES_IP_TYPE_INVALID so that the position of each address in
+ * the list is retained. Parsing stops when the capacity is reached or a null
+ * character is found.
+ * @param start of the string containing the IP addresses to parse
+ * @param end the last character of the string to be considered for parsing
+ * @param addresses array to write the parsed IP addresses into
+ * @param capacity number of elements in the addresses array
+ * @return the number of addresses written to the array
+ */
+EXTERNAL uint32_t fiftyoneDegreesIpAddressesParse(
+	const char *start,
+	const char *end,
+	fiftyoneDegreesIpAddress *addresses,
+	uint32_t capacity);
+
 /**
  * Compare two IP addresses in its binary form
  * @param ipAddress1 the first IP address
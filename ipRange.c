@@ -0,0 +1,367 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "ipRange.h"
+
+#include "collectionKeyTypes.h"
+#include "fiftyone.h"
+
+MAP_TYPE(Collection)
+
+#define BLOCK_SIZE FIFTYONE_DEGREES_IP_RANGE_INDEX_BLOCK_SIZE
+#define MAX_LEVELS FIFTYONE_DEGREES_IP_RANGE_INDEX_MAX_LEVELS
+
+// Marker at the start of every image used to detect memory that does not
+// contain an image, or an image created with a different byte order.
+#define IMAGE_MARKER 0x51DE1A01
+
+// Header in the first block of the image.
+typedef struct image_header_t {
+	uint32_t marker; // IMAGE_MARKER
+	uint32_t type; // type of IP address
+	uint32_t count; // number of ranges
+	uint32_t levelCount; // number of levels
+} imageHeader;
+
+// IPv6 key held as two integers so that it can be compared without a loop.
+typedef struct ipv6_key_t {
+	uint64_t high; // first 8 bytes of the address
+	uint64_t low; // last 8 bytes of the address
+} ipv6Key;
+
+// Number of bytes used for a key of the type, or 0 if the type is not valid.
+static uint32_t getKeySize(IpType type) {
+	switch (type) {
+	case FIFTYONE_DEGREES_IP_TYPE_IPV4: return sizeof(uint32_t);
+	case FIFTYONE_DEGREES_IP_TYPE_IPV6: return sizeof(ipv6Key);
+	default: return 0;
+	}
+}
+
+// Rounds the number of bytes up to a whole number of blocks.
+static size_t getBlockAligned(size_t size) {
+	return (size + BLOCK_SIZE - 1) & ~(size_t)(BLOCK_SIZE - 1);
+}
+
+// Sets the number of keys and the offset from the start of the image of each
+// level, returning the total size of the image. Each level contains the first
+// key of every block in the level below until a level fits in one block.
+static size_t getLayout(
+	uint32_t keySize,
+	uint32_t count,
+	uint32_t *levelCount,
+	uint32_t *lengths,
+	size_t *offsets) {
+	uint32_t keysPerBlock = BLOCK_SIZE / keySize;
+	size_t size = getBlockAligned(sizeof(imageHeader));
+	uint32_t length = count;
+	*levelCount = 0;
+	while (length > 0 && *levelCount < MAX_LEVELS) {
+		lengths[*levelCount] = length;
+		offsets[*levelCount] = size;
+		size += getBlockAligned((size_t)length * keySize);
+		(*levelCount)++;
+		if (length <= keysPerBlock) {
+			break;
+		}
+		length = (length + keysPerBlock - 1) / keysPerBlock;
+	}
+	return size;
+}
+
+static uint32_t getIpv4Key(const unsigned char *ipAddress) {
+	return ((uint32_t)ipAddress[0] << 24) |
+		((uint32_t)ipAddress[1] << 16) |
+		((uint32_t)ipAddress[2] << 8) |
+		(uint32_t)ipAddress[3];
+}
+
+static uint64_t getUInt64(const unsigned char *bytes) {
+	uint64_t value = 0;
+	for (int i = 0; i < 8; i++) {
+		value = (value << 8) | bytes[i];
+	}
+	return value;
+}
+
+static ipv6Key getIpv6Key(const unsigned char *ipAddress) {
+	ipv6Key key;
+	key.high = getUInt64(ipAddress);
+	key.low = getUInt64(ipAddress + 8);
+	return key;
+}
+
+// Sets the levels and lengths of the index from the image memory.
+static void setLevels(
+	IpRangeIndex *index,
+	const uint32_t *lengths,
+	const size_t *offsets) {
+	for (uint32_t i = 0; i < index->levelCount; i++) {
+		index->levels[i] = index->memory + offsets[i];
+		index->lengths[i] = lengths[i];
+	}
+}
+
+// Copies the first key of each block of the level below into each of the
+// levels above the bottom level.
+static void fillUpperLevels(IpRangeIndex *index, uint32_t keySize) {
+	uint32_t keysPerBlock = BLOCK_SIZE / keySize;
+	for (uint32_t l = 1; l < index->levelCount; l++) {
+		byte *level = (byte*)index->levels[l];
+		const byte *below = index->levels[l - 1];
+		for (uint32_t i = 0; i < index->lengths[l]; i++) {
+			memcpy(
+				level + (size_t)i * keySize,
+				below + (size_t)i * keysPerBlock * keySize,
+				keySize);
+		}
+	}
+}
+
+// Reads the first IP address of each range into the bottom level checking
+// that the ranges are in ascending order.
+static void fillBottomLevel(
+	IpRangeIndex *index,
+	const Collection *ranges,
+	uint32_t startOffset,
+	Exception *exception) {
+	Item item;
+	const unsigned char *start;
+	unsigned char previous[FIFTYONE_DEGREES_IPV6_LENGTH];
+	uint32_t length = index->type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+		FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+	byte *level = (byte*)index->levels[0];
+	CollectionKey key = {
+		0,
+		CollectionKeyType_Unsupported, // not used for fixed size collections
+	};
+	DataReset(&item.data);
+	for (uint32_t i = 0; i < index->count && EXCEPTION_OKAY; i++) {
+		key.indexOrOffset.offset = i;
+		start = (const unsigned char*)ranges->get(
+			ranges,
+			&key,
+			&item,
+			exception);
+		if (start == NULL || EXCEPTION_FAILED) {
+			return;
+		}
+		start += startOffset;
+		if (i > 0 &&
+			IpAddressesCompare(start, previous, index->type) < 0) {
+			EXCEPTION_SET(CORRUPT_DATA);
+		}
+		else if (index->type == FIFTYONE_DEGREES_IP_TYPE_IPV4) {
+			((uint32_t*)level)[i] = getIpv4Key(start);
+		}
+		else {
+			((ipv6Key*)level)[i] = getIpv6Key(start);
+		}
+		memcpy(previous, start, length);
+		COLLECTION_RELEASE(ranges, &item);
+	}
+}
+
+static long lookupIpv4(const IpRangeIndex *index, uint32_t ip) {
+	const uint32_t keysPerBlock = BLOCK_SIZE / sizeof(uint32_t);
+	uint32_t entry = 0, first, last, matched;
+	const uint32_t *keys;
+	for (uint32_t l = index->levelCount; l > 0; l--) {
+		keys = (const uint32_t*)index->levels[l - 1];
+		first = entry * keysPerBlock;
+		last = first + keysPerBlock;
+		if (last > index->lengths[l - 1]) {
+			last = index->lengths[l - 1];
+		}
+
+		// Count the keys in the block that are less than or equal to the IP
+		// without branching so that the compiler can vectorise the scan.
+		matched = 0;
+		for (uint32_t i = first; i < last; i++) {
+			matched += keys[i] <= ip;
+		}
+		if (matched == 0) {
+			return -1;
+		}
+		entry = first + matched - 1;
+	}
+	return (long)entry;
+}
+
+static long lookupIpv6(const IpRangeIndex *index, ipv6Key ip) {
+	const uint32_t keysPerBlock = BLOCK_SIZE / sizeof(ipv6Key);
+	uint32_t entry = 0, first, last, matched;
+	const ipv6Key *keys;
+	for (uint32_t l = index->levelCount; l > 0; l--) {
+		keys = (const ipv6Key*)index->levels[l - 1];
+		first = entry * keysPerBlock;
+		last = first + keysPerBlock;
+		if (last > index->lengths[l - 1]) {
+			last = index->lengths[l - 1];
+		}
+		matched = 0;
+		for (uint32_t i = first; i < last; i++) {
+			matched += (keys[i].high < ip.high) |
+				((keys[i].high == ip.high) & (keys[i].low <= ip.low));
+		}
+		if (matched == 0) {
+			return -1;
+		}
+		entry = first + matched - 1;
+	}
+	return (long)entry;
+}
+
+size_t fiftyoneDegreesIpRangeIndexSize(IpType type, uint32_t count) {
+	uint32_t levelCount;
+	uint32_t lengths[MAX_LEVELS];
+	size_t offsets[MAX_LEVELS];
+	uint32_t keySize = getKeySize(type);
+	if (keySize == 0) {
+		return 0;
+	}
+	return getLayout(keySize, count, &levelCount, lengths, offsets);
+}
+
+fiftyoneDegreesIpRangeIndex* fiftyoneDegreesIpRangeIndexCreate(
+	const fiftyoneDegreesCollection *ranges,
+	uint32_t count,
+	uint32_t startOffset,
+	fiftyoneDegreesIpType type,
+	fiftyoneDegreesException *exception) {
+	uint32_t lengths[MAX_LEVELS];
+	size_t offsets[MAX_LEVELS];
+	imageHeader *header;
+	IpRangeIndex *index;
+	uint32_t keySize = getKeySize(type);
+	uint32_t length = type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+		FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+
+	// The ranges must be fixed size and contain the whole IP address.
+	if (keySize == 0 ||
+		ranges->elementSize == 0 ||
+		(uint64_t)startOffset + length > ranges->elementSize) {
+		EXCEPTION_SET(INVALID_INPUT);
+		return NULL;
+	}
+
+	index = (IpRangeIndex*)Malloc(sizeof(IpRangeIndex));
+	if (index == NULL) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return NULL;
+	}
+	index->type = type;
+	index->count = count;
+	index->size = getLayout(
+		keySize,
+		count,
+		&index->levelCount,
+		lengths,
+		offsets);
+	index->memoryToFree = MallocAligned(BLOCK_SIZE, index->size);
+	if (index->memoryToFree == NULL) {
+		Free(index);
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return NULL;
+	}
+	memset(index->memoryToFree, 0, index->size);
+	index->memory = (const byte*)index->memoryToFree;
+	header = (imageHeader*)index->memoryToFree;
+	header->marker = IMAGE_MARKER;
+	header->type = (uint32_t)type;
+	header->count = count;
+	header->levelCount = index->levelCount;
+	setLevels(index, lengths, offsets);
+
+	fillBottomLevel(index, ranges, startOffset, exception);
+	if (EXCEPTION_FAILED) {
+		IpRangeIndexFree(index);
+		return NULL;
+	}
+	fillUpperLevels(index, keySize);
+	return index;
+}
+
+fiftyoneDegreesIpRangeIndex* fiftyoneDegreesIpRangeIndexCreateFromMemory(
+	const void *memory,
+	size_t size,
+	fiftyoneDegreesException *exception) {
+	uint32_t levelCount;
+	uint32_t lengths[MAX_LEVELS];
+	size_t offsets[MAX_LEVELS];
+	uint32_t keySize;
+	size_t required;
+	const imageHeader *header = (const imageHeader*)memory;
+	IpRangeIndex *index;
+
+	// Check the memory contains a complete image before using it.
+	if (memory == NULL ||
+		((uintptr_t)memory % sizeof(uint64_t)) != 0 ||
+		size < sizeof(imageHeader) ||
+		header->marker != IMAGE_MARKER) {
+		EXCEPTION_SET(CORRUPT_DATA);
+		return NULL;
+	}
+	keySize = getKeySize((IpType)header->type);
+	if (keySize == 0) {
+		EXCEPTION_SET(CORRUPT_DATA);
+		return NULL;
+	}
+	required = getLayout(keySize, header->count, &levelCount, lengths, offsets);
+	if (required > size || levelCount != header->levelCount) {
+		EXCEPTION_SET(CORRUPT_DATA);
+		return NULL;
+	}
+
+	index = (IpRangeIndex*)Malloc(sizeof(IpRangeIndex));
+	if (index == NULL) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return NULL;
+	}
+	index->memory = (const byte*)memory;
+	index->size = required;
+	index->memoryToFree = NULL;
+	index->type = (IpType)header->type;
+	index->count = header->count;
+	index->levelCount = levelCount;
+	setLevels(index, lengths, offsets);
+	return index;
+}
+
+void fiftyoneDegreesIpRangeIndexFree(fiftyoneDegreesIpRangeIndex *index) {
+	if (index->memoryToFree != NULL) {
+		FreeAligned(index->memoryToFree);
+	}
+	Free(index);
+}
+
+long fiftyoneDegreesIpRangeIndexLookup(
+	const fiftyoneDegreesIpRangeIndex *index,
+	const unsigned char *ipAddress) {
+	if (index->levelCount == 0) {
+		return -1;
+	}
+	if (index->type == FIFTYONE_DEGREES_IP_TYPE_IPV4) {
+		return lookupIpv4(index, getIpv4Key(ipAddress));
+	}
+	return lookupIpv6(index, getIpv6Key(ipAddress));
+}
@@ -0,0 +1,207 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_IP_RANGE_H_INCLUDED
+#define FIFTYONE_DEGREES_IP_RANGE_H_INCLUDED
+
+/**
+ * @ingroup FiftyOneDegreesCommon
+ * @defgroup FiftyOneDegreesIpRange IP Range
+ *
+ * A look up structure for the range containing an IP address.
+ *
+ * ## Introduction
+ *
+ * Data sets that relate IP addresses to results store a collection of fixed
+ * size ranges ordered by the first IP address of the range. Without an index
+ * finding the range for an IP address needs a binary search of the collection
+ * where every step fetches an item and compares the address bytes with
+ * #fiftyoneDegreesIpAddressesCompare. Each step is likely to be a cache miss.
+ *
+ * The IP range index is a static B+ tree, or cache-blocked sorted prefix
+ * index, of the first IP address of each range. IPv4 addresses are held as
+ * 32 bit integers and IPv6 addresses as a pair of 64 bit integers so that a
+ * single integer comparison replaces the byte comparison.
+ *
+ * ## Structure
+ *
+ * The bottom level of the index contains the first address of every range in
+ * ascending order. Each level above contains the first address of every block
+ * of the level below, where a block is a single 64 byte cache line (16 IPv4 or
+ * 4 IPv6 addresses). Levels are added until the top level fits into a single
+ * block. A lookup scans the top block, then the one block of each level below
+ * indicated by the previous scan. Therefore a lookup costs one cache line per
+ * level, which is 5 for a million IPv4 ranges, and the top levels are likely
+ * to remain in the cache between lookups.
+ *
+ * All the levels are held in a single contiguous block of memory, the image,
+ * where every level starts on a 64 byte boundary. The image uses the native
+ * byte order of the machine that created it.
+ *
+ * ## Create
+ *
+ * fiftyoneDegreesIpRangeIndexCreate reads the first address of each range
+ * from a fixed size collection, verifies that the ranges are in ascending
+ * order, and builds the image in memory allocated by the method. This should
+ * be called during data set initialization.
+ *
+ * ## Memory Mapped
+ *
+ * The image of an index can be written to a file using the memory and size
+ * fields of the index. fiftyoneDegreesIpRangeIndexCreateFromMemory validates
+ * an image that was created previously, for example from a memory mapped
+ * file, and uses it in place without copying. The caller remains responsible
+ * for the image memory which must not be released until the index is freed.
+ *
+ * ## Lookup
+ *
+ * fiftyoneDegreesIpRangeIndexLookup returns the index of the last range with
+ * a first address less than or equal to the address provided. The caller is
+ * expected to fetch the range and check the end address if the ranges do not
+ * cover the whole address space.
+ *
+ * ## Free
+ *
+ * fiftyoneDegreesIpRangeIndexFree releases the index and any image memory it
+ * allocated.
+ *
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "data.h"
+#include "exceptions.h"
+#include "collection.h"
+#include "ip.h"
+#include "common.h"
+
+/**
+ * The number of bytes in each block of the index. Matches the size of a cache
+ * line on common hardware.
+ */
+#define FIFTYONE_DEGREES_IP_RANGE_INDEX_BLOCK_SIZE 64
+
+/**
+ * Maximum number of levels an index can contain. Sufficient for UINT32_MAX
+ * IPv6 ranges which have the smallest number of keys per block.
+ */
+#define FIFTYONE_DEGREES_IP_RANGE_INDEX_MAX_LEVELS 17
+
+/**
+ * Index used to find the range containing an IP address. See the group
+ * description for details of the structure.
+ */
+typedef struct fiftyone_degrees_ip_range_index_t {
+	const byte *memory; /**< Start of the image containing the levels */
+	size_t size; /**< Number of bytes in the image */
+	void *memoryToFree; /**< Image memory to free with the index, or NULL if
+						the image is owned by the caller */
+	fiftyoneDegreesIpType type; /**< Type of IP address in the index */
+	uint32_t count; /**< Number of ranges in the index */
+	uint32_t levelCount; /**< Number of levels in the index */
+	const byte *levels[FIFTYONE_DEGREES_IP_RANGE_INDEX_MAX_LEVELS]; /**< First
+																	key of each
+																	level where
+																	0 is the
+																	bottom */
+	uint32_t lengths[FIFTYONE_DEGREES_IP_RANGE_INDEX_MAX_LEVELS]; /**< Number
+																   of keys in
+																   each level */
+} fiftyoneDegreesIpRangeIndex;
+
+/**
+ * Returns the number of bytes needed for the image of an index containing the
+ * number of ranges provided.
+ * @param type of IP address in the ranges
+ * @param count number of ranges
+ * @return size of the image in bytes, or 0 if the type is not valid
+ */
+EXTERNAL size_t fiftyoneDegreesIpRangeIndexSize(
+	fiftyoneDegreesIpType type,
+	uint32_t count);
+
+/**
+ * Create an index for the ranges in the fixed size collection provided such
+ * that the range containing an IP address can be found by calling
+ * fiftyoneDegreesIpRangeIndexLookup. The ranges must be in ascending order of
+ * first IP address.
+ * @param ranges fixed size collection of ranges to be indexed
+ * @param count number of ranges in the collection
+ * @param startOffset byte offset of the first IP address within each range
+ * @param type of IP address in the ranges
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h
+ * @return pointer to the index memory structure, or NULL if the index could
+ * not be created
+ */
+EXTERNAL fiftyoneDegreesIpRangeIndex* fiftyoneDegreesIpRangeIndexCreate(
+	const fiftyoneDegreesCollection *ranges,
+	uint32_t count,
+	uint32_t startOffset,
+	fiftyoneDegreesIpType type,
+	fiftyoneDegreesException *exception);
+
+/**
+ * Create an index that uses the image of an index created previously by
+ * fiftyoneDegreesIpRangeIndexCreate. The image is validated but not copied so
+ * must remain available until the index is freed. Used with memory mapped
+ * files.
+ * @param memory start of the image, aligned to 8 bytes or more
+ * @param size number of bytes available in the memory
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h
+ * @return pointer to the index memory structure, or NULL if the image is not
+ * valid
+ */
+EXTERNAL fiftyoneDegreesIpRangeIndex*
+fiftyoneDegreesIpRangeIndexCreateFromMemory(
+	const void *memory,
+	size_t size,
+	fiftyoneDegreesException *exception);
+
+/**
+ * Frees an index previously created by fiftyoneDegreesIpRangeIndexCreate or
+ * fiftyoneDegreesIpRangeIndexCreateFromMemory.
+ * @param index to be freed
+ */
+EXTERNAL void fiftyoneDegreesIpRangeIndexFree(
+	fiftyoneDegreesIpRangeIndex *index);
+
+/**
+ * For a given IP address returns the index of the last range in the
+ * collection used to create the index with a first IP address less than or
+ * equal to the address.
+ * @param index from fiftyoneDegreesIpRangeIndexCreate to use
+ * @param ipAddress bytes of the IP address of the same type as the index
+ * @return the 0 based index of the range, or -1 if the address is before the
+ * first range
+ */
+EXTERNAL long fiftyoneDegreesIpRangeIndexLookup(
+	const fiftyoneDegreesIpRangeIndex *index,
+	const unsigned char *ipAddress);
+
+/**
+ * @}
+ */
+
+#endif
@@ -23,44 +23,151 @@
 #include "json.h"
 #include "fiftyone.h"
 
-// Add two characters to the buffer if space is available.
-static void addTwo(fiftyoneDegreesJson* s, char a, char b) {
-	StringBuilderAddChar(&s->builder, a);
-	StringBuilderAddChar(&s->builder, b);
+MAP_TYPE(Collection)
+
+/*
+ * Select the vector instructions used to find characters that need escaping.
+ * SSE2 is always available on 64 bit x86 and NEON on 64 bit ARM. Defining
+ * FIFTYONE_DEGREES_JSON_NO_SIMD uses the scalar method only.
+ */
+#ifndef FIFTYONE_DEGREES_JSON_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define JSON_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+// Number of characters checked at a time by the vector instructions.
+#define JSON_WIDTH 16
+
+// Characters used for the short escape of each character up to the reverse
+// solidus, or 0 if the character must be escaped as a unicode code point.
+static const char shortEscapes[0x60] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 'b', 't', 'n', 0, 'f', 'r', 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, '\"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0 };
+
+// True if the character must be escaped in a JSON string.
+static bool needsEscape(char c) {
+	return c == '\"' || c == '\\' || (unsigned char)c < 0x20;
+}
+
+#ifdef JSON_SSE2
+
+// Returns a bit for each of the 16 characters that needs to be escaped.
+static uint32_t escapeMask(const char *value) {
+	__m128i v = _mm_loadu_si128((const __m128i*)value);
+	__m128i control = _mm_cmpeq_epi8(
+		_mm_max_epu8(v, _mm_set1_epi8(0x1F)),
+		_mm_set1_epi8(0x1F));
+	__m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('\"'));
+	__m128i solidus = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+	return (uint32_t)_mm_movemask_epi8(
+		_mm_or_si128(control, _mm_or_si128(quote, solidus)));
+}
+
+#elif defined(JSON_NEON)
+
+// Returns true if any of the 16 characters needs to be escaped.
+static bool escapeAny(const char *value) {
+	uint8x16_t v = vld1q_u8((const uint8_t*)value);
+	uint8x16_t found = vorrq_u8(
+		vcltq_u8(v, vdupq_n_u8(0x20)),
+		vorrq_u8(
+			vceqq_u8(v, vdupq_n_u8('\"')),
+			vceqq_u8(v, vdupq_n_u8('\\'))));
+	return vget_lane_u64(vreinterpret_u64_u8(
+		vshrn_n_u16(vreinterpretq_u16_u8(found), 4)), 0) != 0;
 }
 
-// Adds a string of characters escaping special characters.
+#endif
+
+// Returns the number of characters at the start of the value that can be
+// copied without escaping. Whole vectors are checked at a time where
+// available and never read beyond the length of the value.
+static size_t getCleanLength(const char *value, size_t length) {
+	size_t i = 0;
+#ifdef JSON_SSE2
+	uint32_t mask;
+	for (; i + JSON_WIDTH <= length; i += JSON_WIDTH) {
+		mask = escapeMask(value + i);
+		if (mask != 0) {
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return i + index;
+#else
+			return i + (size_t)__builtin_ctz(mask);
+#endif
+		}
+	}
+#elif defined(JSON_NEON)
+	while (i + JSON_WIDTH <= length && escapeAny(value + i) == false) {
+		i += JSON_WIDTH;
+	}
+#endif
+	while (i < length && needsEscape(value[i]) == false) {
+		i++;
+	}
+	return i;
+}
+
+// Adds the escape sequence for the character.
+static void addEscape(fiftyoneDegreesJson* s, char c) {
+	static const char hex[] = "0123456789abcdef";
+	char escape[6] = {
+		'\\', shortEscapes[(unsigned char)c], '0', '0', '0', '0' };
+	if (escape[1] != 0) {
+		StringBuilderAddChars(&s->builder, escape, 2);
+	}
+	else {
+		escape[1] = 'u';
+		escape[4] = hex[((unsigned char)c >> 4) & 0x0F];
+		escape[5] = hex[(unsigned char)c & 0x0F];
+		StringBuilderAddChars(&s->builder, escape, sizeof(escape));
+	}
+}
+
+// Adds a string of characters escaping special characters. Runs of 
+// characters that do not need escaping are added with a single copy.
 static void addStringEscape(
 	fiftyoneDegreesJson* s,
 	const char* value,
 	size_t valueLength) {
-	for (size_t i = 0; i < valueLength; i++) {
-		switch (value[i]) {
-		case '\"':
-			addTwo(s, '\\', '\"');
-			break;
-		case '\b':
-			addTwo(s, '\\', 'b');
-			break;
-		case '\f':
-			addTwo(s, '\\', 'f');
-			break;
-		case '\n':
-			addTwo(s, '\\', 'n');
-			break;
-		case '\r':
-			addTwo(s, '\\', 'r');
-			break;
-		case '\t':
-			addTwo(s, '\\', 't');
-			break;
-		default:
-			StringBuilderAddChar(&s->builder, value[i]);
-			break;
+	size_t clean;
+	size_t i = 0;
+	while (i < valueLength) {
+		clean = getCleanLength(value + i, valueLength - i);
+		if (clean > 0) {
+			StringBuilderAddChars(&s->builder, value + i, clean);
+			i += clean;
+		}
+		if (i < valueLength) {
+			addEscape(s, value[i]);
+			i++;
 		}
 	}
 }
 
+// True if values of the stored type are written as GeoJSON objects.
+static bool isGeoJson(
+	const fiftyoneDegreesJson * const s,
+	const PropertyValueType storedValueType) {
+	return s->geometryAsGeoJson && (
+		storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB ||
+		storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB_R);
+}
+
 /**
  * Adds a binary including surrounding double quotes and escaping special
  * characters.
@@ -74,6 +181,17 @@ static void addValueContents(
 	const PropertyValueType storedValueType) {
 
 	Exception * const exception = s->exception;
+	if (isGeoJson(s, storedValueType)) {
+		WriteWkbAsGeoJsonToStringBuilder(
+			&binaryValue->byteArrayValue.firstByte,
+			storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB_R ?
+				FIFTYONE_DEGREES_WKBToT_REDUCTION_SHORT :
+				FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+			MAX_DOUBLE_DECIMAL_PLACES,
+			&s->builder,
+			exception);
+		return;
+	}
 	StringBuilderAddChar(&s->builder, '\"');
 	if (storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
 		addStringEscape(
@@ -100,6 +218,39 @@ static void addSeparator(fiftyoneDegreesJson* s) {
 	StringBuilderAddChar(&s->builder, ',');
 }
 
+// Marks a slot in the property name hash table as empty.
+#define EMPTY_SLOT UINT32_MAX
+
+// Spreads the name offsets across the slots of the hash table.
+static uint32_t hashNameOffset(uint32_t nameOffset) {
+	return nameOffset * 2654435761u;
+}
+
+// Returns the rendered property name for the name offset, or NULL if the
+// property was not rendered.
+static const JsonFragment* getNameFragment(
+	const JsonFragments* fragments,
+	uint32_t nameOffset) {
+	uint32_t slot = hashNameOffset(nameOffset) & fragments->namesMask;
+	while (fragments->names[slot].nameOffset != EMPTY_SLOT) {
+		if (fragments->names[slot].nameOffset == nameOffset) {
+			return &fragments->names[slot].fragment;
+		}
+		slot = (slot + 1) & fragments->namesMask;
+	}
+	return NULL;
+}
+
+// Adds the characters of the fragment.
+static void addFragment(
+	fiftyoneDegreesJson* s,
+	const JsonFragment* fragment) {
+	StringBuilderAddChars(
+		&s->builder,
+		s->fragments->text + fragment->offset,
+		fragment->length);
+}
+
 void fiftyoneDegreesJsonDocumentStart(fiftyoneDegreesJson* s) {
 	StringBuilderInit(&s->builder);
 	StringBuilderAddChar(&s->builder, '{');
@@ -126,6 +277,17 @@ void fiftyoneDegreesJsonPropertyStart(fiftyoneDegreesJson* s) {
 		return;
 	}
 
+	// Copy the pre-rendered property name if available.
+	if (s->fragments != NULL) {
+		const JsonFragment* fragment = getNameFragment(
+			s->fragments,
+			s->property->nameOffset);
+		if (fragment != NULL) {
+			addFragment(s, fragment);
+			return;
+		}
+	}
+
 	// Get the property name as a string.
 	fiftyoneDegreesDataReset(&stringItem.data);
 	name = fiftyoneDegreesStoredBinaryValueGet(
@@ -191,3 +353,271 @@ void fiftyoneDegreesJsonPropertyValues(fiftyoneDegreesJson* s) {
 		}
 	}
 }
+
+// Adds the value at the value index fetching and rendering it from the
+// values collection.
+static void addValueIndex(fiftyoneDegreesJson* s, uint32_t valueIndex) {
+	Item valueItem, contentItem;
+	const StoredBinaryValue* content;
+	Exception* exception = s->exception;
+	DataReset(&valueItem.data);
+	DataReset(&contentItem.data);
+	const Value* value = ValueGet(
+		s->fragments->valuesCollection,
+		valueIndex,
+		&valueItem,
+		exception);
+	if (value == NULL || EXCEPTION_FAILED) {
+		return;
+	}
+	content = ValueGetContent(
+		s->strings,
+		value,
+		s->storedPropertyType,
+		&contentItem,
+		exception);
+	if (content != NULL && EXCEPTION_OKAY) {
+		addValueContents(s, content, s->storedPropertyType);
+		COLLECTION_RELEASE(s->strings, &contentItem);
+	}
+	COLLECTION_RELEASE(s->fragments->valuesCollection, &valueItem);
+}
+
+void fiftyoneDegreesJsonPropertyValueIndexes(
+	fiftyoneDegreesJson* s,
+	const uint32_t* valueIndexes,
+	uint32_t count) {
+	Exception* exception = s->exception;
+	if (s->fragments == NULL || valueIndexes == NULL) {
+		EXCEPTION_SET(NULL_POINTER);
+		return;
+	}
+	for (uint32_t i = 0; i < count && EXCEPTION_OKAY; i++) {
+		if (i > 0) {
+			addSeparator(s);
+		}
+		if (valueIndexes[i] < s->fragments->valuesCount &&
+			s->fragments->values[valueIndexes[i]].length > 0 &&
+			isGeoJson(s, s->storedPropertyType) == false) {
+			addFragment(s, &s->fragments->values[valueIndexes[i]]);
+		}
+		else {
+			addValueIndex(s, valueIndexes[i]);
+		}
+	}
+}
+
+// Records the position of the characters added to the builder since the
+// start as the fragment if the fragments are being recorded.
+static void setFragment(
+	JsonFragment* fragment,
+	const StringBuilder* builder,
+	size_t start) {
+	if (fragment != NULL) {
+		fragment->offset = (uint32_t)start;
+		fragment->length = (uint32_t)(builder->added - start);
+	}
+}
+
+// Adds the property name to the hash table and returns the fragment for it.
+static JsonFragment* addNameSlot(
+	JsonFragments* fragments,
+	uint32_t nameOffset) {
+	uint32_t slot = hashNameOffset(nameOffset) & fragments->namesMask;
+	while (fragments->names[slot].nameOffset != EMPTY_SLOT &&
+		fragments->names[slot].nameOffset != nameOffset) {
+		slot = (slot + 1) & fragments->namesMask;
+	}
+	fragments->names[slot].nameOffset = nameOffset;
+	return &fragments->names[slot].fragment;
+}
+
+// Renders the name and all the values of each available property to the
+// builder in render. When record is false only the number of characters is
+// counted and the largest value index is set in the fragments. When record
+// is true the position of each fragment is recorded.
+static void renderFragments(
+	JsonFragments* fragments,
+	bool record,
+	fiftyoneDegreesJson* render,
+	Collection* properties,
+	Collection* propertyTypes,
+	Collection* values,
+	PropertiesAvailable* available,
+	Exception* exception) {
+	Item propertyItem, valueItem, contentItem;
+	const Property* source;
+	Property property;
+	const Value* value;
+	const StoredBinaryValue* content;
+	size_t start;
+	DataReset(&propertyItem.data);
+	DataReset(&valueItem.data);
+	DataReset(&contentItem.data);
+	render->property = &property;
+	for (uint32_t i = 0; i < available->count && EXCEPTION_OKAY; i++) {
+		source = PropertyGet(
+			properties,
+			available->items[i].propertyIndex,
+			&propertyItem,
+			exception);
+		if (source == NULL || EXCEPTION_FAILED) {
+			return;
+		}
+		memcpy(&property, source, sizeof(Property));
+		COLLECTION_RELEASE(properties, &propertyItem);
+		render->storedPropertyType = propertyTypes == NULL ?
+			FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING :
+			PropertyGetStoredTypeByIndex(
+				propertyTypes,
+				available->items[i].propertyIndex,
+				exception);
+		if (EXCEPTION_FAILED) {
+			return;
+		}
+
+		// Render the property name.
+		start = render->builder.added;
+		JsonPropertyStart(render);
+		setFragment(
+			record ? addNameSlot(fragments, property.nameOffset) : NULL,
+			&render->builder,
+			start);
+
+		// Render all the values of the property.
+		if ((int)property.firstValueIndex == -1 ||
+			property.lastValueIndex < property.firstValueIndex) {
+			continue;
+		}
+		if (property.lastValueIndex >= fragments->valuesCount) {
+			fragments->valuesCount = property.lastValueIndex + 1;
+		}
+		for (uint32_t v = property.firstValueIndex;
+			v <= property.lastValueIndex && EXCEPTION_OKAY;
+			v++) {
+			value = ValueGet(values, v, &valueItem, exception);
+			if (value == NULL || EXCEPTION_FAILED) {
+				return;
+			}
+			content = ValueGetContent(
+				render->strings,
+				value,
+				render->storedPropertyType,
+				&contentItem,
+				exception);
+			if (content != NULL && EXCEPTION_OKAY) {
+				start = render->builder.added;
+				addValueContents(render, content, render->storedPropertyType);
+				setFragment(
+					record ? &fragments->values[v] : NULL,
+					&render->builder,
+					start);
+				COLLECTION_RELEASE(render->strings, &contentItem);
+			}
+			COLLECTION_RELEASE(values, &valueItem);
+		}
+	}
+}
+
+fiftyoneDegreesJsonFragments* fiftyoneDegreesJsonFragmentsCreate(
+	fiftyoneDegreesCollection* properties,
+	fiftyoneDegreesCollection* propertyTypes,
+	fiftyoneDegreesCollection* values,
+	fiftyoneDegreesCollection* strings,
+	fiftyoneDegreesPropertiesAvailable* available,
+	fiftyoneDegreesException* exception) {
+	uint32_t slots = 2;
+	JsonFragments* fragments = (JsonFragments*)Malloc(sizeof(JsonFragments));
+	if (fragments == NULL) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return NULL;
+	}
+	memset(fragments, 0, sizeof(JsonFragments));
+	fragments->valuesCollection = values;
+
+	// Count the characters needed for all the fragments without writing them.
+	fiftyoneDegreesJson measure = { { NULL, 0 }, strings, NULL, NULL, 
+		exception, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING, NULL };
+	StringBuilderInit(&measure.builder);
+	renderFragments(
+		fragments,
+		false,
+		&measure,
+		properties,
+		propertyTypes,
+		values,
+		available,
+		exception);
+	if (EXCEPTION_OKAY && measure.builder.added >= UINT32_MAX) {
+		EXCEPTION_SET(INSUFFICIENT_CAPACITY);
+	}
+	if (EXCEPTION_FAILED) {
+		JsonFragmentsFree(fragments);
+		return NULL;
+	}
+
+	// Allocate the text, the name hash table which is never more than half
+	// full, and an entry for every value up to the largest value index.
+	fragments->textLength = measure.builder.added;
+	while (slots < available->count * 2) {
+		slots <<= 1;
+	}
+	fragments->namesMask = slots - 1;
+	fragments->text = (char*)Malloc(fragments->textLength + 1);
+	fragments->names = (JsonFragmentName*)Malloc(
+		sizeof(JsonFragmentName) * slots);
+	fragments->values = (JsonFragment*)Malloc(
+		sizeof(JsonFragment) * (fragments->valuesCount + 1));
+	if (fragments->text == NULL ||
+		fragments->names == NULL ||
+		fragments->values == NULL) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		JsonFragmentsFree(fragments);
+		return NULL;
+	}
+	for (uint32_t i = 0; i < slots; i++) {
+		fragments->names[i].nameOffset = EMPTY_SLOT;
+		fragments->names[i].fragment.offset = 0;
+		fragments->names[i].fragment.length = 0;
+	}
+	memset(
+		fragments->values, 
+		0, 
+		sizeof(JsonFragment) * (fragments->valuesCount + 1));
+
+	// Render the fragments into the text recording where each one starts.
+	fiftyoneDegreesJson render = { 
+		{ fragments->text, fragments->textLength + 1 }, strings, NULL, NULL, 
+		exception, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING, NULL };
+	StringBuilderInit(&render.builder);
+	renderFragments(
+		fragments,
+		true,
+		&render,
+		properties,
+		propertyTypes,
+		values,
+		available,
+		exception);
+	if (EXCEPTION_OKAY && render.builder.full) {
+		EXCEPTION_SET(CORRUPT_DATA);
+	}
+	if (EXCEPTION_FAILED) {
+		JsonFragmentsFree(fragments);
+		return NULL;
+	}
+	return fragments;
+}
+
+void fiftyoneDegreesJsonFragmentsFree(fiftyoneDegreesJsonFragments* fragments) {
+	if (fragments->text != NULL) {
+		Free(fragments->text);
+	}
+	if (fragments->names != NULL) {
+		Free(fragments->names);
+	}
+	if (fragments->values != NULL) {
+		Free(fragments->values);
+	}
+	Free(fragments);
+}
@@ -49,6 +49,38 @@
   * Reference data for the property being added, the values being added, and
   * a collection of strings is also provided.
   * 
+  * ## Streaming
+  * 
+  * If the sink member of the builder is set then the buffer only needs to be
+  * large enough to stage a chunk of output. Each time the buffer fills the
+  * characters are passed to the sink, and any remaining characters are passed
+  * when the document ends. Output of any size is therefore produced in a
+  * single pass without the caller needing to retry with a larger buffer. The
+  * null terminator is not passed to the sink.
+  * 
+  * Alternatively the builder can be initialized with
+  * fiftyoneDegreesStringBuilderInitGrowable so that the buffer grows to hold
+  * the whole document. Reinitializing the builder for the next document keeps
+  * the memory already allocated.
+  * 
+  * ## Geometries
+  * 
+  * Well known binary (WKB) values are written as WKT strings by default. If
+  * the geometryAsGeoJson member is set then they are written as GeoJSON
+  * geometry objects so that consumers can read the coordinates without
+  * parsing WKT. Pre-rendered fragments are not used for these values.
+  * 
+  * ## Fragments
+  * 
+  * Property names and values in a data set never change. 
+  * fiftyoneDegreesJsonFragmentsCreate renders the name of each available
+  * property, and every value of those properties, as escaped JSON once during
+  * data set initialization. If the fragments member is set then
+  * fiftyoneDegreesJsonPropertyStart copies the pre-rendered property name and
+  * fiftyoneDegreesJsonPropertyValueIndexes copies the pre-rendered values. 
+  * Writing a result is then a sequence of memory copies. The output is the
+  * same as when fragments are not used.
+  * 
   * @{
   */
 
@@ -61,6 +93,7 @@
 #pragma warning (pop)
 #endif
 #include "property.h"
+#include "properties.h"
 #include "string.h"
 #include "list.h"
 #include "data.h"
@@ -68,6 +101,46 @@
 #include "common.h"
 #include "exceptions.h"
 
+/**
+ * Position of a pre-rendered fragment of JSON within the text of the
+ * fragments.
+ */
+typedef struct fiftyone_degrees_json_fragment_t {
+	uint32_t offset; /**< Offset of the first character in the text */
+	uint32_t length; /**< Number of characters, or 0 if not rendered */
+} fiftyoneDegreesJsonFragment;
+
+/**
+ * Single slot in the property name hash table of the fragments.
+ */
+typedef struct fiftyone_degrees_json_fragment_name_t {
+	uint32_t nameOffset; /**< Offset of the property name in the strings
+						 collection, or UINT32_MAX if the slot is empty */
+	fiftyoneDegreesJsonFragment fragment; /**< The rendered property name
+										  including the separator and the
+										  opening bracket for list
+										  properties */
+} fiftyoneDegreesJsonFragmentName;
+
+/**
+ * Pre-rendered JSON for the names and values of the available properties in
+ * a data set. Created by fiftyoneDegreesJsonFragmentsCreate.
+ */
+typedef struct fiftyone_degrees_json_fragments_t {
+	char *text; /**< Characters of all the fragments */
+	size_t textLength; /**< Number of characters in text */
+	fiftyoneDegreesJsonFragmentName *names; /**< Hash table of property names
+											keyed on the name offset */
+	uint32_t namesMask; /**< Number of slots in names - 1 */
+	fiftyoneDegreesJsonFragment *values; /**< Rendered values indexed by the
+										 value index */
+	uint32_t valuesCount; /**< Number of elements in values */
+	const fiftyoneDegreesCollection *valuesCollection; /**< Collection of
+													   values used for any
+													   value which was not
+													   rendered */
+} fiftyoneDegreesJsonFragments;
+
 /**
  * Structure used to populated a JSON string for all required properties and 
  * values. The implementation will always check to determine if sufficient 
@@ -83,6 +156,11 @@ typedef struct fiftyone_degrees_json {
 	fiftyoneDegreesList* values; /**< The values for the property */
 	fiftyoneDegreesException* exception; /**< Exception */
 	fiftyoneDegreesPropertyValueType storedPropertyType; /**< Stored type of the values for the property */
+	const fiftyoneDegreesJsonFragments* fragments; /**< Pre-rendered fragments
+												   or NULL if not used */
+	bool geometryAsGeoJson; /**< True if well known binary values are written
+							as GeoJSON geometry objects rather than WKT
+							strings */
 } fiftyoneDegreesJson;
 
 /**
@@ -121,6 +199,51 @@ EXTERNAL void fiftyoneDegreesJsonPropertyValues(fiftyoneDegreesJson* json);
  */
 EXTERNAL void fiftyoneDegreesJsonPropertySeparator(fiftyoneDegreesJson* json);
 
+/**
+ * Writes the values at the value indexes provided to the buffer in json using
+ * the pre-rendered fragments in json->fragments. Values which were not
+ * rendered when the fragments were created are fetched from the values
+ * collection and rendered as json->storedPropertyType.
+ * @param json data structure
+ * @param valueIndexes indexes of the values in the values collection
+ * @param count number of value indexes
+ */
+EXTERNAL void fiftyoneDegreesJsonPropertyValueIndexes(
+	fiftyoneDegreesJson* json,
+	const uint32_t* valueIndexes,
+	uint32_t count);
+
+/**
+ * Create pre-rendered fragments for the names and values of the available
+ * properties so that they can be copied rather than fetched and escaped when
+ * each result is written. This should be called during data set
+ * initialization and the collections must remain valid until the fragments
+ * are freed.
+ * @param properties collection of all properties in the data set
+ * @param propertyTypes collection of property stored types, or NULL if all
+ * values are stored as strings
+ * @param values collection of values
+ * @param strings collection containing the property and value names
+ * @param available properties provided by the caller
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h
+ * @return pointer to the fragments, or NULL if they could not be created
+ */
+EXTERNAL fiftyoneDegreesJsonFragments* fiftyoneDegreesJsonFragmentsCreate(
+	fiftyoneDegreesCollection* properties,
+	fiftyoneDegreesCollection* propertyTypes,
+	fiftyoneDegreesCollection* values,
+	fiftyoneDegreesCollection* strings,
+	fiftyoneDegreesPropertiesAvailable* available,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Frees fragments previously created by fiftyoneDegreesJsonFragmentsCreate.
+ * @param fragments to be freed
+ */
+EXTERNAL void fiftyoneDegreesJsonFragmentsFree(
+	fiftyoneDegreesJsonFragments* fragments);
+
 /**
  * @}
  */
@@ -51,14 +51,8 @@ static void collectionRelease(Item *item) {
 /* Prefix to use when comparing property names. */
 #define OVERRIDE_PREFIX "51D_"
 
-/**
- * Checks if the pair (p) have a field name that matches the target (t).
- * The last byte of t is null where as fieldLength is the length of printable
- * characters. Take 1 from the t to compare length.
- */
-#define IS_HEADER_MATCH(t,p) \
-	(StringCompareLength(\
-	skipPrefix(true, (char*)pair->item.key), t, sizeof(t)) == 0)
+/* Name of the evidence field containing profile ids. */
+#define PROFILE_IDS "ProfileIds"
 
 static const Collection dummyCollection = { 
 	NULL, 
@@ -95,52 +89,129 @@ static bool startsWith(String *string, String *prefix) {
 }
 
 /**
- * If there is an expected prefix to be ignored then check for it in the
- * property name and skip those characters if present.
- * @param prefix true if there is a prefix to be skipped
- * @param field the name of the field provided
- * @return a pointer to the start of the field name for checking.
+ * Checks if the key of the pair, with or without the override prefix, is the
+ * field name. The key might not be null terminated, for example when it comes
+ * from a header block, so its length is used.
+ * @param pair to check the key of
+ * @param field name to compare the key to
+ * @param fieldLength number of characters in the field name
+ * @return true if the key is the field name ignoring case
  */
-static const char* skipPrefix(bool prefixed, const char *field) {
-	char *result = (char*)field;
-	if (result && prefixed == true && strlen(result) > sizeof(OVERRIDE_PREFIX) &&
+static bool isFieldMatch(
+	EvidenceKeyValuePair *pair,
+	const char *field,
+	size_t fieldLength) {
+	const char *key = pair->item.key;
+	size_t length = pair->item.keyLength;
+	if (key == NULL) {
+		return false;
+	}
+	if (length > sizeof(OVERRIDE_PREFIX) - 1 &&
 		StringCompareLength(
-			field,
+			key,
 			OVERRIDE_PREFIX,
 			sizeof(OVERRIDE_PREFIX) - 1) == 0) {
-		result += sizeof(OVERRIDE_PREFIX) - 1;
+		key += sizeof(OVERRIDE_PREFIX) - 1;
+		length -= sizeof(OVERRIDE_PREFIX) - 1;
+	}
+	return length == fieldLength &&
+		StringCompareLength(key, field, length) == 0;
+}
+
+// Returns true if the property name is the same as the name of the length
+// provided ignoring case.
+static bool isPropertyName(
+	OverrideProperty *property,
+	const char *name,
+	size_t length) {
+	String *current = (String*)property->available->name.data.ptr;
+	return current != NULL &&
+		(size_t)current->size == length + 1 &&
+		StringCompareLength(&current->value, name, length) == 0;
+}
+
+// Creates the hash table of property names so that each evidence key can be
+// checked with a single hash. If memory can't be allocated or any name is
+// missing then the properties are searched instead.
+static void initNameSlots(OverridePropertyArray *properties) {
+	uint32_t i, slot, slots = 2;
+	String *name;
+	for (i = 0; i < properties->count; i++) {
+		if (properties->items[i].available->name.data.ptr == NULL) {
+			return;
+		}
+	}
+	while (slots < properties->count * 2) {
+		slots <<= 1;
+	}
+	properties->nameSlots = (uint32_t*)Malloc(sizeof(uint32_t) * slots);
+	if (properties->nameSlots == NULL) {
+		return;
+	}
+	memset(properties->nameSlots, 0, sizeof(uint32_t) * slots);
+	properties->nameSlotsMask = slots - 1;
+	for (i = 0; i < properties->count; i++) {
+		name = (String*)properties->items[i].available->name.data.ptr;
+		slot = StringHashCaseInsensitive(
+			&name->value,
+			(size_t)name->size - 1) & properties->nameSlotsMask;
+		while (properties->nameSlots[slot] != 0) {
+			slot = (slot + 1) & properties->nameSlotsMask;
+		}
+		properties->nameSlots[slot] = i + 1;
 	}
-	return result;
 }
 
 static int getRequiredPropertyIndexFromName(
 	OverridePropertyArray *properties,
-	const char *name) {
-	uint32_t i;
-	const char *current;
+	const char *name,
+	size_t length) {
+	uint32_t i, slot;
 	OverrideProperty *property;
 
 	// Skip the field name prefix.
-	name = (const char*)skipPrefix(properties->prefix, name);
+	if (properties->prefix == true &&
+		length > sizeof(OVERRIDE_PREFIX) - 1 &&
+		StringCompareLength(
+			name,
+			OVERRIDE_PREFIX,
+			sizeof(OVERRIDE_PREFIX) - 1) == 0) {
+		name += sizeof(OVERRIDE_PREFIX) - 1;
+		length -= sizeof(OVERRIDE_PREFIX) - 1;
+	}
+
+	// Find the property name in the hash table of properties that can
+	// support being overridden.
+	if (properties->nameSlots != NULL) {
+		slot = StringHashCaseInsensitive(name, length) &
+			properties->nameSlotsMask;
+		while (properties->nameSlots[slot] != 0) {
+			property = &properties->items[properties->nameSlots[slot] - 1];
+			if (isPropertyName(property, name, length)) {
+				return property->requiredPropertyIndex;
+			}
+			slot = (slot + 1) & properties->nameSlotsMask;
+		}
+		return -1;
+	}
 
 	// Search for the property name in the array of properties that can support
 	// being overridden.
 	for (i = 0; i < properties->count; i++) {
 		property = &properties->items[i];
-		current = STRING(property->available->name.data.ptr); // name is string
-		if (StringCompare((char*)current, (char*)name) == 0) {
+		if (isPropertyName(property, name, length)) {
 			return property->requiredPropertyIndex;
 		}
 	}
 	return -1;
 }
 
-bool fiftyoneDegreesOverridesAdd(
-	fiftyoneDegreesOverrideValueArray *values,
+static bool addOverride(
+	OverrideValueArray *values,
 	int requiredPropertyIndex,
-	const char *value) {
+	const char *value,
+	size_t length) {
 	uint32_t currentOverrideIndex = 0;
-	size_t length;
 	String *copy;
 	OverrideValue *override;
 	if (requiredPropertyIndex >= 0 && values->count < values->capacity) {
@@ -163,33 +234,50 @@ bool fiftyoneDegreesOverridesAdd(
 		}
 
 		// Ensure there is sufficient memory for the string being copied.
-		length = strlen(value);
 		copy = (String*)fiftyoneDegreesDataMalloc(
 			&override->string,
 			sizeof(String) + length);
 
 		// Copy the string from the evidence pair to the override data 
 		// item.
-		memcpy(&copy->value, value, length + 1);
+		memcpy(&copy->value, value, length);
+		(&copy->value)[length] = '\0';
 		copy->size = (int16_t)(length + 1);
 	}
 
 	return values->count < values->capacity;
 }
 
+bool fiftyoneDegreesOverridesAdd(
+	fiftyoneDegreesOverrideValueArray *values,
+	int requiredPropertyIndex,
+	const char *value) {
+	return addOverride(
+		values,
+		requiredPropertyIndex,
+		value,
+		value != NULL ? strlen(value) : 0);
+}
+
 
 static bool addOverrideToResults(void *state, EvidenceKeyValuePair *pair) {
 	addState *add = (addState*)state;
 
-	// Find the required property index, if any for the field.
+	// Find the required property index, if any for the field. Most keys are
+	// not overrides so only add the value if one is found.
 	int requiredPropertyIndex = getRequiredPropertyIndexFromName(
 		add->properties,
-		pair->item.key);
+		pair->item.key,
+		pair->item.keyLength);
+	if (requiredPropertyIndex < 0) {
+		return add->values->count < add->values->capacity;
+	}
 
-	return fiftyoneDegreesOverridesAdd(
+	return addOverride(
 		add->values,
 		requiredPropertyIndex,
-		(const char*)pair->parsedValue);
+		(const char*)pair->parsedValue,
+		pair->parsedLength);
 }
 
 static uint32_t countOverridableProperties(
@@ -249,7 +337,10 @@ fiftyoneDegreesOverridePropertyArray* fiftyoneDegreesOverridePropertiesCreate(
 		FIFTYONE_DEGREES_ARRAY_CREATE(OverrideProperty, properties, count);
 		if (properties != NULL) {
 			properties->prefix = prefix;
+			properties->nameSlots = NULL;
+			properties->nameSlotsMask = 0;
 			addOverridableProperties(available, properties, state, filter);
+			initNameSlots(properties);
 		}
 	} 
 	return properties;
@@ -257,6 +348,9 @@ fiftyoneDegreesOverridePropertyArray* fiftyoneDegreesOverridePropertiesCreate(
 
 void fiftyoneDegreesOverridePropertiesFree(
 	fiftyoneDegreesOverridePropertyArray *properties) {
+	if (properties->nameSlots != NULL) {
+		Free(properties->nameSlots);
+	}
 	Free(properties);
 }
 
@@ -412,32 +506,40 @@ void fiftyoneDegreesOverrideValuesReset(
 	}
 }
 
-static void extractProfileId(char *value, overrideProfileIdsState *state) {
-	if (*value >= 0 && isdigit(*value) != 0) {
-		int profileId = atoi(value);
-		if (profileId >= 0) {
-			state->callback(state->state, profileId);
+// Passes each run of digits in the value to the callback as a profile id.
+// The value might not be null terminated so only the length provided is
+// read. Runs larger than the largest profile id are ignored.
+static void extractProfileIds(
+	overrideProfileIdsState *state,
+	const char *value,
+	size_t length) {
+	const char *end = value + length;
+	uint64_t profileId;
+	while (value < end) {
+		if (isdigit((unsigned char)*value) == 0) {
+			value++;
+			continue;
 		}
-	}
-}
-
-static void extractProfileIds(overrideProfileIdsState *state, char *value) {
-	char *current = value, *previous = value;
-	while (*current != '\0') {
-		if (*current < 0 || isdigit(*current) == 0) {
-			extractProfileId(previous, state);
-			previous = current + 1;
+		profileId = 0;
+		while (value < end && isdigit((unsigned char)*value) != 0) {
+			if (profileId <= INT32_MAX) {
+				profileId = profileId * 10 + (uint64_t)(*value - '0');
+			}
+			value++;
+		}
+		if (profileId <= INT32_MAX) {
+			state->callback(state->state, (uint32_t)profileId);
 		}
-		current++;
 	}
-	extractProfileId(previous, state);
 }
 
 static bool iteratorProfileId(void *state, EvidenceKeyValuePair *pair) {
-	if (IS_HEADER_MATCH("ProfileIds", pair)) {
+	if (pair->parsedValue != NULL &&
+		isFieldMatch(pair, PROFILE_IDS, sizeof(PROFILE_IDS) - 1)) {
 		extractProfileIds(
 			(overrideProfileIdsState*)state, 
-			(char*)pair->parsedValue);
+			(const char*)pair->parsedValue,
+			pair->parsedLength);
 	}
 	return true;
 }
@@ -100,6 +100,11 @@ FIFTYONE_DEGREES_ARRAY_TYPE(
 	fiftyoneDegreesOverrideProperty,
 	bool prefix; /**< Flag which when true requires the `51D_` prefix to be
 				 checked for in evidence. */
+	uint32_t *nameSlots; /**< Hash table of the property names where each
+						 slot is the index in items plus 1 or 0 if empty.
+						 NULL if not created in which case the items are
+						 searched */
+	uint32_t nameSlotsMask; /**< Number of slots in nameSlots - 1 */
 );
 
 /**
@@ -153,7 +158,7 @@ EXTERNAL fiftyoneDegreesOverrideValueArray* fiftyoneDegreesOverrideValuesCreate(
  * property is eligible to be overridden
  * @return a new override properties array
  */
-fiftyoneDegreesOverridePropertyArray* 
+EXTERNAL fiftyoneDegreesOverridePropertyArray* 
 fiftyoneDegreesOverridePropertiesCreate(
 	fiftyoneDegreesPropertiesAvailable *available,
 	bool prefix,
@@ -164,7 +169,7 @@ fiftyoneDegreesOverridePropertiesCreate(
  * Frees the resources used by the override properties.
  * @param properties pointer to the properties to free
  */
-void fiftyoneDegreesOverridePropertiesFree(
+EXTERNAL void fiftyoneDegreesOverridePropertiesFree(
 	fiftyoneDegreesOverridePropertyArray *properties);
 
 /**
@@ -174,7 +179,7 @@ void fiftyoneDegreesOverridePropertiesFree(
  * @param evidence to extract any overrides from
  * @return the number of override values which have been extracted
  */
- uint32_t fiftyoneDegreesOverridesExtractFromEvidence(
+EXTERNAL uint32_t fiftyoneDegreesOverridesExtractFromEvidence(
 	fiftyoneDegreesOverridePropertyArray *properties,
 	fiftyoneDegreesOverrideValueArray *values,
 	fiftyoneDegreesEvidenceKeyValuePairArray *evidence);
@@ -226,7 +231,7 @@ EXTERNAL bool fiftyoneDegreesOverridesAdd(
  * @param item to store the result in
  * @return pointer to the value or NULL if none were found
  */
-fiftyoneDegreesString* fiftyoneDegreesOverrideValuesGetFirst(
+EXTERNAL fiftyoneDegreesString* fiftyoneDegreesOverrideValuesGetFirst(
 	fiftyoneDegreesOverrideValueArray *values,
 	uint32_t requiredPropertyIndex,
 	fiftyoneDegreesCollectionItem *item);
@@ -0,0 +1,155 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#define __STDC_FORMAT_MACROS
+
+#include <time.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "../stringBuilder.h"
+#include "../fiftyone.h"
+
+#define PASSES 200000
+
+// Integers of typical magnitudes such as pixel sizes, years, and ids.
+static const int64_t _integers[] = {
+	0, 1, -1, 7, 42, 96, 100, 360, 1080, 2024, 3840, 65535, -32768,
+	1234567, 2147483647, -2147483647, 9007199254740993LL, INT64_MIN
+};
+
+#define INTEGERS_COUNT (sizeof(_integers) / sizeof(int64_t))
+
+// Doubles of typical magnitudes such as screen sizes and coordinates.
+static const double _doubles[] = {
+	0.5, 1.25, 2.0, 5.8, 6.1, 15.6, 51.4545, -0.1276, -122.4194, 37.7749,
+	1.7976931348623157, 299.792458, 1000.001, -45.123456789
+};
+
+#define DOUBLES_COUNT (sizeof(_doubles) / sizeof(double))
+
+#define DECIMAL_PLACES 6
+
+static char _buffer[64];
+
+typedef void(*formatMethod)(StringBuilder *builder, size_t index);
+
+// Reference method which formats the integer with snprintf as the string
+// builder did previously.
+static void snprintfInteger(StringBuilder *builder, size_t index) {
+	char temp[22];
+	if (snprintf(temp, sizeof(temp), "%" PRId64, _integers[index]) > 0) {
+		StringBuilderAddChars(builder, temp, strlen(temp));
+	}
+}
+
+static void libraryInteger(StringBuilder *builder, size_t index) {
+	StringBuilderAddInteger(builder, _integers[index]);
+}
+
+// Reference method which formats the double with snprintf. The output is not
+// identical as trailing zeros are retained.
+static void snprintfDouble(StringBuilder *builder, size_t index) {
+	char temp[64];
+	int length = snprintf(
+		temp,
+		sizeof(temp),
+		"%.*f",
+		DECIMAL_PLACES,
+		_doubles[index]);
+	if (length > 0) {
+		StringBuilderAddChars(builder, temp, (size_t)length);
+	}
+}
+
+static void libraryDouble(StringBuilder *builder, size_t index) {
+	StringBuilderAddDouble(builder, _doubles[index], DECIMAL_PLACES);
+}
+
+static double now(void) {
+	struct timespec time;
+	timespec_get(&time, TIME_UTC);
+	return (double)time.tv_sec + (double)time.tv_nsec / 1.0e9;
+}
+
+// Runs the method for every value the number of passes returning the time in
+// nano seconds for each call.
+static double run(
+	const char *name,
+	formatMethod method,
+	size_t count,
+	int passes) {
+	volatile size_t added = 0;
+	StringBuilder builder = { _buffer, sizeof(_buffer) };
+	double start = now();
+	for (int i = 0; i < passes; i++) {
+		for (size_t n = 0; n < count; n++) {
+			StringBuilderInit(&builder);
+			method(&builder, n);
+			added += builder.added;
+		}
+	}
+	double nanos = (now() - start) * 1.0e9 / 
+		((double)passes * (double)count);
+	printf("    %-22s %8.2fns per call\n", name, nanos);
+	return nanos;
+}
+
+static void compare(
+	const char *name,
+	formatMethod reference,
+	formatMethod library,
+	size_t count,
+	int passes) {
+	printf("%s\n", name);
+	double referenceNanos = run("snprintf", reference, count, passes);
+	double libraryNanos = run("Library", library, count, passes);
+	printf("    %-22s %8.2fx\n\n", "Speed up", referenceNanos / libraryNanos);
+}
+
+/**
+ * The main method used by the command line test routine.
+ */
+int main(int argc, char* argv[]) {
+	int passes = argc > 1 ? atoi(argv[1]) : PASSES;
+	printf("\n");
+	printf("\t#############################################################\n");
+	printf("\t#                                                           #\n");
+	printf("\t#  This program can be used to test the performance of the  #\n");
+	printf("\t#     51Degrees string builder number formatting methods.   #\n");
+	printf("\t#                                                           #\n");
+	printf("\t#############################################################\n");
+	printf("\n");
+
+	compare(
+		"Add Integer",
+		snprintfInteger,
+		libraryInteger,
+		INTEGERS_COUNT,
+		passes);
+	compare(
+		"Add Double",
+		snprintfDouble,
+		libraryDouble,
+		DOUBLES_COUNT,
+		passes);
+	return 0;
+}
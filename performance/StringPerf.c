@@ -0,0 +1,134 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include <time.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "../string.h"
+#include "../fiftyone.h"
+
+#define PASSES 2000000
+
+// Header and property names of typical lengths compared with differently 
+// cased versions of themselves.
+static const char *_names[] = {
+	"Host",
+	"Accept",
+	"User-Agent",
+	"IsMobile",
+	"BrowserName",
+	"PlatformVersion",
+	"Accept-Language",
+	"HardwareVendor",
+	"Sec-CH-UA-Mobile",
+	"X-Forwarded-For",
+	"Sec-CH-UA-Platform-Version",
+	"Sec-CH-UA-Full-Version-List",
+	"JavascriptHardwareProfile",
+	"ScreenPixelsWidthJavascript"
+};
+
+#define NAMES_COUNT (sizeof(_names) / sizeof(const char*))
+
+static char _upper[NAMES_COUNT][64];
+
+// Reference method which compares one character at a time.
+static int scalarCompareLength(const char *a, const char *b, size_t length) {
+	size_t i;
+	for (i = 0; i < length; a++, b++, i++) {
+		int d = tolower(*a) - tolower(*b);
+		if (d != 0) {
+			return d;
+		}
+	}
+	return 0;
+}
+
+typedef int(*compareMethod)(const char *a, const char *b, size_t length);
+
+static int scalarCompareLengthTest(const char *a, const char *b, size_t length) {
+	return scalarCompareLength(a, b, length);
+}
+
+static int compareLengthTest(const char *a, const char *b, size_t length) {
+	return StringCompareLength(a, b, length);
+}
+
+static double now(void) {
+	struct timespec time;
+	timespec_get(&time, TIME_UTC);
+	return (double)time.tv_sec + (double)time.tv_nsec / 1.0e9;
+}
+
+// Runs the method for every name the number of passes returning the time in
+// nano seconds for each call.
+static double run(const char *name, compareMethod method, int passes) {
+	volatile int result = 0;
+	double start = now();
+	for (int i = 0; i < passes; i++) {
+		for (size_t n = 0; n < NAMES_COUNT; n++) {
+			result += method(_names[n], _upper[n], strlen(_names[n]));
+		}
+	}
+	double nanos = (now() - start) * 1.0e9 / 
+		((double)passes * (double)NAMES_COUNT);
+	printf("    %-22s %8.2fns per call\n", name, nanos);
+	return nanos;
+}
+
+static void compare(
+	const char *name,
+	compareMethod scalar,
+	compareMethod vector,
+	int passes) {
+	printf("%s\n", name);
+	double scalarNanos = run("Scalar", scalar, passes);
+	double vectorNanos = run("Library", vector, passes);
+	printf("    %-22s %8.2fx\n\n", "Speed up", scalarNanos / vectorNanos);
+}
+
+/**
+ * The main method used by the command line test routine.
+ */
+int main(int argc, char* argv[]) {
+	int passes = argc > 1 ? atoi(argv[1]) : PASSES;
+	printf("\n");
+	printf("\t#############################################################\n");
+	printf("\t#                                                           #\n");
+	printf("\t#  This program can be used to test the performance of the  #\n");
+	printf("\t#   51Degrees case insensitive string comparison methods.   #\n");
+	printf("\t#                                                           #\n");
+	printf("\t#############################################################\n");
+	printf("\n");
+
+	for (size_t n = 0; n < NAMES_COUNT; n++) {
+		size_t i;
+		for (i = 0; _names[n][i] != '\0'; i++) {
+			_upper[n][i] = (char)toupper(_names[n][i]);
+		}
+		_upper[n][i] = '\0';
+	}
+
+	compare("Compare Length", scalarCompareLengthTest, compareLengthTest, passes);
+	return 0;
+}
@@ -27,6 +27,29 @@
 
 MAP_TYPE(Collection)
 
+/*
+ * Select the vector instructions used to search the value indexes of a
+ * profile. SSE2 is always available on 64 bit x86 and NEON on 64 bit ARM.
+ * Defining FIFTYONE_DEGREES_PROFILE_NO_SIMD uses the scalar method only.
+ */
+#ifndef FIFTYONE_DEGREES_PROFILE_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PROFILE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define PROFILE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+// Number of value indexes compared at a time by the vector instructions.
+#define PROFILE_WIDTH 4
+
+// Number of value indexes left by the binary search for the vector
+// instructions to count.
+#define PROFILE_WINDOW 16
+
 uint32_t fiftyoneDegreesProfileGetFinalSize(
 	const void *initial,
     fiftyoneDegreesException * const exception) {
@@ -107,42 +130,87 @@ static int compareProfileIdIndirect(
 	return result;
 }
 
-static int compareValueToProperty(const void *p, const void *v) {
-	Property *property = (Property*)p;
-	uint32_t valueIndex = *(uint32_t*)v;
-	if (valueIndex < property->firstValueIndex) {
-		return 1;
+#if defined(PROFILE_SSE2)
+
+// Returns the number of the four value indexes which are less than the target.
+static uint32_t countLess(const uint32_t *indexes, uint32_t target) {
+	// SSE2 only compares signed integers so flip the sign bits.
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(
+		_mm_xor_si128(_mm_loadu_si128((const __m128i*)indexes), bias),
+		_mm_xor_si128(_mm_set1_epi32((int)target), bias))));
+	return (uint32_t)((mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) +
+		((mask >> 3) & 1));
+}
+
+#elif defined(PROFILE_NEON)
+
+// Returns the number of the four value indexes which are less than the target.
+static uint32_t countLess(const uint32_t *indexes, uint32_t target) {
+	const uint32x4_t less = vshrq_n_u32(
+		vcltq_u32(vld1q_u32(indexes), vdupq_n_u32(target)),
+		31);
+	const uint32x2_t sum = vpadd_u32(vget_low_u32(less), vget_high_u32(less));
+	return vget_lane_u32(sum, 0) + vget_lane_u32(sum, 1);
+}
+
+#else
+
+// Returns the number of the four value indexes which are less than the target.
+static uint32_t countLess(const uint32_t *indexes, uint32_t target) {
+	return (uint32_t)(indexes[0] < target) + (uint32_t)(indexes[1] < target) +
+		(uint32_t)(indexes[2] < target) + (uint32_t)(indexes[3] < target);
+}
+
+#endif
+
+// Returns the position of the first of the ascending value indexes which is
+// not less than the target, or count if there is none. A binary search
+// narrows the range to a small window whose indexes are then counted.
+static uint32_t lowerBoundValueIndex(
+	const uint32_t *indexes,
+	uint32_t count,
+	uint32_t target) {
+	uint32_t base = 0, half, i;
+	while (count > PROFILE_WINDOW) {
+		half = count >> 1;
+		if (indexes[base + half] < target) {
+			base += half + 1;
+			count -= half + 1;
+		}
+		else {
+			count = half;
+		}
 	}
-	if (valueIndex > property->lastValueIndex) {
-		return -1;
+	for (i = 0; i + PROFILE_WIDTH <= count; i += PROFILE_WIDTH) {
+		half = countLess(indexes + base + i, target);
+		if (half < PROFILE_WIDTH) {
+			return base + i + half;
+		}
 	}
-	return 0;
+	while (i < count && indexes[base + i] < target) {
+		i++;
+	}
+	return base + i;
 }
 
 static uint32_t* getFirstValueForProfileAndProperty(
 	const fiftyoneDegreesProfile *profile,
 	const fiftyoneDegreesProperty *property) {
+	uint32_t *indexes = (uint32_t*)(profile + 1);
 
-	// Search to find a value that is equal to or between the first and last
-	// value indexes for the property.
-	uint32_t *valueIndex = (uint32_t*)bsearch(
-		property,
-		profile + 1,
+	// Find the first value index that is equal to or after the first value
+	// index for the property.
+	uint32_t i = lowerBoundValueIndex(
+		indexes,
 		profile->valueCount,
-		sizeof(uint32_t),
-		compareValueToProperty);
+		property->firstValueIndex);
 
-	if (valueIndex != NULL) {
-
-		// Move back through the values until the first one for the property is 
-		// found.
-		while ((void*)valueIndex > (void*)(profile + 1) &&
-			*(valueIndex - 1) >= property->firstValueIndex) {
-			valueIndex--;
-		}
+	// Only return the value if it relates to the property.
+	if (i < profile->valueCount && indexes[i] <= property->lastValueIndex) {
+		return indexes + i;
 	}
-
-	return valueIndex;
+	return NULL;
 }
 
 /**
@@ -204,17 +272,6 @@ static uint32_t iterateValues(
 	return count;
 }
 
-static bool isAvailableProperty(
-	PropertiesAvailable* available, 
-	uint32_t propertyIndex) {
-	for (uint32_t i = 0; i < available->count; i++) {
-		if (available->items[i].propertyIndex == propertyIndex) {
-			return true;
-		}
-	}
-	return false;
-}
-
 uint32_t* fiftyoneDegreesProfileGetOffsetForProfileId(
 	fiftyoneDegreesCollection *profileOffsets,
 	const uint32_t profileId,
@@ -492,6 +549,58 @@ uint32_t fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValue(
 		exception);
 }
 
+// Calls the callback for each profile which contains the value index.
+static uint32_t iterateProfilesWithValueIndex(
+	fiftyoneDegreesCollection * const profiles,
+	const fiftyoneDegreesCollection * const profileOffsets,
+	const fiftyoneDegreesProfileOffsetValueExtractor offsetValueExtractor,
+	const uint32_t valueIndex,
+	void *const state,
+	const fiftyoneDegreesProfileIterateMethod callback,
+	fiftyoneDegreesException * const exception) {
+	uint32_t i, count = 0;
+	Item offsetItem, profileItem;
+	uint32_t *profileValueIndex, position;
+	Profile *profile;
+	DataReset(&offsetItem.data);
+	DataReset(&profileItem.data);
+	uint32_t profileOffsetsCount = CollectionGetCount(profileOffsets);
+	for (i = 0; i < profileOffsetsCount; i++) {
+		const CollectionKey rawOffsetKey = {
+			i,
+			CollectionKeyType_ProfileOffset,
+		};
+		const void * const rawProfileOffset = profileOffsets->get(
+			profileOffsets,
+			&rawOffsetKey,
+			&offsetItem, 
+			exception);
+		if (rawProfileOffset != NULL && EXCEPTION_OKAY) {
+			const uint32_t pureProfileOffset = offsetValueExtractor(rawProfileOffset);
+			profile = getProfileByOffset(
+				profiles,
+				pureProfileOffset,
+				&profileItem,
+				exception);
+			if (profile != NULL && EXCEPTION_OKAY) {
+				profileValueIndex = (uint32_t*)(profile + 1);
+				position = lowerBoundValueIndex(
+					profileValueIndex,
+					profile->valueCount,
+					valueIndex);
+				if (position < profile->valueCount &&
+					profileValueIndex[position] == valueIndex) {
+					callback(state, &profileItem);
+					count++;
+				}
+				COLLECTION_RELEASE(profiles, &profileItem);
+			}
+			COLLECTION_RELEASE(profileOffsets, &offsetItem);
+		}
+	}
+	return count;
+}
+
 uint32_t fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValueAndOffsetExtractor(
 	fiftyoneDegreesCollection * const strings,
 	fiftyoneDegreesCollection * const properties,
@@ -505,11 +614,9 @@ uint32_t fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValueAndOffs
 	void *const state,
 	const fiftyoneDegreesProfileIterateMethod callback,
 	fiftyoneDegreesException * const exception) {
-	uint32_t i, count = 0;
-	Item propertyItem, offsetItem, profileItem;
-	uint32_t *profileValueIndex, *maxProfileValueIndex;
+	uint32_t count = 0;
+	Item propertyItem;
 	const Property *property;
-	Profile *profile;
 	DataReset(&propertyItem.data);
 	property = PropertyGetByName(
 		properties, 
@@ -537,56 +644,75 @@ uint32_t fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValueAndOffs
 			valueName,
 			exception);
 		if (valueIndex >= 0 && EXCEPTION_OKAY) {
-			DataReset(&offsetItem.data);
-			DataReset(&profileItem.data);
-			uint32_t profileOffsetsCount = CollectionGetCount(profileOffsets);
-			for (i = 0; i < profileOffsetsCount; i++) {
-				const CollectionKey rawOffsetKey = {
-					i,
-					CollectionKeyType_ProfileOffset,
-				};
-				const void * const rawProfileOffset = profileOffsets->get(
-					profileOffsets,
-					&rawOffsetKey,
-					&offsetItem, 
-					exception);
-				if (rawProfileOffset != NULL && EXCEPTION_OKAY) {
-					const uint32_t pureProfileOffset = offsetValueExtractor(rawProfileOffset);
-					profile = getProfileByOffset(
-						profiles,
-						pureProfileOffset,
-						&profileItem,
-						exception);
-					if (profile != NULL && EXCEPTION_OKAY) {
-						profileValueIndex = getFirstValueForProfileAndProperty(
-							profile,
-							property);
-						if (profileValueIndex != NULL) {
-							maxProfileValueIndex = ((uint32_t*)(profile + 1)) +
-								profile->valueCount;
-							while (*profileValueIndex <=
-								property->lastValueIndex &&
-								profileValueIndex < maxProfileValueIndex) {
-								if ((uint32_t)valueIndex ==
-									*profileValueIndex) {
-									callback(state, &profileItem);
-									count++;
-									break;
-								}
-								profileValueIndex++;
-							}
-						}
-						COLLECTION_RELEASE(profiles, &profileItem);
-					}
-					COLLECTION_RELEASE(profileOffsets, &offsetItem);
-				}
-			}
+			count = iterateProfilesWithValueIndex(
+				profiles,
+				profileOffsets,
+				offsetValueExtractor,
+				(uint32_t)valueIndex,
+				state,
+				callback,
+				exception);
 		}
 		COLLECTION_RELEASE(properties, &propertyItem);
 	}
 	return count;
 }
 
+uint32_t fiftyoneDegreesProfileIterateProfilesForPropertyAndValueWithIndex(
+	fiftyoneDegreesCollection * const strings,
+	fiftyoneDegreesCollection * const properties,
+	fiftyoneDegreesCollection * const propertyTypes,
+	fiftyoneDegreesCollection * const values,
+	fiftyoneDegreesCollection * const profiles,
+	const fiftyoneDegreesCollection * const profileOffsets,
+	const fiftyoneDegreesProfileOffsetValueExtractor offsetValueExtractor,
+	fiftyoneDegreesPropertiesAvailable * const available,
+	fiftyoneDegreesIndicesPropertyValue * const index,
+	const char * const propertyName,
+	const char * const valueName,
+	void *const state,
+	const fiftyoneDegreesProfileIterateMethod callback,
+	fiftyoneDegreesException * const exception) {
+	const int availablePropertyIndex = index == NULL || available == NULL ?
+		-1 : PropertiesGetRequiredPropertyIndexFromName(available, propertyName);
+
+	// Properties which are not in the index are found by searching the
+	// values of the property.
+	if (availablePropertyIndex < 0) {
+		return ProfileIterateProfilesForPropertyWithTypeAndValueAndOffsetExtractor(
+			strings,
+			properties,
+			propertyTypes,
+			values,
+			profiles,
+			profileOffsets,
+			offsetValueExtractor,
+			propertyName,
+			valueName,
+			state,
+			callback,
+			exception);
+	}
+	const long valueIndex = IndicesPropertyValueLookup(
+		index,
+		values,
+		strings,
+		(uint32_t)availablePropertyIndex,
+		valueName,
+		exception);
+	if (valueIndex < 0 || EXCEPTION_FAILED) {
+		return 0;
+	}
+	return iterateProfilesWithValueIndex(
+		profiles,
+		profileOffsets,
+		offsetValueExtractor,
+		(uint32_t)valueIndex,
+		state,
+		callback,
+		exception);
+}
+
 uint32_t fiftyoneDegreesProfileIterateValueIndexes(
 	fiftyoneDegreesProfile* profile,
 	fiftyoneDegreesPropertiesAvailable* available,
@@ -622,7 +748,9 @@ uint32_t fiftyoneDegreesProfileIterateValueIndexes(
 
 		// If the value does relate to an available property then call the 
 		// callback.
-		if (isAvailableProperty(available, (uint32_t)value->propertyIndex)) {
+		if (PropertiesGetRequiredPropertyIndexFromPropertyIndex(
+			available,
+			(uint32_t)value->propertyIndex) >= 0) {
 			cont = callback(state, valueIndex);
 			count++;
 		}
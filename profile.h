@@ -121,7 +121,7 @@ typedef uint32_t (*fiftyoneDegreesProfileOffsetValueExtractor)(const void *rawPr
  * @param rawProfileOffset a "raw" ProfileOffset retrieved from `profileOffsets`
  * @return Offset to the profile in the profiles structure
  */
-uint32_t fiftyoneDegreesProfileOffsetToPureOffset(const void *rawProfileOffset);
+EXTERNAL uint32_t fiftyoneDegreesProfileOffsetToPureOffset(const void *rawProfileOffset);
 
 /**
  * Function that extracts "pure" profile offset
@@ -130,7 +130,7 @@ uint32_t fiftyoneDegreesProfileOffsetToPureOffset(const void *rawProfileOffset);
  * @param rawProfileOffset a "raw" value retrieved from `profileOffsets`
  * @return Offset to the profile in the profiles structure
  */
-uint32_t fiftyoneDegreesProfileOffsetAsPureOffset(const void *rawProfileOffset);
+EXTERNAL uint32_t fiftyoneDegreesProfileOffsetAsPureOffset(const void *rawProfileOffset);
 
 /**
  * Definition of a callback function which is passed an item of a type 
@@ -332,6 +332,49 @@ EXTERNAL uint32_t fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndVal
 	fiftyoneDegreesProfileIterateMethod callback,
 	fiftyoneDegreesException *exception);
 
+/**
+ * Iterate all profiles which contain the specified value, calling the callback
+ * method for each. Where the property is one of the available properties the
+ * value is found with a single probe of the index created by
+ * #fiftyoneDegreesIndicesPropertyValueCreate. Otherwise the values of the
+ * property are searched as for
+ * #fiftyoneDegreesProfileIterateProfilesForPropertyWithTypeAndValueAndOffsetExtractor.
+ * @param strings collection containing the strings referenced properties and
+ * values
+ * @param properties collection containing all properties
+ * @param propertyTypes collection containing types for all properties
+ * @param values collection containing all values
+ * @param profiles collection containing the profiles referenced by the profile
+ * offsets
+ * @param profileOffsets collection containing all profile offsets (any form)
+ * @param offsetValueExtractor converts `profileOffsets` value to "pure" offset
+ * @param available properties used to create the index
+ * @param index of the values of the available properties, or NULL to search
+ * the values of the property
+ * @param propertyName name of the property the value relates to
+ * @param valueName name of the value to iterate the profiles for
+ * @param state pointer to data needed by the callback method
+ * @param callback method to be called for each matching profile
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h
+ * @return the number matching profiles which have been iterated
+ */
+EXTERNAL uint32_t fiftyoneDegreesProfileIterateProfilesForPropertyAndValueWithIndex(
+	fiftyoneDegreesCollection *strings,
+	fiftyoneDegreesCollection *properties,
+	fiftyoneDegreesCollection *propertyTypes,
+	fiftyoneDegreesCollection *values,
+	fiftyoneDegreesCollection *profiles,
+	const fiftyoneDegreesCollection *profileOffsets,
+	fiftyoneDegreesProfileOffsetValueExtractor offsetValueExtractor,
+	fiftyoneDegreesPropertiesAvailable *available,
+	fiftyoneDegreesIndicesPropertyValue *index,
+	const char *propertyName,
+	const char* valueName,
+	void *state,
+	fiftyoneDegreesProfileIterateMethod callback,
+	fiftyoneDegreesException *exception);
+
 /**
  * Iterate all profiles which contain the specified value, calling the callback
  * method for each.
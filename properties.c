@@ -67,6 +67,12 @@ static PropertiesAvailable* initRequiredPropertiesMemory(uint32_t count) {
 		available->count = 0;
 		available->capacity = count;
 		available->items = (PropertyAvailable*)(available + 1);
+		available->nameSlots = NULL;
+		available->nameSlotsMask = 0;
+		available->nameDisplacements = NULL;
+		available->nameBucketsMask = 0;
+		available->requiredIndexes = NULL;
+		available->requiredIndexesCount = 0;
 		for (i = 0; i < available->capacity; i++) {
 			// Initialize the evidence properties to prevent them from being
 			// freed in the case that they are never allocated.
@@ -391,6 +397,183 @@ static void initRequiredProperties(
 	}
 }
 
+// Largest number of slots in the name hash table per name before a binary
+// search is used instead.
+#define NAME_SLOTS_MAX_RATIO 16
+
+// Case insensitive hash of the name. The upper 32 bits, used for the step
+// between slots, are mixed from the lower so the step differs for names in
+// the same slot.
+static uint64_t hashName(const char *name) {
+	const uint32_t hash = StringHashCaseInsensitive(name, strlen(name));
+	return ((uint64_t)((hash * 0x85EBCA6Bu) ^ (hash >> 13)) << 32) | hash;
+}
+
+// Bucket for the name hash.
+static uint32_t getNameBucket(uint64_t hash, uint32_t mask) {
+	return (uint32_t)((hash * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+// Slot for the name hash with the displacement of its bucket. The step is
+// odd so every slot is visited as the displacement increases.
+static uint32_t getNameSlot(uint64_t hash, uint32_t displacement, uint32_t mask) {
+	return ((uint32_t)hash + displacement * ((uint32_t)(hash >> 32) | 1)) &
+		mask;
+}
+
+// Sorts the packed bucket order keys in ascending order.
+static int compareNameOrder(const void *a, const void *b) {
+	const uint64_t ai = *(const uint64_t*)a;
+	const uint64_t bi = *(const uint64_t*)b;
+	return ai < bi ? -1 : ai > bi ? 1 : 0;
+}
+
+// Index of the name in the packed order key.
+#define NAME_ORDER_INDEX(k) ((uint32_t)((k) & 0xFFFFFF))
+
+// Bucket of the name in the packed order key.
+#define NAME_ORDER_BUCKET(k) ((uint32_t)(((k) >> 24) & 0xFFFFFF))
+
+// Finds a displacement for each bucket of names, largest buckets first, which
+// places all the names in the bucket in empty slots. Returns false if a
+// bucket can't be placed in the slots available.
+static bool placeNames(
+	PropertiesAvailable *available,
+	const uint64_t *hashes,
+	uint64_t *order) {
+	uint32_t i, j, start, end, d, slot, bucket;
+	const uint32_t slotsMask = available->nameSlotsMask;
+	const uint32_t bucketsMask = available->nameBucketsMask;
+	uint32_t *slots = available->nameSlots;
+	uint32_t *sizes = available->nameDisplacements;
+
+	// Order the names by bucket with the largest buckets first. The
+	// displacements are used to count the size of each bucket until they
+	// are set.
+	for (i = 0; i < available->count; i++) {
+		sizes[getNameBucket(hashes[i], bucketsMask)]++;
+	}
+	for (i = 0; i < available->count; i++) {
+		bucket = getNameBucket(hashes[i], bucketsMask);
+		order[i] = ((uint64_t)(0xFFFF - sizes[bucket]) << 48) |
+			((uint64_t)bucket << 24) | i;
+	}
+	qsort(order, available->count, sizeof(uint64_t), compareNameOrder);
+
+	for (start = 0; start < available->count; start = end) {
+		bucket = NAME_ORDER_BUCKET(order[start]);
+		end = start + 1;
+		while (end < available->count &&
+			NAME_ORDER_BUCKET(order[end]) == bucket) {
+			end++;
+		}
+		for (d = 0; d <= slotsMask; d++) {
+			for (i = start; i < end; i++) {
+				slot = getNameSlot(
+					hashes[NAME_ORDER_INDEX(order[i])],
+					d,
+					slotsMask);
+				if (slots[slot] != 0) {
+					break;
+				}
+				slots[slot] = NAME_ORDER_INDEX(order[i]) + 1;
+			}
+			if (i == end) {
+				break;
+			}
+			// Undo the names placed with this displacement.
+			for (j = start; j < i; j++) {
+				slots[getNameSlot(
+					hashes[NAME_ORDER_INDEX(order[j])],
+					d,
+					slotsMask)] = 0;
+			}
+		}
+		if (d > slotsMask) {
+			return false;
+		}
+		sizes[bucket] = d;
+	}
+	return true;
+}
+
+// Creates a perfect hash table of the required property names so that a name
+// is found with a single probe. Names are grouped into buckets of about two,
+// and each bucket has a displacement which places its names in empty slots.
+// The table doubles in size until every bucket is placed. If it can't be, or
+// any name is missing, names are found with a binary search.
+static void initNameSlots(PropertiesAvailable *available) {
+	uint32_t i, slots = 2, buckets = 1;
+	uint64_t *hashes;
+	if (available->count >= 0xFFFF) {
+		return;
+	}
+	for (i = 0; i < available->count; i++) {
+		if (available->items[i].name.data.ptr == NULL) {
+			return;
+		}
+	}
+	while (slots < available->count * 2) {
+		slots <<= 1;
+	}
+	while (buckets * 2 < available->count) {
+		buckets <<= 1;
+	}
+	hashes = (uint64_t*)Malloc(sizeof(uint64_t) * (available->count + 1) * 2);
+	if (hashes == NULL) {
+		return;
+	}
+	for (i = 0; i < available->count; i++) {
+		hashes[i] = hashName(STRING(available->items[i].name.data.ptr));
+	}
+	while (slots <= available->count * NAME_SLOTS_MAX_RATIO || slots == 2) {
+		available->nameSlots = (uint32_t*)Malloc(
+			sizeof(uint32_t) * (slots + buckets));
+		if (available->nameSlots == NULL) {
+			break;
+		}
+		memset(available->nameSlots, 0, sizeof(uint32_t) * (slots + buckets));
+		available->nameSlotsMask = slots - 1;
+		available->nameDisplacements = available->nameSlots + slots;
+		available->nameBucketsMask = buckets - 1;
+		if (placeNames(available, hashes, hashes + available->count + 1)) {
+			break;
+		}
+		Free(available->nameSlots);
+		available->nameSlots = NULL;
+		available->nameDisplacements = NULL;
+		slots <<= 1;
+	}
+	Free(hashes);
+}
+
+// Creates the table from property index to required property index so that
+// values can be checked against the required properties without a search.
+static void initRequiredIndexes(PropertiesAvailable *available) {
+	uint32_t i, count = 0;
+	for (i = 0; i < available->count; i++) {
+		if ((int)available->items[i].propertyIndex >= 0 &&
+			available->items[i].propertyIndex >= count) {
+			count = available->items[i].propertyIndex + 1;
+		}
+	}
+	if (count == 0) {
+		return;
+	}
+	available->requiredIndexes = (uint32_t*)Malloc(sizeof(uint32_t) * count);
+	if (available->requiredIndexes == NULL) {
+		return;
+	}
+	memset(available->requiredIndexes, 0, sizeof(uint32_t) * count);
+	available->requiredIndexesCount = count;
+	for (i = 0; i < available->count; i++) {
+		if ((int)available->items[i].propertyIndex >= 0) {
+			available->requiredIndexes[
+				available->items[i].propertyIndex] = i + 1;
+		}
+	}
+}
+
 static int comparePropertyNamesAscendingSearch(const void *a, const void *b) {
 	char *as = (char*)a;
 	char *bs = &((String*)((PropertyAvailable*)b)->name.data.ptr)->value;
@@ -442,6 +625,8 @@ fiftyoneDegreesPropertiesAvailable* fiftyoneDegreesPropertiesCreate(
 	// index.
 	if (available != NULL) {
 		initRequiredProperties(&source, available);
+		initNameSlots(available);
+		initRequiredIndexes(available);
 	}
 
 	return available;
@@ -461,6 +646,23 @@ int fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(
 	fiftyoneDegreesPropertiesAvailable *available,
 	const char *propertyName) {
 	int requiredPropertyIndex;
+	uint32_t slot;
+	const char *name;
+	if (available->nameSlots != NULL) {
+		const uint64_t hash = hashName(propertyName);
+		slot = available->nameSlots[getNameSlot(
+			hash,
+			available->nameDisplacements[
+				getNameBucket(hash, available->nameBucketsMask)],
+			available->nameSlotsMask)];
+		if (slot != 0) {
+			name = STRING(available->items[slot - 1].name.data.ptr);
+			if (StringCompare(propertyName, name) == 0) {
+				return (int)slot - 1;
+			}
+		}
+		return -1;
+	}
 	PropertyAvailable *found = (PropertyAvailable*)
 		bsearch(
 			propertyName,
@@ -494,6 +696,24 @@ int fiftyoneDegreesPropertiesGetPropertyIndexFromName(
 	return -1;
 }
 
+int fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex(
+	fiftyoneDegreesPropertiesAvailable *available,
+	uint32_t propertyIndex) {
+	uint32_t i;
+	if (available->requiredIndexes != NULL) {
+		if (propertyIndex < available->requiredIndexesCount) {
+			return (int)available->requiredIndexes[propertyIndex] - 1;
+		}
+		return -1;
+	}
+	for (i = 0; i < available->count; i++) {
+		if (available->items[i].propertyIndex == propertyIndex) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
 fiftyoneDegreesString* fiftyoneDegreesPropertiesGetNameFromRequiredIndex(
 	fiftyoneDegreesPropertiesAvailable *available,
 	int requiredPropertyIndex) {
@@ -525,6 +745,12 @@ void fiftyoneDegreesPropertiesFree(
 				Free(available->items[i].evidenceProperties);
 			}
 		}
+		if (available->nameSlots != NULL) {
+			Free(available->nameSlots);
+		}
+		if (available->requiredIndexes != NULL) {
+			Free(available->requiredIndexes);
+		}
 		Free(available);
 	}
 }
\ No newline at end of file
@@ -162,9 +162,31 @@ typedef struct fiftyone_degrees_property_available_t {
                          function */
 } fiftyoneDegreesPropertyAvailable;
 
-FIFTYONE_DEGREES_ARRAY_TYPE(fiftyoneDegreesPropertyAvailable,)
+FIFTYONE_DEGREES_ARRAY_TYPE(
+	fiftyoneDegreesPropertyAvailable,
+	uint32_t *nameSlots; /**< Perfect hash table of the property names where
+						 each slot is the required property index plus 1 or
+						 0 if empty. NULL if not created in which case a
+						 binary search is used */
+	uint32_t nameSlotsMask; /**< Number of slots in nameSlots - 1 */
+	uint32_t *nameDisplacements; /**< Displacement for each bucket of names
+								 which places every name in the bucket in a
+								 different empty slot */
+	uint32_t nameBucketsMask; /**< Number of buckets - 1 */
+	uint32_t *requiredIndexes; /**< Table from the property index to the
+							   required property index plus 1 or 0 if the
+							   property is not required. NULL if not created
+							   in which case the items are searched */
+	uint32_t requiredIndexesCount; /**< Number of entries in
+								   requiredIndexes */)
 
-/** Array of properties which are available in a data set. */
+/**
+ * Array of properties which are available in a data set. Arrays created with
+ * #fiftyoneDegreesPropertiesCreate have the name and required index tables.
+ * Arrays created any other way, for example with
+ * #FIFTYONE_DEGREES_ARRAY_CREATE which sets the tables to NULL, are searched
+ * instead.
+ */
 typedef fiftyoneDegreesPropertyAvailableArray 
 fiftyoneDegreesPropertiesAvailable;
 
@@ -278,6 +300,19 @@ EXTERNAL int fiftyoneDegreesPropertiesGetPropertyIndexFromRequiredIndex(
 	fiftyoneDegreesPropertiesAvailable *available,
 	int requiredPropertyIndex);
 
+/**
+ * Maps the index in the source data structure to the required property index.
+ * A table lookup is used so this is suitable for checking every value of a
+ * profile.
+ * @param available properties instance
+ * @param propertyIndex index of the property in the source data structure
+ * @return 0 based index of the property in the required properties or -1 if
+ * not available
+ */
+EXTERNAL int fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex(
+	fiftyoneDegreesPropertiesAvailable *available,
+	uint32_t propertyIndex);
+
 /**
  * Gets the name as a string from the required property index.
  * @param available properties instance
@@ -25,6 +25,7 @@
 #include "string.h"
 #include "fiftyone.h"
 #include <inttypes.h>
+#include <limits.h>
 
 #include "collectionKeyTypes.h"
 
@@ -87,25 +88,215 @@ static double toDeclination(const StoredBinaryValue * const value) {
     return shortToDouble(value, 90);
 }
 
-int fiftyoneDegreesStoredBinaryValueCompareWithString(
+// Result of comparing the integer part of a value with the target when the
+// characters after it must also be compared.
+#define COMPARE_UNKNOWN INT_MIN
+
+// Number of digits the target can have to be compared numerically.
+#define TARGET_MAX_DIGITS 19
+
+// Smallest distance from an integer that a floating point value can be at 
+// and still be compared numerically. Closer values might round to the integer
+// when formatted.
+#define FRACTION_MARGIN 1e-9
+
+// Powers of ten which fit in 64 bits.
+static const uint64_t powersOfTen[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+static int countDigits(uint64_t value) {
+    int digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        digits++;
+    }
+    return digits;
+}
+
+// Compares the text form of the integer with the target string in the same
+// way as strcmp without forming the text. The text is followed by a decimal
+// point if hasFraction is true, otherwise it ends. Returns COMPARE_UNKNOWN if
+// the target continues with a decimal point after the same integer so that 
+// the fractions must be compared.
+static int compareIntegerWithTarget(
+    const int64_t integer,
+    const bool hasFraction,
+    const StoredBinaryValueTarget * const target) {
+    const bool isNegative = integer < 0;
+    const uint64_t magnitude = isNegative ?
+        0 - (uint64_t)integer : (uint64_t)integer;
+    const int digits = countDigits(magnitude);
+    const unsigned char next = (unsigned char)*target->rest;
+    uint64_t prefix;
+
+    // A minus sign is ordered before any digit.
+    if (isNegative != target->isNegative) {
+        return isNegative ? -1 : 1;
+    }
+
+    // Compare the digits that both strings have at the same positions. If
+    // these are equal then the shorter run of digits is followed by a 
+    // character that is compared with a digit in the other string.
+    if (digits < target->digits) {
+        prefix = target->magnitude / powersOfTen[target->digits - digits];
+        if (magnitude != prefix) {
+            return magnitude < prefix ? -1 : 1;
+        }
+        return -1; // End or decimal point is before a digit
+    }
+    if (digits > target->digits) {
+        prefix = magnitude / powersOfTen[digits - target->digits];
+        if (prefix != target->magnitude) {
+            return prefix < target->magnitude ? -1 : 1;
+        }
+        return next < '0' ? 1 : -1;
+    }
+    if (magnitude != target->magnitude) {
+        return magnitude < target->magnitude ? -1 : 1;
+    }
+
+    // The integer text is identical so compare the character that follows.
+    if (hasFraction == false) {
+        return next == '\0' ? 0 : -1;
+    }
+    if (next != '.') {
+        return (unsigned char)'.' < next ? -1 : 1;
+    }
+    return COMPARE_UNKNOWN;
+}
+
+// Compares the text form of the floating point value, formatted with the 
+// decimal places provided, with the target if this can be done from the
+// integer part alone. Otherwise returns COMPARE_UNKNOWN.
+static int compareDoubleWithTarget(
+    const double value,
+    const uint8_t decimalPlaces,
+    const StoredBinaryValueTarget * const target) {
+    const int places = MAX_DOUBLE_DECIMAL_PLACES < decimalPlaces ?
+        MAX_DOUBLE_DECIMAL_PLACES : decimalPlaces;
+    double margin;
+    if (places <= 0 || !(value > -INT32_MAX && value < INT32_MAX)) {
+        return COMPARE_UNKNOWN;
+    }
+
+    // The formatter writes the integer part, followed by a decimal point and
+    // digits if the fraction is not zero. Fractions which could round to 
+    // zero or one might change the integer part or remove the digits.
+    const int intPart = (int)value;
+    double fracPart = value - intPart;
+    if (fracPart < 0) {
+        fracPart = -fracPart;
+    }
+    if (fracPart == 0) {
+        return compareIntegerWithTarget(intPart, false, target);
+    }
+    if (intPart == 0 && value < 0) {
+        // Written as "-0." followed by digits which the integer can't show.
+        return COMPARE_UNKNOWN;
+    }
+    margin = 2.0 / (double)powersOfTen[places];
+    if (margin < FRACTION_MARGIN) {
+        margin = FRACTION_MARGIN;
+    }
+    if (fracPart < margin || fracPart > 1 - margin) {
+        return COMPARE_UNKNOWN;
+    }
+    return compareIntegerWithTarget(intPart, true, target);
+}
+
+fiftyoneDegreesStoredBinaryValueTarget*
+fiftyoneDegreesStoredBinaryValueTargetInit(
+    StoredBinaryValueTarget * const target,
+    const char * const value) {
+    const char *current = value;
+    target->value = value;
+    target->isNegative = *current == '-';
+    if (target->isNegative) {
+        current++;
+    }
+    target->magnitude = 0;
+    target->digits = 0;
+    while (*current >= '0' && *current <= '9' &&
+        target->digits <= TARGET_MAX_DIGITS) {
+        target->magnitude = target->magnitude * 10 + (uint64_t)(*current - '0');
+        target->digits++;
+        current++;
+    }
+    target->rest = current;
+    target->isNumeric = 
+        target->digits > 0 && target->digits <= TARGET_MAX_DIGITS;
+    return target;
+}
+
+int fiftyoneDegreesStoredBinaryValueCompareWithTarget(
     const StoredBinaryValue * const value,
     const PropertyValueType storedValueType,
-    const char * const target,
+    const StoredBinaryValueTarget * const target,
     StringBuilder * const tempBuilder,
     Exception * const exception) {
+    int result = COMPARE_UNKNOWN;
 
     if (storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
         const int cmpResult = strncmp(
             &value->stringValue.value,
-            target,
+            target->value,
             value->stringValue.size);
         return cmpResult;
     }
     EXCEPTION_CLEAR;
     const uint8_t decimalPlaces = (
-        tempBuilder->length < MAX_DOUBLE_DECIMAL_PLACES
-        ? (uint8_t)tempBuilder->length
-        : MAX_DOUBLE_DECIMAL_PLACES);
+        tempBuilder == NULL ||
+        tempBuilder->length > MAX_DOUBLE_DECIMAL_PLACES
+        ? MAX_DOUBLE_DECIMAL_PLACES
+        : (uint8_t)tempBuilder->length);
+
+    // Compare numerically where the result is certain to be the same as 
+    // comparing the text.
+    if (target->isNumeric) {
+        switch (storedValueType) {
+        case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER:
+            result = compareIntegerWithTarget(value->intValue, false, target);
+            break;
+        case FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_BYTE:
+            result = compareIntegerWithTarget(value->byteValue, false, target);
+            break;
+        case FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT:
+        case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_AZIMUTH:
+        case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DECLINATION:
+            result = compareDoubleWithTarget(
+                StoredBinaryValueToDoubleOrDefault(value, storedValueType, 0),
+                decimalPlaces,
+                target);
+            break;
+        default:
+            break;
+        }
+        if (result != COMPARE_UNKNOWN) {
+            return result;
+        }
+    }
+
+    // Otherwise form the text and compare it.
     StringBuilderAddStringValue(
         tempBuilder,
         value,
@@ -113,12 +304,28 @@ int fiftyoneDegreesStoredBinaryValueCompareWithString(
         decimalPlaces,
         exception);
     StringBuilderComplete(tempBuilder);
-    const int result = (EXCEPTION_OKAY
-        ? strcmp(tempBuilder->ptr, target)
+    result = (EXCEPTION_OKAY
+        ? strcmp(tempBuilder->ptr, target->value)
         : -1);
     return result;
 }
 
+int fiftyoneDegreesStoredBinaryValueCompareWithString(
+    const StoredBinaryValue * const value,
+    const PropertyValueType storedValueType,
+    const char * const target,
+    StringBuilder * const tempBuilder,
+    Exception * const exception) {
+    StoredBinaryValueTarget parsed;
+    StoredBinaryValueTargetInit(&parsed, target);
+    return StoredBinaryValueCompareWithTarget(
+        value,
+        storedValueType,
+        &parsed,
+        tempBuilder,
+        exception);
+}
+
 int fiftyoneDegreesStoredBinaryValueToIntOrDefault(
     const fiftyoneDegreesStoredBinaryValue * const value,
     const fiftyoneDegreesPropertyValueType storedValueType,
@@ -127,6 +127,58 @@ EXTERNAL const fiftyoneDegreesStoredBinaryValue* fiftyoneDegreesStoredBinaryValu
  fiftyoneDegreesCollectionItem *item,
  fiftyoneDegreesException *exception);
 
+/**
+ * Target string parsed once so that it can be compared with many binary
+ * values of numeric types without rendering each value as text. The target is
+ * split into an optional minus sign, a run of decimal digits, and the
+ * remaining characters.
+ */
+typedef struct fiftyone_degrees_stored_binary_value_target_t {
+ const char *value; /**< The target string */
+ bool isNumeric; /**< True if the target starts with a run of digits which
+                 can be compared numerically */
+ bool isNegative; /**< True if the target starts with a minus sign */
+ uint64_t magnitude; /**< Value of the run of digits */
+ int digits; /**< Number of characters in the run of digits */
+ const char *rest; /**< First character after the run of digits */
+} fiftyoneDegreesStoredBinaryValueTarget;
+
+/**
+ * Parses the target string so that it can be compared using
+ * #fiftyoneDegreesStoredBinaryValueCompareWithTarget.
+ * @param target structure to initialise
+ * @param value the target search value which must remain valid for the
+ * lifetime of the target structure
+ * @return pointer to the target passed
+ */
+EXTERNAL fiftyoneDegreesStoredBinaryValueTarget*
+fiftyoneDegreesStoredBinaryValueTargetInit(
+ fiftyoneDegreesStoredBinaryValueTarget *target,
+ const char *value);
+
+/**
+ * Function to compare the current binary value to the target using the text
+ * format. The result is the same as comparing the text form of the value with
+ * the target string. Integers, and the integer part of floating point
+ * values, are compared numerically with the parsed target so the value is
+ * only rendered as text when the integer part matches or the value is within
+ * rounding distance of an integer.
+ * @param value the current binary value item
+ * @param storedValueType format of byte array representation
+ * @param target initialised with #fiftyoneDegreesStoredBinaryValueTargetInit
+ * @param tempBuilder temporary builder to stringify value into.
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return 0 if they are equal, otherwise negative
+ * for smaller and positive for bigger
+ */
+EXTERNAL int fiftyoneDegreesStoredBinaryValueCompareWithTarget(
+ const fiftyoneDegreesStoredBinaryValue *value,
+ fiftyoneDegreesPropertyValueType storedValueType,
+ const fiftyoneDegreesStoredBinaryValueTarget *target,
+ fiftyoneDegreesStringBuilder *tempBuilder,
+ fiftyoneDegreesException *exception);
+
 /**
  * Function to compare the current binary value to the
  * target string value using the text format.
@@ -25,9 +25,235 @@
 #include "string.h"
 #include "fiftyone.h"
 #include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include "collectionKeyTypes.h"
 
+/*
+ * Select the vector instructions used to compare strings. SSE2 is always
+ * available on 64 bit x86 and NEON on 64 bit ARM. AVX2 is only used where the
+ * compiler supports target attributes and is selected at runtime. Defining
+ * FIFTYONE_DEGREES_STRING_NO_SIMD uses the scalar methods only.
+ *
+ * A vector load never crosses a page boundary, so it can't fault, but it can
+ * read characters after a null terminator in the same page. AddressSanitizer
+ * reports these reads so the scalar methods are used when it is enabled.
+ */
+#if defined(__SANITIZE_ADDRESS__)
+#define FIFTYONE_DEGREES_STRING_NO_SIMD
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define FIFTYONE_DEGREES_STRING_NO_SIMD
+#endif
+#endif
+
+#ifndef FIFTYONE_DEGREES_STRING_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_SSE2
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__x86_64__) || defined(__i386__))
+#define STRING_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define STRING_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+// Compares the characters ignoring case returning the difference.
+static int compareChar(char a, char b) {
+	return tolower(a) - tolower(b);
+}
+
+#if defined(STRING_SSE2) || defined(STRING_NEON)
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Smallest page size of the supported platforms.
+#define STRING_PAGE_SIZE 4096
+
+// Returns true if reading the number of bytes from the pointer could cross
+// into the next page.
+static bool crossesPage(const char *p, size_t bytes) {
+	return ((uintptr_t)p & (STRING_PAGE_SIZE - 1)) > STRING_PAGE_SIZE - bytes;
+}
+
+// Returns the index of the lowest bit set in the non zero mask.
+static int firstBit(uint64_t mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+#ifdef _WIN64
+	_BitScanForward64(&index, mask);
+#else
+	if ((uint32_t)mask != 0) {
+		_BitScanForward(&index, (uint32_t)mask);
+	}
+	else {
+		_BitScanForward(&index, (uint32_t)(mask >> 32));
+		index += 32;
+	}
+#endif
+	return (int)index;
+#else
+	return __builtin_ctzll(mask);
+#endif
+}
+
+#endif
+
+#ifdef STRING_SSE2
+
+#define STRING_WIDTH 16
+
+// Folds the upper case ASCII characters in the vector to lower case.
+static __m128i foldSse2(__m128i v) {
+	__m128i upper = _mm_and_si128(
+		_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+		_mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+	return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+// Returns a bit for each character that matches ignoring case and is not a
+// null.
+static uint64_t equalMask(const char *a, const char *b) {
+	__m128i va = _mm_loadu_si128((const __m128i*)a);
+	__m128i vb = _mm_loadu_si128((const __m128i*)b);
+	return (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_andnot_si128(
+		_mm_cmpeq_epi8(va, _mm_setzero_si128()),
+		_mm_cmpeq_epi8(foldSse2(va), foldSse2(vb))));
+}
+
+#define STRING_ALL_BITS 0xFFFFull
+#define STRING_BITS_PER_CHAR 1
+
+#elif defined(STRING_NEON)
+
+#define STRING_WIDTH 16
+
+// Folds the upper case ASCII characters in the vector to lower case.
+static uint8x16_t foldNeon(uint8x16_t v) {
+	uint8x16_t upper = vcltq_u8(
+		vsubq_u8(v, vdupq_n_u8('A')), 
+		vdupq_n_u8(26));
+	return vorrq_u8(v, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+// Converts the comparison result to a mask with four bits for each character.
+static uint64_t toMask(uint8x16_t v) {
+	return vget_lane_u64(vreinterpret_u64_u8(
+		vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0);
+}
+
+// Returns four bits for each character that matches ignoring case and is not
+// a null.
+static uint64_t equalMask(const char *a, const char *b) {
+	uint8x16_t va = vld1q_u8((const uint8_t*)a);
+	uint8x16_t vb = vld1q_u8((const uint8_t*)b);
+	return toMask(vandq_u8(
+		vtstq_u8(va, va),
+		vceqq_u8(foldNeon(va), foldNeon(vb))));
+}
+
+#define STRING_ALL_BITS 0xFFFFFFFFFFFFFFFFull
+#define STRING_BITS_PER_CHAR 4
+
+#endif
+
+#ifdef STRING_AVX2
+
+// Returns true if the processor supports AVX2 instructions.
+static bool hasAvx2(void) {
+	return __builtin_cpu_supports("avx2");
+}
+
+// Returns the number of characters from the start that match ignoring case
+// and are not null, considering whole vectors of 32 characters only. Stops
+// before a vector that would cross a page.
+__attribute__((target("avx2")))
+static size_t equalLengthAvx2(const char *a, const char *b, size_t length) {
+	size_t i = 0;
+	const __m256i before = _mm256_set1_epi8('A' - 1);
+	const __m256i after = _mm256_set1_epi8('Z' + 1);
+	const __m256i bit = _mm256_set1_epi8(0x20);
+	__m256i va, vb, nul;
+	uint32_t mask;
+	for (; i + 32 <= length; i += 32) {
+		if (crossesPage(a + i, 32) || crossesPage(b + i, 32)) {
+			break;
+		}
+		va = _mm256_loadu_si256((const __m256i*)(a + i));
+		vb = _mm256_loadu_si256((const __m256i*)(b + i));
+		nul = _mm256_cmpeq_epi8(va, _mm256_setzero_si256());
+		va = _mm256_or_si256(va, _mm256_and_si256(bit, _mm256_and_si256(
+			_mm256_cmpgt_epi8(va, before),
+			_mm256_cmpgt_epi8(after, va))));
+		vb = _mm256_or_si256(vb, _mm256_and_si256(bit, _mm256_and_si256(
+			_mm256_cmpgt_epi8(vb, before),
+			_mm256_cmpgt_epi8(after, vb))));
+		mask = ~(uint32_t)_mm256_movemask_epi8(
+			_mm256_andnot_si256(nul, _mm256_cmpeq_epi8(va, vb)));
+		if (mask != 0) {
+			return i + (size_t)__builtin_ctz(mask);
+		}
+	}
+	return i;
+}
+
+#endif
+
+#ifdef STRING_WIDTH
+
+// Returns the index of the first character from start that does not match
+// ignoring case or is a null, or the index where fewer than a vector of
+// characters remain. Nothing after the length is read as the characters might
+// not be null terminated, so the caller compares the remaining characters one
+// at a time. Where a vector would cross a page the characters are compared
+// one at a time until it would not, so nothing is read from a page after a
+// difference or null.
+static size_t equalLength(
+	const char *a, 
+	const char *b, 
+	size_t start, 
+	size_t length) {
+	size_t i = start;
+	uint64_t mask;
+	while (i + STRING_WIDTH <= length) {
+		if (crossesPage(a + i, STRING_WIDTH) ||
+			crossesPage(b + i, STRING_WIDTH)) {
+			if (compareChar(a[i], b[i]) != 0 || a[i] == '\0') {
+				return i;
+			}
+			i++;
+		}
+		else {
+			mask = equalMask(a + i, b + i) ^ STRING_ALL_BITS;
+			if (mask != 0) {
+				return i + (size_t)(firstBit(mask) / STRING_BITS_PER_CHAR);
+			}
+			i += STRING_WIDTH;
+		}
+	}
+	return i;
+}
+
+#endif
+
+// Returns true if b is the start of a ignoring case.
+static bool startsWith(const char *a, const char *b) {
+	for (; *a != '\0' && *b != '\0'; a++, b++) {
+		if (compareChar(*a, *b) != 0) {
+			return false;
+		}
+	}
+	return *b == '\0';
+}
+
 uint32_t fiftyoneDegreesStringGetFinalSize(
 	const void *initial,
     Exception * const exception) {
@@ -72,8 +298,13 @@ const fiftyoneDegreesString* fiftyoneDegreesStringGet(
 }
 
 int fiftyoneDegreesStringCompare(const char *a, const char *b) {
+#ifdef STRING_WIDTH
+	size_t i = equalLength(a, b, 0, SIZE_MAX);
+	a += i;
+	b += i;
+#endif
 	for (; *a != '\0' && *b != '\0'; a++, b++) {
-		int d = tolower(*a) - tolower(*b);
+		int d = compareChar(*a, *b);
 		if (d != 0) {
 			return d;
 		}
@@ -88,34 +319,160 @@ int fiftyoneDegreesStringCompareLength(
 	char const *a, 
 	char const *b, 
 	size_t length) {
-	size_t i;
-	for (i = 0; i < length; a++, b++, i++) {
-		int d = tolower(*a) - tolower(*b);
+	size_t i = 0;
+#ifdef STRING_AVX2
+	if (length >= 32 && hasAvx2()) {
+		i = equalLengthAvx2(a, b, length);
+	}
+#endif
+#ifdef STRING_WIDTH
+	i = equalLength(a, b, i, length);
+#endif
+	for (; i < length && a[i] != '\0'; i++) {
+		int d = compareChar(a[i], b[i]);
 		if (d != 0) {
 			return d;
 		}
 	}
-	return 0;
+	return i < length ? compareChar(a[i], b[i]) : 0;
 }
 
-const char *fiftyoneDegreesStringSubString(const char *a, const char *b) {
-	int d;
-	const char *a1, *b1;
-	for (; *a != '\0' && *b != '\0'; a++) {
-		d = tolower(*a) - tolower(*b);
-		if (d == 0) {
-			a1 = a + 1;
-			b1 = b + 1;
-			for (; *a1 != '\0' && *b1 != '\0'; a1++, b1++) {
-				d = tolower(*a1) - tolower(*b1);
-				if (d != 0) {
-					break;
+// FNV-1a hash of the characters. If fold is set then each upper case ASCII
+// character is folded to lower case.
+static uint32_t hashLength(const char *value, size_t length, bool fold) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++) {
+		uint8_t c = (uint8_t)value[i];
+		if (fold && c >= 'A' && c <= 'Z') {
+			c |= 0x20;
+		}
+		hash ^= c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+uint32_t fiftyoneDegreesStringHash(const char *value, size_t length) {
+	return hashLength(value, length, false);
+}
+
+uint32_t fiftyoneDegreesStringHashCaseInsensitive(
+	const char *value,
+	size_t length) {
+	return hashLength(value, length, true);
+}
+
+// Powers of ten which are exactly represented as doubles.
+static const double exactPowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+	1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+bool fiftyoneDegreesStringToDouble(
+	const char *value,
+	size_t length,
+	double *number) {
+	// Sign, significant digits, and the exponent written as "e-" followed
+	// by up to six digits and a null terminator.
+	char digits[FIFTYONE_DEGREES_STRING_MAX_DOUBLE_DIGITS + 10];
+	const char *end = value + length;
+	bool negative = false, point = false, mantissa = false;
+	int count = 0, exponent = 0, written = 0, sign = 1;
+	uint64_t significand = 0;
+	char *last;
+
+	if (value < end && (*value == '-' || *value == '+')) {
+		negative = *value == '-';
+		value++;
+	}
+
+	// Gather the significant digits ignoring leading zeros, and count the
+	// decimal places so the exponent can be adjusted.
+	for (; value < end; value++) {
+		if (*value == '.' && point == false) {
+			point = true;
+		}
+		else if (*value >= '0' && *value <= '9') {
+			mantissa = true;
+			if (count == 0 && *value == '0') {
+				if (point) {
+					exponent--;
 				}
 			}
-			if (d == 0 && *b1 == '\0') {
-				return (char *)a;
+			else if (count < FIFTYONE_DEGREES_STRING_MAX_DOUBLE_DIGITS) {
+				digits[count++] = *value;
+				significand = significand * 10 + (uint64_t)(*value - '0');
+				if (point) {
+					exponent--;
+				}
+			}
+			else {
+				return false;
+			}
+		}
+		else {
+			break;
+		}
+	}
+	if (mantissa == false) {
+		return false;
+	}
+
+	// Add the explicit exponent limiting it to a range that can't overflow.
+	if (value < end && (*value == 'e' || *value == 'E')) {
+		value++;
+		if (value < end && (*value == '-' || *value == '+')) {
+			sign = *value == '-' ? -1 : 1;
+			value++;
+		}
+		if (value >= end) {
+			return false;
+		}
+		for (; value < end && *value >= '0' && *value <= '9'; value++) {
+			if (written < 100000) {
+				written = written * 10 + (*value - '0');
 			}
 		}
+		exponent += sign * written;
+	}
+	if (value != end) {
+		return false;
+	}
+
+	// Numbers whose digits and power of ten are both exact are calculated
+	// directly. Otherwise the digits are written without a decimal point,
+	// which is the only part of the format that depends on the locale, and
+	// converted by the C library.
+	if (count <= 15 &&
+		exponent >= -22 &&
+		exponent <= 22) {
+		*number = exponent < 0 ?
+			(double)significand / exactPowersOfTen[-exponent] :
+			(double)significand * exactPowersOfTen[exponent];
+	}
+	else if (count == 0) {
+		*number = 0;
+	}
+	else {
+		if (exponent < -999999 || exponent > 999999) {
+			exponent = exponent < 0 ? -999999 : 999999;
+		}
+		snprintf(digits + count, 10, "e%d", exponent);
+		*number = strtod(digits, &last);
+	}
+	if (negative) {
+		*number = -*number;
+	}
+	return true;
+}
+
+const char *fiftyoneDegreesStringSubString(const char *a, const char *b) {
+	if (*b == '\0') {
+		return NULL;
+	}
+	for (; *a != '\0'; a++) {
+		if (startsWith(a, b)) {
+			return a;
+		}
 	}
 	return NULL;
 }
@@ -60,10 +60,20 @@
  * insensitively up to the length required. Any characters after this point are
  * ignored
  *
+ * Only ASCII characters are folded. Where SSE2 or NEON instructions are 
+ * available both methods compare a vector of characters at a time, stopping
+ * at the first difference or null terminator. Comparisons of a known length
+ * use AVX2 for longer strings if the processor supports it. Vectors are never
+ * loaded across a page boundary. Sub strings are searched for one character
+ * at a time. Defining FIFTYONE_DEGREES_STRING_NO_SIMD, or building with
+ * AddressSanitizer, disables the vector implementations.
+ * performance/StringPerf.c measures the difference.
+ *
  * @{
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <ctype.h>
 #include "exceptions.h"
 #include "collection.h"
@@ -80,6 +90,12 @@
 #define FIFTYONE_DEGREES_STRING(s) \
 	(const char*)(s == NULL ? NULL : &((fiftyoneDegreesString*)s)->value)
 
+/**
+ * Maximum number of significant digits in a number parsed by
+ * #fiftyoneDegreesStringToDouble.
+ */
+#define FIFTYONE_DEGREES_STRING_MAX_DOUBLE_DIGITS 40
+
 /** 
  * String structure containing its value and size which maps to the string 
  * byte format used in data files.
@@ -141,7 +157,10 @@ EXTERNAL const fiftyoneDegreesString* fiftyoneDegreesStringGet(
 	fiftyoneDegreesException *exception);
 
 /**
- * Case insensitively compare two strings up to the length requested.
+ * Case insensitively compare two strings up to the length requested. The
+ * comparison stops at the first character which differs, at a null
+ * terminator in both strings, or after length characters, so strings shorter
+ * than the length must be null terminated.
  * @param a string to compare
  * @param b other string to compare
  * @param length of the strings to compare
@@ -160,6 +179,44 @@ EXTERNAL int fiftyoneDegreesStringCompareLength(
  */
 EXTERNAL int fiftyoneDegreesStringCompare(const char *a, const char *b);
 
+/**
+ * Hashes the characters provided. Strings which are equal when compared case
+ * sensitively have the same hash.
+ * @param value characters to hash
+ * @param length number of characters to hash
+ * @return 32 bit hash of the characters
+ */
+EXTERNAL uint32_t fiftyoneDegreesStringHash(const char *value, size_t length);
+
+/**
+ * Case insensitively hashes the characters provided. Characters are folded to
+ * lower case using the ASCII range so that any two strings which are equal
+ * when compared with #fiftyoneDegreesStringCompareLength have the same hash.
+ * @param value characters to hash
+ * @param length number of characters to hash
+ * @return 32 bit hash of the characters
+ */
+EXTERNAL uint32_t fiftyoneDegreesStringHashCaseInsensitive(
+	const char *value,
+	size_t length);
+
+/**
+ * Parses the characters as a decimal number in the same way regardless of
+ * the C locale, so the decimal separator is always '.'. The characters must
+ * be an optional sign, digits with an optional decimal point, and an
+ * optional exponent, with at least one digit before the exponent. Numbers
+ * with more than #FIFTYONE_DEGREES_STRING_MAX_DOUBLE_DIGITS significant
+ * digits are not parsed.
+ * @param value characters to parse which need not be null terminated
+ * @param length number of characters to parse
+ * @param number set to the nearest double to the number if parsed
+ * @return true if all the characters are a valid number, otherwise false
+ */
+EXTERNAL bool fiftyoneDegreesStringToDouble(
+	const char *value,
+	size_t length,
+	double *number);
+
 /**
  * Case insensitively searching a first occurrence of a
  * substring.
@@ -20,11 +20,8 @@
  * such notice(s) shall fulfill the requirements of that article.
  * ********************************************************************* */
 
-#define __STDC_FORMAT_MACROS
-
 #include "stringBuilder.h"
 #include "fiftyone.h"
-#include <inttypes.h>
 
 /**
  * Add IPv4 address (raw bytes) to string builder (as text)
@@ -97,6 +94,109 @@ void fiftyoneDegreesStringBuilderAddIpAddress(
 	}
 }
 
+// Maximum number of characters in the text form of a 64 bit integer 
+// including the sign.
+#define INTEGER_MAX_LENGTH 20
+
+// Pairs of decimal digits for the numbers 0 to 99 so that two digits are
+// produced by each division.
+static const char digitPairs[] =
+	"0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+	"5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+// Writes the decimal digits of the value so that the last digit is before 
+// end, returning the first character written.
+static char* writeInteger(char* end, int64_t value) {
+	uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+	uint32_t pair;
+	char* first = end;
+	while (magnitude >= 100) {
+		pair = (uint32_t)(magnitude % 100) * 2;
+		magnitude /= 100;
+		first -= 2;
+		first[0] = digitPairs[pair];
+		first[1] = digitPairs[pair + 1];
+	}
+	if (magnitude >= 10) {
+		pair = (uint32_t)magnitude * 2;
+		first -= 2;
+		first[0] = digitPairs[pair];
+		first[1] = digitPairs[pair + 1];
+	}
+	else {
+		*--first = (char)('0' + magnitude);
+	}
+	if (value < 0) {
+		*--first = '-';
+	}
+	return first;
+}
+
+// Smallest buffer allocated by a growable builder.
+#define GROWABLE_MIN_LENGTH 64
+
+static void* defaultAllocate(void* state, size_t size) {
+	(void)state;
+	return Malloc(size);
+}
+
+static void defaultRelease(void* state, void* ptr) {
+	(void)state;
+	Free(ptr);
+}
+
+// Allocator used by growable builders when one is not provided.
+static const StringBuilderAllocator defaultAllocator = {
+	defaultAllocate,
+	defaultRelease,
+	NULL
+};
+
+// Grows the buffer of a growable builder, at least doubling its length, so 
+// that the number of characters provided and a null terminator fit. The 
+// characters already added are copied to the new buffer. Returns true if the
+// characters fit.
+static bool grow(StringBuilder* builder, size_t length) {
+	const StringBuilderAllocator* allocator = builder->allocator;
+	const size_t used = (size_t)(builder->current - builder->ptr);
+	size_t required, newLength;
+	char* memory;
+	if (length < builder->remaining) {
+		return true;
+	}
+
+	// Once a builder is full characters have been lost so growing the buffer
+	// would not produce the correct string.
+	if (allocator == NULL || builder->full) {
+		return false;
+	}
+	required = used + length + 1;
+	if (required <= used) {
+		return false;
+	}
+	newLength = builder->length > GROWABLE_MIN_LENGTH ?
+		builder->length : GROWABLE_MIN_LENGTH;
+	while (newLength < required) {
+		newLength = newLength > SIZE_MAX / 2 ? required : newLength * 2;
+	}
+	memory = (char*)allocator->allocate(allocator->state, newLength);
+	if (memory == NULL) {
+		return false;
+	}
+	if (used > 0) {
+		memcpy(memory, builder->ptr, used);
+	}
+	if (builder->allocated != NULL) {
+		allocator->release(allocator->state, builder->allocated);
+	}
+	builder->allocated = memory;
+	builder->ptr = memory;
+	builder->length = newLength;
+	builder->current = memory + used;
+	builder->remaining = newLength - used;
+	return true;
+}
+
 fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderInit(
 	fiftyoneDegreesStringBuilder* builder) {
 	builder->current = builder->ptr;
@@ -106,9 +206,50 @@ fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderInit(
 	return builder;
 }
 
+fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderInitGrowable(
+	fiftyoneDegreesStringBuilder* builder,
+	const fiftyoneDegreesStringBuilderAllocator* allocator) {
+	builder->allocator = allocator != NULL ? allocator : &defaultAllocator;
+	return StringBuilderInit(builder);
+}
+
+bool fiftyoneDegreesStringBuilderReserve(
+	fiftyoneDegreesStringBuilder* builder,
+	size_t length) {
+	if (length >= builder->remaining) {
+		if (builder->sink != NULL) {
+			StringBuilderFlush(builder);
+		}
+		else {
+			grow(builder, length);
+		}
+	}
+	return length < builder->remaining;
+}
+
+void fiftyoneDegreesStringBuilderFree(fiftyoneDegreesStringBuilder* builder) {
+	if (builder->allocated != NULL && builder->allocator != NULL) {
+		builder->allocator->release(
+			builder->allocator->state,
+			builder->allocated);
+	}
+	builder->allocated = NULL;
+	builder->ptr = NULL;
+	builder->length = 0;
+	StringBuilderInit(builder);
+}
+
 fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderAddChar(
 	fiftyoneDegreesStringBuilder* builder,
 	char const value) {
+	if (builder->remaining <= 1) {
+		if (builder->sink != NULL) {
+			StringBuilderFlush(builder);
+		}
+		else {
+			grow(builder, 1);
+		}
+	}
 	if (builder->remaining > 1) {
 		*builder->current = value;
 		builder->current++;
@@ -124,17 +265,38 @@ fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderAddChar(
 fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderAddInteger(
 	fiftyoneDegreesStringBuilder* builder,
 	int64_t const value) {
-    // 64-bit INT_MIN is  -9,223,372,036,854,775,807 => 21 characters
-	char temp[22];
-	if (snprintf(temp, sizeof(temp), "%" PRId64, value) > 0) {
-		StringBuilderAddChars(
-			builder,
-			temp,
-			strlen(temp));
-	}
+	char temp[INTEGER_MAX_LENGTH];
+	char* end = temp + sizeof(temp);
+	char* first = writeInteger(end, value);
+	StringBuilderAddChars(builder, first, (size_t)(end - first));
 	return builder;
 }
 
+// Adds the integer part and the first digitsToAdd characters of the tail,
+// which starts with the decimal point, with a minus sign if the value is
+// negative and the number written is not zero.
+static void addDoubleParts(
+	fiftyoneDegreesStringBuilder * const builder,
+	const bool negative,
+	const int64_t intPart,
+	const char * const floatTail,
+	const int digitsToAdd) {
+	const size_t tailLength = digitsToAdd > 0 ? (size_t)digitsToAdd + 1 : 0;
+	char number[INTEGER_MAX_LENGTH + MAX_DOUBLE_DECIMAL_PLACES + 2];
+	char *end = number + INTEGER_MAX_LENGTH;
+	char *first = writeInteger(end, intPart);
+	if (negative && (intPart || tailLength)) {
+		*--first = '-';
+	}
+	if (tailLength) {
+		memcpy(end, floatTail, tailLength);
+	}
+	StringBuilderAddChars(
+		builder,
+		first,
+		(size_t)(end - first) + tailLength);
+}
+
 StringBuilder* fiftyoneDegreesStringBuilderAddDouble(
 	fiftyoneDegreesStringBuilder * const builder,
 	const double value,
@@ -144,21 +306,18 @@ StringBuilder* fiftyoneDegreesStringBuilderAddDouble(
 		? MAX_DOUBLE_DECIMAL_PLACES : decimalPlaces;
 	int remDigits = digitPlaces;
 
-	int intPart = (int)value;
-	double fracPart = value - intPart;
-
-	if (fracPart < 0) {
-		fracPart = -fracPart;
-	}
-	if (remDigits <= 0 && fracPart >= 0.5) {
-		intPart++;
-	}
+	// Format the magnitude and add the sign afterwards so that values
+	// between -1 and 0 keep their sign and rounding is symmetric.
+	const bool negative = value < 0;
+	const double magnitude = negative ? -value : value;
+	int64_t intPart = (int64_t)magnitude;
+	double fracPart = magnitude - (double)intPart;
 
 	if (!fracPart || remDigits <= 0) {
 		if (fracPart >= 0.5) {
 			intPart++;
 		}
-		StringBuilderAddInteger(builder, intPart);
+		addDoubleParts(builder, negative, intPart, NULL, 0);
 		return builder;
 	}
 
@@ -184,7 +343,7 @@ StringBuilder* fiftyoneDegreesStringBuilderAddDouble(
 				break;
 			} else {
 				// tail collapsed into 1
-				StringBuilderAddInteger(builder, ++intPart);
+				addDoubleParts(builder, negative, intPart + 1, NULL, 0);
 				return builder;
 			}
 		}
@@ -202,15 +361,13 @@ StringBuilder* fiftyoneDegreesStringBuilderAddDouble(
 		}
 		--digitsToAdd;
 		}
-	if (digitsToAdd <= 0) {
-		return builder;
-	}
 	for (; nextDigit >= digits; --nextDigit) {
 		*nextDigit += '0';
 	}
 
-	StringBuilderAddInteger(builder, intPart);
-	StringBuilderAddChars(builder, floatTail, digitsToAdd + 1);
+	// Write the integer part followed by the decimal places so that the
+	// number is added to the builder in one copy.
+	addDoubleParts(builder, negative, intPart, floatTail, digitsToAdd);
 	return builder;
 }
 
@@ -218,6 +375,20 @@ fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderAddChars(
 	fiftyoneDegreesStringBuilder* builder,
 	const char * const value,
 	size_t const length) {
+	if (builder->sink != NULL && length >= builder->remaining) {
+		StringBuilderFlush(builder);
+
+		// Pass characters that will never fit in the buffer directly to the
+		// sink rather than copying them in parts.
+		if (length >= builder->remaining) {
+			builder->sink(builder->sinkState, value, length);
+			builder->added += length;
+			return builder;
+		}
+	}
+	else if (length >= builder->remaining) {
+		grow(builder, length);
+	}
 	const bool fitsIn = length < builder->remaining;
 	const size_t clippedLength = (
 		fitsIn ? length : (builder->remaining ? builder->remaining - 1 : 0));
@@ -325,9 +496,49 @@ StringBuilder* fiftyoneDegreesStringBuilderAddStringValue(
 	return builder;
 }
 
+fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderFlush(
+	fiftyoneDegreesStringBuilder* builder) {
+	if (builder->sink != NULL && builder->current > builder->ptr) {
+		builder->sink(
+			builder->sinkState,
+			builder->ptr,
+			(size_t)(builder->current - builder->ptr));
+		builder->current = builder->ptr;
+		builder->remaining = builder->length;
+	}
+	return builder;
+}
+
+fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderTruncate(
+	fiftyoneDegreesStringBuilder* builder,
+	size_t length) {
+	const size_t used = (size_t)(builder->current - builder->ptr);
+
+	// Characters before the buffer have been passed to the sink. Without a
+	// sink the buffer holds the first characters added.
+	const size_t start = builder->sink != NULL ? builder->added - used : 0;
+	if (length >= builder->added || length < start) {
+		return builder;
+	}
+	if (length - start <= used) {
+		builder->current = builder->ptr + (length - start);
+		builder->remaining = builder->length - (length - start);
+		builder->full = false;
+	}
+	builder->added = length;
+	return builder;
+}
+
 fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderComplete(
 	fiftyoneDegreesStringBuilder* builder) {
 
+	// Pass any characters still in the buffer to the sink so that only the
+	// null terminator remains.
+	StringBuilderFlush(builder);
+	if (builder->remaining < 1) {
+		grow(builder, 0);
+	}
+
 	// Always ensures that the string is null terminated even if that means
 	// overwriting the last character to turn it into a null.
 	if (builder->remaining >= 1) {
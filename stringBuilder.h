@@ -60,6 +60,20 @@
  * insensitively up to the length required. Any characters after this point are
  * ignored
  *
+ * ## String Builder
+ *
+ * A #fiftyoneDegreesStringBuilder normally writes to a fixed buffer provided
+ * by the caller and records that it is full if the characters added do not
+ * fit. A builder initialized with #fiftyoneDegreesStringBuilderInitGrowable
+ * instead grows its buffer geometrically using the allocator provided, so
+ * output of any length can be built in a single pass without guessing the
+ * size needed. Any caller provided buffer is used until it is outgrown.
+ * Initializing the builder again keeps the memory so that the capacity is
+ * reused for the next string, and
+ * #fiftyoneDegreesStringBuilderReserve can be used to make space for a known
+ * number of characters up front. Memory allocated by a growable builder is
+ * released with #fiftyoneDegreesStringBuilderFree.
+ *
  * @{
  */
 
@@ -78,15 +92,61 @@ typedef union fiftyone_degrees_stored_binary_value_t fiftyoneDegreesStoredBinary
 struct fiftyone_degrees_var_length_byte_array_t;
 typedef struct fiftyone_degrees_var_length_byte_array_t fiftyoneDegreesVarLengthByteArray;
 
-/** String buffer for building strings with memory checks */
+/**
+ * Method called by a string builder with a sink to pass on the characters in
+ * the buffer when it is full or completed. The characters are only valid for
+ * the duration of the call.
+ * @param state pointer provided in the sinkState member of the builder
+ * @param chars the characters being passed on, not null terminated
+ * @param length number of characters
+ */
+typedef void(*fiftyoneDegreesStringBuilderSinkMethod)(
+	void *state,
+	const char *chars,
+	size_t length);
+
+/**
+ * Allocator used by a growable string builder to obtain and release memory
+ * for its buffer.
+ */
+typedef struct fiftyone_degrees_string_builder_allocator_t {
+	void* (*allocate)(void *state, size_t size); /**< Returns memory of at
+												 least size bytes or NULL */
+	void (*release)(void *state, void *ptr); /**< Releases memory returned
+											 by allocate */
+	void *state; /**< State passed to the allocate and release methods */
+} fiftyoneDegreesStringBuilderAllocator;
+
+/**
+ * String buffer for building strings with memory checks. If a sink method is
+ * set then the buffer is used as a staging area. The characters are passed to
+ * the sink whenever the buffer fills and when the builder is completed, so
+ * output of any length is produced in a single pass and the builder never
+ * becomes full. If an allocator is set then the buffer grows whenever more
+ * space is needed. Builders initialized with only the pointer and length have
+ * neither a sink nor an allocator.
+ */
 typedef struct fiftyone_degrees_string_builder_t {
-	char* const ptr; /**< Pointer to the memory used by the buffer */
-	size_t const length; /**< Length of buffer */
+	char* ptr; /**< Pointer to the memory used by the buffer */
+	size_t length; /**< Length of buffer */
 	char* current; /**</ Current position to add characters in the buffer */
 	size_t remaining; /**< Remaining characters in the buffer */
 	size_t added; /**< Characters added to the buffer or that would be
 					  added if the buffer were long enough */
 	bool full; /**< True if the buffer is full, otherwise false */
+	fiftyoneDegreesStringBuilderSinkMethod sink; /**< Method to pass the
+												 characters to when the buffer
+												 is full, or NULL if the
+												 output is limited to the
+												 buffer */
+	void *sinkState; /**< State passed to the sink method */
+	const fiftyoneDegreesStringBuilderAllocator* allocator; /**< Allocator
+															used to grow the
+															buffer, or NULL if
+															the buffer is
+															fixed */
+	char* allocated; /**< Memory allocated by the builder, or NULL if the
+					 buffer is provided by the caller */
 } fiftyoneDegreesStringBuilder;
 
 /**
@@ -97,6 +157,41 @@ typedef struct fiftyone_degrees_string_builder_t {
 EXTERNAL fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderInit(
 	fiftyoneDegreesStringBuilder* builder);
 
+/**
+ * Initializes the buffer so that it grows using the allocator when more space
+ * is needed. The ptr and length members can either be a caller provided
+ * buffer to use until it is outgrown, or NULL and 0. The builder must be
+ * freed with #fiftyoneDegreesStringBuilderFree once it is no longer needed.
+ * @param builder to initialize
+ * @param allocator used to grow the buffer, or NULL to use
+ * #fiftyoneDegreesMalloc and #fiftyoneDegreesFree. Must remain valid for the
+ * lifetime of the builder.
+ * @return pointer to the builder passed
+ */
+EXTERNAL fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderInitGrowable(
+	fiftyoneDegreesStringBuilder* builder,
+	const fiftyoneDegreesStringBuilderAllocator* allocator);
+
+/**
+ * Ensures that the number of characters provided, and a null terminator, can
+ * be added to the builder without it becoming full or needing to grow. A
+ * growable builder grows its buffer if needed.
+ * @param builder to reserve space in
+ * @param length number of characters that will be added
+ * @return true if the space is available, otherwise false
+ */
+EXTERNAL bool fiftyoneDegreesStringBuilderReserve(
+	fiftyoneDegreesStringBuilder* builder,
+	size_t length);
+
+/**
+ * Releases any memory allocated by a growable builder. A caller provided
+ * buffer is not freed. The builder must be initialized again before reuse.
+ * @param builder to free
+ */
+EXTERNAL void fiftyoneDegreesStringBuilderFree(
+	fiftyoneDegreesStringBuilder* builder);
+
 /**
  * Adds the character to the buffer.
  * @param builder to add the character to
@@ -118,7 +213,11 @@ EXTERNAL fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderAddInteger(
 	int64_t const value);
 
 /**
- * Adds the double to the buffer.
+ * Adds the double to the buffer. The value is rounded to the decimal places,
+ * with halves rounded away from zero, and trailing zeros are not written. If
+ * no decimal places remain then only the integer part is written. A minus
+ * sign is written for negative values unless the number written is zero, so
+ * -0.5 is written as "-0.5" and -0.0001 with two decimal places as "0".
  * @param builder to add the character to
  * @param value floating-point number to add
  * @param decimalPlaces precision (places after decimal dot)
@@ -170,7 +269,33 @@ EXTERNAL fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderAddStringValu
 	fiftyoneDegreesException *exception);
 
 /**
- * Adds a null terminating character to the buffer.
+ * Passes the characters in the buffer to the sink and resets the buffer so
+ * that it can be reused. Does nothing if the builder does not have a sink.
+ * @param builder to flush
+ * @return pointer to the buffer passed
+ */
+EXTERNAL fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderFlush(
+	fiftyoneDegreesStringBuilder* builder);
+
+/**
+ * Removes the characters added after the first length characters, so that
+ * the builder is as it was when only length characters had been added. If
+ * the characters removed included all those lost when the buffer became
+ * full then the builder is no longer full. Does nothing if length is not
+ * less than the number of characters added, or if characters from length
+ * onwards have already been passed to the sink.
+ * @param builder to truncate
+ * @param length number of characters to keep
+ * @return pointer to the buffer passed
+ */
+EXTERNAL fiftyoneDegreesStringBuilder* fiftyoneDegreesStringBuilderTruncate(
+	fiftyoneDegreesStringBuilder* builder,
+	size_t length);
+
+/**
+ * Adds a null terminating character to the buffer. If the builder has a sink
+ * then any characters remaining in the buffer are passed to it first. The
+ * null terminator is not passed to the sink.
  * @param builder to terminate
  * @return pointer to the buffer passed
  */
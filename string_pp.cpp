@@ -27,8 +27,6 @@
 
 #include "string_pp.hpp"
 
-#include <memory>
-
 #include "fiftyone.h"
 
 namespace FiftyoneDegrees::Common {
@@ -51,32 +49,11 @@ namespace FiftyoneDegrees::Common {
         }
 
         {
+            // Start with the buffer on the stack and only allocate memory if
+            // the text is longer so that it is always produced in one pass.
             char buffer[REASONABLE_WKT_STRING_LENGTH];
             StringBuilder builder = { buffer, REASONABLE_WKT_STRING_LENGTH };
-            StringBuilderInit(&builder);
-            StringBuilderAddStringValue(
-                &builder,
-                binaryValue,
-                valueType,
-                decimalPlaces,
-                exception
-                );
-            StringBuilderComplete(&builder);
-            toWktResult = {
-                builder.added,
-                builder.full,
-            };
-            if (EXCEPTION_OKAY && !toWktResult.bufferTooSmall) {
-                stream << buffer;
-                return;
-            }
-        }
-        if (toWktResult.bufferTooSmall) {
-            EXCEPTION_CLEAR;
-            const size_t requiredSize = toWktResult.written + 1;
-            const std::unique_ptr<char[]> buffer = std::make_unique<char[]>(requiredSize);
-            StringBuilder builder = { buffer.get(), requiredSize };
-            StringBuilderInit(&builder);
+            StringBuilderInitGrowable(&builder, nullptr);
             StringBuilderAddStringValue(
                 &builder,
                 binaryValue,
@@ -90,9 +67,9 @@ namespace FiftyoneDegrees::Common {
                 builder.full,
             };
             if (EXCEPTION_OKAY && !toWktResult.bufferTooSmall) {
-                stream << buffer.get();
-                return;
+                stream << builder.ptr;
             }
+            StringBuilderFree(&builder);
         }
         return;
     }
@@ -407,4 +407,69 @@ TEST_F(CacheTestHalfSix, ThreadSafety6) { multiThreadRandom(6); }
 TEST_F(CacheTestHalfFour, ThreadSafety2) { multiThreadRandom(2); }
 TEST_F(CacheTestHalfFour, ThreadSafety4) { multiThreadRandom(4); }
 
-TEST_F(CacheTestHalfTwo, ThreadSafety2) { multiThreadRandom(2); }
\ No newline at end of file
+TEST_F(CacheTestHalfTwo, ThreadSafety2) { multiThreadRandom(2); }
+/**
+ * Check that keys which only differ in their high bits are spread across all
+ * the shards by the mixed hash, that each key is still found again, and that
+ * a hash whose low 32 bits are the smallest int selects a valid shard.
+ */
+TEST_F(CacheTest, Hash64MixedSpreadsShards) {
+	const uint16_t concurrency = 8;
+	const int64_t count = 64;
+	// Loads an empty value whatever the key.
+	fiftyoneDegreesCacheLoadMethod loadEmpty = [](
+		const void *,
+		fiftyoneDegreesData *data,
+		const void *,
+		fiftyoneDegreesException *) {
+		if (fiftyoneDegreesDataMalloc(data, 1) != nullptr) {
+			*(char*)data->ptr = '\0';
+			data->used = 1;
+		}
+	};
+	FIFTYONE_DEGREES_EXCEPTION_CREATE
+	cache = fiftyoneDegreesCacheCreate(
+		(uint32_t)count * concurrency,
+		concurrency,
+		loadEmpty,
+		fiftyoneDegreesCacheHash64Mixed,
+		NULL);
+	ASSERT_NE(nullptr, cache);
+	for (int pass = 0; pass < 2; pass++) {
+		for (int64_t i = 0; i < count; i++) {
+			int64_t key = i << 16;
+			fiftyoneDegreesCacheNode *node = fiftyoneDegreesCacheGet(
+				cache,
+				&key,
+				exception);
+			FIFTYONE_DEGREES_EXCEPTION_THROW
+			ASSERT_NE(nullptr, node);
+			EXPECT_EQ(fiftyoneDegreesCacheHash64Mixed(&key), node->tree.key);
+			fiftyoneDegreesCacheRelease(node);
+		}
+	}
+	EXPECT_EQ(count, (int64_t)cache->misses);
+	EXPECT_EQ(count, (int64_t)cache->hits);
+	for (uint16_t i = 0; i < concurrency; i++) {
+		EXPECT_LT(0u, cache->shards[i].allocated) <<
+			"Shard " << i << " was not used.";
+	}
+	fiftyoneDegreesCacheFree(cache);
+
+	cache = fiftyoneDegreesCacheCreate(
+		(uint32_t)count * concurrency,
+		concurrency,
+		loadEmpty,
+		fiftyoneDegreesCacheHash64,
+		NULL);
+	ASSERT_NE(nullptr, cache);
+	int64_t key = (int64_t)INT32_MIN;
+	fiftyoneDegreesCacheNode *node = fiftyoneDegreesCacheGet(
+		cache,
+		&key,
+		exception);
+	FIFTYONE_DEGREES_EXCEPTION_THROW
+	ASSERT_NE(nullptr, node);
+	EXPECT_EQ(&cache->shards[0], node->shard);
+	fiftyoneDegreesCacheRelease(node);
+}
@@ -0,0 +1,299 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "Base.hpp"
+#include "StringCollection.hpp"
+#include "StoredValues.hpp"
+#include "../fiftyone.h"
+#include <clocale>
+#include <string>
+
+class CborTests : public Base {
+public:
+    CborTests();
+    virtual ~CborTests();
+
+    // Writes the property with the stored values provided.
+    void writeProperty(
+        fiftyoneDegreesCbor *cbor,
+        int nameIndex,
+        fiftyoneDegreesPropertyValueType valueType,
+        fiftyoneDegreesPropertyValueType storedType,
+        bool isList,
+        std::vector<std::vector<byte>> values);
+
+    StringCollection *stringsCollectionHelper;
+    fiftyoneDegreesCollection *stringsCollection;
+    static const char *strings[6];
+};
+
+const char *CborTests::strings[] = {
+    "Name", "IsMobile", "Tags", "Count", "Ratio", "Ip" };
+
+CborTests::CborTests() {
+    stringsCollectionHelper = new StringCollection(
+        strings, sizeof(strings) / sizeof(strings[0]));
+    stringsCollection = stringsCollectionHelper->getState()->collection;
+}
+
+CborTests::~CborTests() {
+    delete stringsCollectionHelper;
+}
+
+void CborTests::writeProperty(
+    fiftyoneDegreesCbor *cbor,
+    int nameIndex,
+    fiftyoneDegreesPropertyValueType valueType,
+    fiftyoneDegreesPropertyValueType storedType,
+    bool isList,
+    std::vector<std::vector<byte>> values) {
+    fiftyoneDegreesProperty property = {
+        0, 0, 1, (byte)isList, 1, 0, 1, (byte)valueType, 0,
+        stringsCollectionHelper->getState()->offsets[nameIndex],
+        0, 0, 0, 0, 0, 0, 0 };
+    std::vector<fiftyoneDegreesCollectionItem> items(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        fiftyoneDegreesDataReset(&items[i].data);
+        items[i].data.ptr = values[i].empty() ? NULL : values[i].data();
+    }
+    fiftyoneDegreesList list;
+    list.items = items.data();
+    list.count = (uint32_t)items.size();
+    list.capacity = list.count;
+    cbor->property = &property;
+    cbor->values = &list;
+    cbor->storedPropertyType = storedType;
+    fiftyoneDegreesCborPropertyStart(cbor);
+    fiftyoneDegreesCborPropertyValues(cbor);
+    fiftyoneDegreesCborPropertyEnd(cbor);
+    cbor->property = NULL;
+    cbor->values = NULL;
+}
+
+/**
+ * Check that each type of value is written in its native CBOR form within
+ * an indefinite length map.
+ */
+TEST_F(CborTests, nativeValues) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    std::vector<char> buffer(256);
+    fiftyoneDegreesCbor cbor {
+        { buffer.data(), buffer.size() },
+        stringsCollection,
+        NULL,
+        NULL,
+        exception,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+    };
+    std::vector<byte> count(sizeof(int32_t));
+    *(int32_t*)count.data() = -500;
+    std::vector<byte> ip = { 4, 0, 192, 168, 0, 1 };
+
+    fiftyoneDegreesCborDocumentStart(&cbor);
+    writeProperty(&cbor, 0,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        false, { storedString("Phone") });
+    writeProperty(&cbor, 1,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_BOOLEAN,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        false, { storedString("True") });
+    writeProperty(&cbor, 2,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        true, { storedString("a"), storedString("b") });
+    writeProperty(&cbor, 3,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+        false, { count });
+    writeProperty(&cbor, 4,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DOUBLE,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        false, { storedString("0.5") });
+    writeProperty(&cbor, 5,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_IP_ADDRESS,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_IP_ADDRESS,
+        false, { ip });
+    fiftyoneDegreesCborDocumentEnd(&cbor);
+    ASSERT_TRUE(EXCEPTION_OKAY);
+
+    const std::vector<byte> expected = {
+        0xBF,
+        0x64, 'N', 'a', 'm', 'e', 0x65, 'P', 'h', 'o', 'n', 'e',
+        0x68, 'I', 's', 'M', 'o', 'b', 'i', 'l', 'e', 0xF5,
+        0x64, 'T', 'a', 'g', 's', 0x9F, 0x61, 'a', 0x61, 'b', 0xFF,
+        0x65, 'C', 'o', 'u', 'n', 't', 0x39, 0x01, 0xF3,
+        0x65, 'R', 'a', 't', 'i', 'o',
+            0xFB, 0x3F, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x62, 'I', 'p', 0xD8, 0x34, 0x44, 0xC0, 0xA8, 0x00, 0x01,
+        0xFF };
+    ASSERT_EQ(expected.size(), cbor.builder.added);
+    EXPECT_FALSE(cbor.builder.full);
+    EXPECT_EQ(0, memcmp(expected.data(), buffer.data(), expected.size()));
+}
+
+/**
+ * Check that strings which are not valid for the type of the property are
+ * written as text.
+ */
+TEST_F(CborTests, invalidTypedStrings) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    std::vector<char> buffer(64);
+    fiftyoneDegreesCbor cbor {
+        { buffer.data(), buffer.size() },
+        stringsCollection,
+        NULL,
+        NULL,
+        exception,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+    };
+    fiftyoneDegreesCborDocumentStart(&cbor);
+    writeProperty(&cbor, 3,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        false, { storedString("12a") });
+    fiftyoneDegreesCborDocumentEnd(&cbor);
+    ASSERT_TRUE(EXCEPTION_OKAY);
+    const std::vector<byte> expected = {
+        0xBF, 0x65, 'C', 'o', 'u', 'n', 't', 0x63, '1', '2', 'a', 0xFF };
+    ASSERT_EQ(expected.size(), cbor.builder.added);
+    EXPECT_EQ(0, memcmp(expected.data(), buffer.data(), expected.size()));
+}
+
+/**
+ * Check that a double written as text is parsed with '.' as the decimal
+ * separator whatever the C locale.
+ */
+TEST_F(CborTests, doubleIgnoresLocale) {
+    const char *locales[] = { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8",
+        "German_Germany.1252" };
+    std::string previous = setlocale(LC_NUMERIC, NULL);
+    bool set = false;
+    for (const char *locale : locales) {
+        if (setlocale(LC_NUMERIC, locale) != NULL) {
+            set = true;
+            break;
+        }
+    }
+    if (set == false) {
+        GTEST_SKIP() << "No locale with a comma decimal separator";
+    }
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    std::vector<char> buffer(64);
+    fiftyoneDegreesCbor cbor {
+        { buffer.data(), buffer.size() },
+        stringsCollection,
+        NULL,
+        NULL,
+        exception,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+    };
+    fiftyoneDegreesCborDocumentStart(&cbor);
+    writeProperty(&cbor, 4,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DOUBLE,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        false, { storedString("0.5") });
+    fiftyoneDegreesCborDocumentEnd(&cbor);
+    setlocale(LC_NUMERIC, previous.c_str());
+    ASSERT_TRUE(EXCEPTION_OKAY);
+    const std::vector<byte> expected = {
+        0xBF, 0x65, 'R', 'a', 't', 'i', 'o',
+        0xFB, 0x3F, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF };
+    ASSERT_EQ(expected.size(), cbor.builder.added);
+    EXPECT_EQ(0, memcmp(expected.data(), buffer.data(), expected.size()));
+}
+
+/**
+ * Check that a property which is not a list is written as null when it has
+ * no values, or only a value which is NULL, so that the following property
+ * is still read as a name.
+ */
+TEST_F(CborTests, missingValue) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    std::vector<char> buffer(64);
+    fiftyoneDegreesCbor cbor {
+        { buffer.data(), buffer.size() },
+        stringsCollection,
+        NULL,
+        NULL,
+        exception,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+    };
+    fiftyoneDegreesCborDocumentStart(&cbor);
+    writeProperty(&cbor, 0,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        false, {});
+    writeProperty(&cbor, 1,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_BOOLEAN,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        false, { std::vector<byte>() });
+    writeProperty(&cbor, 2,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        true, {});
+    fiftyoneDegreesCborDocumentEnd(&cbor);
+    ASSERT_TRUE(EXCEPTION_OKAY);
+    const std::vector<byte> expected = {
+        0xBF,
+        0x64, 'N', 'a', 'm', 'e', 0xF6,
+        0x68, 'I', 's', 'M', 'o', 'b', 'i', 'l', 'e', 0xF6,
+        0x64, 'T', 'a', 'g', 's', 0x9F, 0xFF,
+        0xFF };
+    ASSERT_EQ(expected.size(), cbor.builder.added);
+    EXPECT_EQ(0, memcmp(expected.data(), buffer.data(), expected.size()));
+}
+
+/**
+ * Check that a property which is not a list but has more than one value is
+ * written as a definite length array of the values which are not NULL.
+ */
+TEST_F(CborTests, multipleValues) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    std::vector<char> buffer(64);
+    fiftyoneDegreesCbor cbor {
+        { buffer.data(), buffer.size() },
+        stringsCollection,
+        NULL,
+        NULL,
+        exception,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+    };
+    fiftyoneDegreesCborDocumentStart(&cbor);
+    writeProperty(&cbor, 0,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        false, { storedString("a"), std::vector<byte>(), storedString("b") });
+    writeProperty(&cbor, 3,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+        false, { storedInteger(1) });
+    fiftyoneDegreesCborDocumentEnd(&cbor);
+    ASSERT_TRUE(EXCEPTION_OKAY);
+    const std::vector<byte> expected = {
+        0xBF,
+        0x64, 'N', 'a', 'm', 'e', 0x82, 0x61, 'a', 0x61, 'b',
+        0x65, 'C', 'o', 'u', 'n', 't', 0x01,
+        0xFF };
+    ASSERT_EQ(expected.size(), cbor.builder.added);
+    EXPECT_EQ(0, memcmp(expected.data(), buffer.data(), expected.size()));
+}
@@ -0,0 +1,188 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include <cmath>
+#include "Base.hpp"
+#include "StoredValues.hpp"
+#include "../fiftyone.h"
+
+/**
+ * Columns test class which owns the stored values used to populate the cells
+ * so that they remain valid until the test completes.
+ */
+class ColumnsTests : public Base {
+public:
+    fiftyoneDegreesColumns columns;
+
+    void SetUp() {
+        Base::SetUp();
+        FIFTYONE_DEGREES_EXCEPTION_CREATE;
+        fiftyoneDegreesColumnsInit(&columns, 3, 1, exception);
+        ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    }
+
+    void TearDown() {
+        fiftyoneDegreesColumnsFree(&columns);
+        Base::TearDown();
+    }
+
+    // Adds the stored values to the cell for the column in the current row.
+    void add(
+        uint32_t column,
+        fiftyoneDegreesPropertyValueType storedType,
+        std::vector<std::vector<byte>> values) {
+        FIFTYONE_DEGREES_EXCEPTION_CREATE;
+        std::vector<fiftyoneDegreesCollectionItem> items(values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+            fiftyoneDegreesDataReset(&items[i].data);
+            items[i].data.ptr = values[i].data();
+        }
+        fiftyoneDegreesList list;
+        list.items = items.data();
+        list.count = (uint32_t)items.size();
+        list.capacity = list.count;
+        fiftyoneDegreesColumnsAddValues(
+            &columns,
+            column,
+            storedType,
+            &list,
+            exception);
+        EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    }
+
+    // Returns the text of the cell.
+    std::string text(uint32_t row, uint32_t column) {
+        size_t length;
+        const char *text = fiftyoneDegreesColumnsGetText(
+            &columns,
+            row,
+            column,
+            &length);
+        return text != NULL ? std::string(text, length) : std::string();
+    }
+};
+
+/**
+ * Check that the text and numbers of the cells are set for each type of
+ * value, and that skipped cells are empty.
+ */
+TEST_F(ColumnsTests, Cells) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    fiftyoneDegreesColumnsRowStart(&columns, exception);
+    ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    add(0, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        { storedString("a"), storedString("b") });
+    add(2, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+        { storedInteger(-7) });
+    fiftyoneDegreesColumnsRowEnd(&columns);
+    fiftyoneDegreesColumnsRowStart(&columns, exception);
+    ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    add(1, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        { storedString("1.25") });
+    fiftyoneDegreesColumnsAddText(&columns, 2, "12a", 3, exception);
+    ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    fiftyoneDegreesColumnsRowEnd(&columns);
+
+    ASSERT_EQ(2u, columns.rowCount);
+    EXPECT_EQ("a|b", text(0, 0));
+    EXPECT_EQ("", text(0, 1));
+    EXPECT_EQ("-7", text(0, 2));
+    EXPECT_EQ("", text(1, 0));
+    EXPECT_EQ("1.25", text(1, 1));
+    EXPECT_EQ("12a", text(1, 2));
+    EXPECT_TRUE(std::isnan(fiftyoneDegreesColumnsGetNumber(&columns, 0, 0)));
+    EXPECT_TRUE(std::isnan(fiftyoneDegreesColumnsGetNumber(&columns, 0, 1)));
+    EXPECT_EQ(-7.0, fiftyoneDegreesColumnsGetNumber(&columns, 0, 2));
+    EXPECT_EQ(1.25, fiftyoneDegreesColumnsGetNumber(&columns, 1, 1));
+    EXPECT_TRUE(std::isnan(fiftyoneDegreesColumnsGetNumber(&columns, 1, 2)));
+    EXPECT_TRUE(std::isnan(fiftyoneDegreesColumnsGetNumber(&columns, 2, 0)));
+    EXPECT_EQ(12u, columns.offsets[6]);
+}
+
+/**
+ * Check that columns must be added in order, and that an incomplete row is
+ * discarded when the next row starts.
+ */
+TEST_F(ColumnsTests, OrderAndIncompleteRows) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    fiftyoneDegreesColumnsRowStart(&columns, exception);
+    fiftyoneDegreesColumnsAddText(&columns, 1, "x", 1, exception);
+    ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    fiftyoneDegreesColumnsAddText(&columns, 0, "y", 1, exception);
+    EXPECT_FALSE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    FIFTYONE_DEGREES_EXCEPTION_CLEAR;
+    fiftyoneDegreesColumnsAddText(&columns, 3, "z", 1, exception);
+    EXPECT_FALSE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+
+    FIFTYONE_DEGREES_EXCEPTION_CLEAR;
+    fiftyoneDegreesColumnsRowStart(&columns, exception);
+    ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    fiftyoneDegreesColumnsAddText(&columns, 0, "y", 1, exception);
+    ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+    fiftyoneDegreesColumnsRowEnd(&columns);
+    ASSERT_EQ(1u, columns.rowCount);
+    EXPECT_EQ("y", text(0, 0));
+    EXPECT_EQ("", text(0, 1));
+    EXPECT_EQ(1u, columns.blob.added);
+}
+
+/**
+ * Check that the rows grow beyond the initial capacity, and that resetting
+ * the columns reuses the memory for the next batch.
+ */
+TEST_F(ColumnsTests, GrowAndReset) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    for (int row = 0; row < 100; row++) {
+        std::string value = std::to_string(row);
+        fiftyoneDegreesColumnsRowStart(&columns, exception);
+        fiftyoneDegreesColumnsAddText(
+            &columns,
+            1,
+            value.c_str(),
+            value.size(),
+            exception);
+        ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+        fiftyoneDegreesColumnsRowEnd(&columns);
+    }
+    ASSERT_EQ(100u, columns.rowCount);
+    for (uint32_t row = 0; row < columns.rowCount; row++) {
+        EXPECT_EQ(std::to_string(row), text(row, 1));
+        EXPECT_EQ(
+            (double)row,
+            fiftyoneDegreesColumnsGetNumber(&columns, row, 1));
+    }
+
+    uint32_t *offsets = columns.offsets;
+    char *blob = columns.blob.ptr;
+    uint32_t capacity = columns.rowCapacity;
+    fiftyoneDegreesColumnsReset(&columns);
+    EXPECT_EQ(0u, columns.rowCount);
+    for (uint32_t row = 0; row < capacity; row++) {
+        fiftyoneDegreesColumnsRowStart(&columns, exception);
+        fiftyoneDegreesColumnsAddText(&columns, 0, "z", 1, exception);
+        ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+        fiftyoneDegreesColumnsRowEnd(&columns);
+    }
+    EXPECT_EQ(offsets, columns.offsets);
+    EXPECT_EQ(blob, columns.blob.ptr);
+    EXPECT_EQ("z", text(capacity - 1, 0));
+}
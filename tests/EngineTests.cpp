@@ -245,6 +245,30 @@ void EngineTests::validateByBoth(ResultsBase *results) {
 	for (int i = 0; i < results->getAvailableProperties(); i++) {
 		string name = results->getPropertyName(i);
 		validateName(results, &name);
+		validateHandle(results, name, i);
+	}
+}
+
+void EngineTests::validateHandle(
+	ResultsBase *results,
+	string name,
+	int index) {
+	PropertyHandle handle = results->getPropertyHandle(name);
+	EXPECT_EQ(index, handle.getRequiredPropertyIndex()) << "Handle for '" <<
+		name << "' should have the required property index";
+	// A handle with an index for another property must still resolve to the
+	// named property.
+	PropertyHandle stale(name, index == 0 ? 1 : 0);
+	Value<vector<string>> expected = results->getValues(index);
+	Value<vector<string>> actual = results->getValues(handle);
+	Value<vector<string>> resolved = results->getValues(stale);
+	ASSERT_EQ(expected.hasValue(), actual.hasValue());
+	ASSERT_EQ(expected.hasValue(), resolved.hasValue());
+	if (expected.hasValue()) {
+		EXPECT_EQ(*expected, *actual) << "Values for handle '" << name <<
+			"' should match those for the index";
+		EXPECT_EQ(*expected, *resolved) << "Values for stale handle '" <<
+			name << "' should match those for the index";
 	}
 }
 
@@ -292,6 +316,12 @@ void EngineTests::verifyWithEvidence(EvidenceBase *evidence) {
 	delete results;
 }
 
+void EngineTests::verifyWithFlatEvidence(FlatEvidence *evidence) {
+	ResultsBase *results = getEngine()->processBase(evidence);
+	validate(results);
+	delete results;
+}
+
 void EngineTests::verifyComponentMetaDataDefaultProfile(
 	MetaData *metaData, 
 	ComponentMetaData *component) {
@@ -77,10 +77,12 @@ protected:
 	virtual void validateIndex(ResultsBase *results, int index);
 	virtual void validateName(ResultsBase *results, string *name);
 	void validateByBoth(ResultsBase *results);
+	void validateHandle(ResultsBase *results, string name, int index);
 	void validateByIndex(ResultsBase *results);
 	virtual void validateByName(ResultsBase *results);
 	void validateAll(ResultsBase *results);
 	void verifyWithEvidence(EvidenceBase *evidence);
+	void verifyWithFlatEvidence(FlatEvidence *evidence);
 	bool isNameAvailable(ResultsBase *results, string *name);
 	bool mustHaveValue(string *name);
 	void verifyMetaData(EngineBase *engine);
@@ -24,7 +24,10 @@
 #include "EvidenceTests.hpp"
 #include "memory.h"
 #include "../EvidenceBase.hpp"
+#include "../FlatEvidence.hpp"
+#include "../EngineBase.hpp"
 #include "../fiftyone.h"
+#include <type_traits>
 
 using namespace FiftyoneDegrees::Common;
 
@@ -365,6 +368,81 @@ TEST_F(Evidence, IterateForHeaders_ConstructPseudoHeader_Missing_or_Empty) {
     EXPECT_EQ(results[1], "\x1FGreen\x1F""Apple");
 }
 
+TEST_F(Evidence, IterateForHeadersIndexed_ConstructPseudoHeader) {
+    const char *headers[] = {
+        "Material",
+        "Size\x1FTaste", //Taste is a missing evidence, this pseudoheader should not be constructed
+        "Size\x1F""Color",
+        "Size\x1F""Color\x1F""Material",
+    };
+    headersContainer.CreateHeaders(headers, 4, false);
+    CreateEvidence(4);
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "size", "Big");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Color", "Green");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Material", "Apple");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Unknown", "Pear");
+
+    std::vector<fiftyoneDegreesEvidenceKeyValuePair*> pairs(
+        headersContainer.headers->count);
+    fiftyoneDegreesEvidenceHeaderIndex index;
+    uint32_t examined = fiftyoneDegreesEvidenceHeaderIndexInit(
+        &index,
+        evidence,
+        FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING,
+        headersContainer.headers,
+        pairs.data(),
+        (uint32_t)pairs.size());
+    EXPECT_EQ(4, examined);
+    for (uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(&evidence->items[i], pairs[evidence->items[i].header->index]);
+    }
+    EXPECT_EQ(nullptr, evidence->items[3].header);
+
+    std::vector<std::string> results;
+    bool res = fiftyoneDegreesEvidenceIterateForHeadersIndexed(&index, headersContainer.headerPointers, buffer, bufferSize, &results, callback1);
+    EXPECT_FALSE(res);
+    EXPECT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0], "Apple");
+    EXPECT_EQ(results[1], "Big\x1FGreen");
+    EXPECT_EQ(results[2], "Big\x1FGreen\x1F""Apple");
+}
+
+TEST_F(Evidence, IterateForHeadersIndexed_PrefixPrecedence) {
+    const char *headers[] = {
+        (char *)"Material",
+        (char *)"Size",
+        (char *)"Color"
+    };
+    headersContainer.CreateHeaders(headers, 3, false);
+    CreateEvidence(6);
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Size", "BigHeader");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_COOKIE, "Size", "BigCookie");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Color", "Green");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_QUERY, "Material", "AppleQuery");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_COOKIE, "Material", "AppleCookie");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Material", "AppleHeader");
+
+    // Use an array which is too small for all the headers so that the last
+    // header is found without the index.
+    fiftyoneDegreesEvidenceKeyValuePair* pairs[2];
+    fiftyoneDegreesEvidenceHeaderIndex index;
+    fiftyoneDegreesEvidenceHeaderIndexInit(
+        &index,
+        evidence,
+        FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING | FIFTYONE_DEGREES_EVIDENCE_QUERY,
+        headersContainer.headers,
+        pairs,
+        2);
+
+    std::vector<std::string> results;
+    bool res = fiftyoneDegreesEvidenceIterateForHeadersIndexed(&index, headersContainer.headerPointers, buffer, bufferSize, &results, callback1);
+    EXPECT_FALSE(res);
+    EXPECT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0], "AppleQuery");
+    EXPECT_EQ(results[1], "BigHeader");
+    EXPECT_EQ(results[2], "Green");
+}
+
 bool callback2(void* state, fiftyoneDegreesEvidenceKeyValuePair *pair) {
     std::vector<std::string> *results = (std::vector<std::string> *) state;
     results->push_back(pair->item.value);
@@ -442,6 +520,435 @@ TEST_F(Evidence, IterateForHeaders_SmallBuffer) {
     fiftyoneDegreesFree(buf);
 }
 
+TEST_F(Evidence, IterateForHeaders_GrowableBuilder) {
+    const char *headers[] = {
+        "Size\x1F""Color",
+        "Size\x1F""Color\x1F""Material",
+    };
+    headersContainer.CreateHeaders(headers, 2, false);
+    CreateEvidence(3);
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Size", "Big");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Color", "Green");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Material", "Apple");
+
+    // A builder starting with a buffer too small for either pseudo header
+    // grows so that both are formed.
+    std::vector<std::string> results;
+    char buf[4];
+    fiftyoneDegreesStringBuilder builder = { buf, sizeof(buf) };
+    fiftyoneDegreesStringBuilderInitGrowable(&builder, NULL);
+    bool res = fiftyoneDegreesEvidenceIterateForHeadersWithBuilder(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, NULL, headersContainer.headerPointers, &builder, &results, callback1);
+    EXPECT_FALSE(res);
+    EXPECT_EQ(results.size(), 2);
+    EXPECT_EQ(results[0], "Big\x1F""Green");
+    EXPECT_EQ(results[1], "Big\x1F""Green\x1F""Apple");
+    fiftyoneDegreesStringBuilderFree(&builder);
+}
+
+static std::string pairKey(fiftyoneDegreesEvidenceKeyValuePair* pair) {
+    return std::string(pair->item.key, pair->item.keyLength);
+}
+
+static std::string pairValue(fiftyoneDegreesEvidenceKeyValuePair* pair) {
+    return std::string(pair->item.value, pair->item.valueLength);
+}
+
+/*
+ * Check that a raw header block is parsed into evidence that points into the
+ * block, with the query string of the request line added when requested.
+ */
+TEST_F(Evidence, AddHeaderBlock) {
+    const char block[] =
+        "GET /path/page?a=1&flag&=ignored&b= HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "User-Agent:  Mozilla/5.0 (X11)  \r\n"
+        "Not a header\r\n"
+        "X-Empty:\n"
+        "Accept: */*\r\n"
+        "\r\n"
+        "Body: not a header";
+    CreateEvidence(2);
+    uint32_t count = fiftyoneDegreesEvidenceAddHeaderBlock(
+        evidence, block, sizeof(block) - 1, true);
+    EXPECT_EQ(7, count);
+
+    std::vector<fiftyoneDegreesEvidenceKeyValuePair*> pairs;
+    for (fiftyoneDegreesEvidenceKeyValuePairArray* current = evidence;
+        current != NULL;
+        current = current->next) {
+        for (uint32_t i = 0; i < current->count; i++) {
+            EXPECT_TRUE(current->items[i].item.key >= block &&
+                current->items[i].item.key < block + sizeof(block));
+            pairs.push_back(&current->items[i]);
+        }
+    }
+    ASSERT_EQ(7, pairs.size());
+    EXPECT_EQ(FIFTYONE_DEGREES_EVIDENCE_QUERY, pairs[0]->prefix);
+    EXPECT_EQ("a", pairKey(pairs[0]));
+    EXPECT_EQ("1", pairValue(pairs[0]));
+    EXPECT_EQ("flag", pairKey(pairs[1]));
+    EXPECT_EQ("", pairValue(pairs[1]));
+    EXPECT_EQ("b", pairKey(pairs[2]));
+    EXPECT_EQ("", pairValue(pairs[2]));
+    EXPECT_EQ(FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, pairs[3]->prefix);
+    EXPECT_EQ("Host", pairKey(pairs[3]));
+    EXPECT_EQ("example.com", pairValue(pairs[3]));
+    EXPECT_EQ("User-Agent", pairKey(pairs[4]));
+    EXPECT_EQ("Mozilla/5.0 (X11)", pairValue(pairs[4]));
+    EXPECT_EQ("X-Empty", pairKey(pairs[5]));
+    EXPECT_EQ("", pairValue(pairs[5]));
+    EXPECT_EQ("Accept", pairKey(pairs[6]));
+    EXPECT_EQ("*/*", pairValue(pairs[6]));
+}
+
+/*
+ * Check that the query string is ignored unless requested, and that a block
+ * without a request line or final empty line is parsed.
+ */
+TEST_F(Evidence, AddHeaderBlock_NoQuery) {
+    const char block[] =
+        "GET /?a=1 HTTP/1.1\r\n"
+        "Host: example.com";
+    CreateEvidence(2);
+    EXPECT_EQ(1, fiftyoneDegreesEvidenceAddHeaderBlock(
+        evidence, block, sizeof(block) - 1, false));
+    EXPECT_EQ("Host", pairKey(&evidence->items[0]));
+    EXPECT_EQ("example.com", pairValue(&evidence->items[0]));
+}
+
+/*
+ * Check that reset evidence can be used again without allocating memory, and
+ * that arrays chained due to overflow are retained.
+ */
+TEST_F(Evidence, Reset_ReusesMemory) {
+    CreateEvidence(1);
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Size", "Big");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Color", "Green");
+    fiftyoneDegreesEvidenceKeyValuePairArray* next = evidence->next;
+    ASSERT_NE(nullptr, next);
+
+    fiftyoneDegreesEvidenceReset(evidence);
+    EXPECT_EQ(0, evidence->count);
+    EXPECT_EQ(0, next->count);
+    EXPECT_EQ(0, fiftyoneDegreesEvidenceIterate(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, NULL, NULL));
+
+    size_t allocated = fiftyoneDegreesMemoryTrackingGetAllocated();
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Material", "Apple");
+    fiftyoneDegreesEvidenceAddString(evidence, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Size", "Small");
+    EXPECT_EQ(allocated, fiftyoneDegreesMemoryTrackingGetAllocated());
+    EXPECT_EQ(next, evidence->next);
+    assertStringHeaderAdded(&evidence->items[0], "Material", "Apple");
+    assertStringHeaderAdded(&next->items[0], "Size", "Small");
+}
+
+/*
+ * Check that evidence can be initialised in caller provided memory which is
+ * not freed, whilst any arrays added due to overflow are.
+ */
+TEST_F(Evidence, Init_CallerMemory) {
+    EXPECT_EQ(nullptr, fiftyoneDegreesEvidenceInit(NULL, 0));
+    size_t size = fiftyoneDegreesEvidenceSize(2);
+    std::vector<uint64_t> memory((size / sizeof(uint64_t)) + 1);
+    EXPECT_EQ(nullptr, fiftyoneDegreesEvidenceInit(memory.data(), 1));
+    fiftyoneDegreesEvidenceKeyValuePairArray* local = 
+        fiftyoneDegreesEvidenceInit(memory.data(), size);
+    ASSERT_NE(nullptr, local);
+    EXPECT_EQ(2, local->capacity);
+    EXPECT_EQ(0, local->count);
+
+    fiftyoneDegreesEvidenceAddString(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Size", "Big");
+    fiftyoneDegreesEvidenceAddString(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Color", "Green");
+    EXPECT_EQ(nullptr, local->next);
+    fiftyoneDegreesEvidenceAddString(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Material", "Apple");
+    EXPECT_NE(nullptr, local->next);
+    assertStringHeaderAdded(&local->items[1], "Color", "Green");
+
+    // Frees the overflow array, but not the caller memory.
+    fiftyoneDegreesEvidenceFree(local);
+    EXPECT_EQ(nullptr, local->next);
+}
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4100)
+#endif
+static bool onMatchContinue(
+	void *state,
+	fiftyoneDegreesEvidenceKeyValuePair *pair) {
+	return true;
+}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+/*
+ * Check that evidence with no capacity of its own resets the arrays added
+ * due to overflow, so only the items added after the reset are iterated.
+ */
+TEST_F(Evidence, Reset_NoCapacity) {
+    size_t size = fiftyoneDegreesEvidenceSize(0);
+    std::vector<uint64_t> memory((size / sizeof(uint64_t)) + 1);
+    fiftyoneDegreesEvidenceKeyValuePairArray* local =
+        fiftyoneDegreesEvidenceInit(memory.data(), size);
+    ASSERT_NE(nullptr, local);
+    EXPECT_EQ(0, local->capacity);
+
+    fiftyoneDegreesEvidenceAddString(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Size", "Big");
+    fiftyoneDegreesEvidenceAddString(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Color", "Green");
+    EXPECT_EQ(2, fiftyoneDegreesEvidenceIterate(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, NULL, onMatchContinue));
+
+    fiftyoneDegreesEvidenceReset(local);
+    EXPECT_EQ(0, fiftyoneDegreesEvidenceIterate(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, NULL, onMatchContinue));
+
+    size_t allocated = fiftyoneDegreesMemoryTrackingGetAllocated();
+    fiftyoneDegreesEvidenceAddString(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, "Material", "Apple");
+    EXPECT_EQ(allocated, fiftyoneDegreesMemoryTrackingGetAllocated());
+    EXPECT_EQ(1, fiftyoneDegreesEvidenceIterate(local, FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING, NULL, onMatchContinue));
+    ASSERT_NE(nullptr, local->next);
+    assertStringHeaderAdded(&local->next->items[0], "Material", "Apple");
+
+    fiftyoneDegreesEvidenceFree(local);
+}
+
+/*
+ * Check that the C++ evidence reuses the C structure after being cleared.
+ */
+TEST_F(Evidence, EvidenceBase_ReusedAfterClear) {
+    EvidenceBase evidenceBase;
+    evidenceBase["header.Size"] = "Big";
+    evidenceBase["header.Color"] = "Green";
+    fiftyoneDegreesEvidenceKeyValuePairArray* first = evidenceBase.get();
+    EXPECT_EQ(2, first->count);
+    evidenceBase.clear();
+    EXPECT_EQ(0, first->count);
+    evidenceBase["header.Material"] = "Apple";
+    fiftyoneDegreesEvidenceKeyValuePairArray* second = evidenceBase.get();
+    EXPECT_EQ(first, second);
+    ASSERT_EQ(1, second->count);
+    assertStringHeaderAdded(&second->items[0], "Material", "Apple");
+}
+
+/*
+ * Check that the flat evidence keeps the C structure in sync as items are
+ * added and replaced, ignoring items with unknown prefixes.
+ */
+TEST_F(Evidence, FlatEvidence_InSync) {
+    FlatEvidence flat;
+    flat.add("header.Size", "Big");
+    flat.add("unknown.Color", "Green");
+    flat.add("query.Material", "Apple");
+    fiftyoneDegreesEvidenceKeyValuePairArray* pairs = flat.get();
+    ASSERT_EQ(2, pairs->count);
+    assertStringHeaderAdded(&pairs->items[0], "Size", "Big");
+    EXPECT_EQ(
+        (int)FIFTYONE_DEGREES_EVIDENCE_QUERY,
+        (int)pairs->items[1].prefix);
+    EXPECT_STREQ("Material", pairs->items[1].item.key);
+    EXPECT_EQ(3u, flat.getItemCount());
+    EXPECT_EQ("Green", flat.getValue("unknown.Color"));
+    EXPECT_EQ(nullptr, flat.getValue("header.Missing").data());
+
+    flat.add("header.Size", "Small");
+    EXPECT_EQ(2, pairs->count);
+    EXPECT_EQ(3u, flat.getItemCount());
+    assertStringHeaderAdded(&pairs->items[0], "Size", "Small");
+    EXPECT_EQ(5u, pairs->items[0].item.valueLength);
+}
+
+/*
+ * Check that the pairs point to the right characters after the arena has
+ * grown many times, and that pairs added during processing are removed.
+ */
+TEST_F(Evidence, FlatEvidence_Growth) {
+    FlatEvidence flat;
+    for (int i = 0; i < 100; i++) {
+        std::string index = std::to_string(i);
+        flat.add("header.Key" + index, "Value" + index);
+    }
+    fiftyoneDegreesEvidenceKeyValuePairArray* pairs = flat.get();
+    ASSERT_EQ(100, pairs->count);
+    for (int i = 0; i < 100; i++) {
+        std::string index = std::to_string(i);
+        assertStringHeaderAdded(
+            &pairs->items[i],
+            ("Key" + index).c_str(),
+            ("Value" + index).c_str());
+    }
+
+    fiftyoneDegreesEvidenceAddString(
+        pairs,
+        FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING,
+        "Pseudo",
+        "Value");
+    EXPECT_EQ(pairs, flat.get());
+    EXPECT_EQ(100, pairs->count);
+}
+
+/*
+ * Check that cleared flat evidence reuses all its memory for the next
+ * request.
+ */
+TEST_F(Evidence, FlatEvidence_ReusedAfterClear) {
+    FlatEvidence flat;
+    flat.reserve(2, 64);
+    flat.add("header.Size", "Big");
+    flat.add("header.Color", "Green");
+    fiftyoneDegreesEvidenceKeyValuePairArray* first = flat.get();
+    const char* key = first->items[0].item.key;
+    EXPECT_EQ(2, first->count);
+
+    size_t allocated = fiftyoneDegreesMemoryTrackingGetAllocated();
+    flat.clear();
+    EXPECT_EQ(0u, flat.getItemCount());
+    EXPECT_EQ(0, first->count);
+    flat.add("header.Material", "Apple");
+    fiftyoneDegreesEvidenceKeyValuePairArray* second = flat.get();
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(key, second->items[0].item.key);
+    EXPECT_EQ(allocated, fiftyoneDegreesMemoryTrackingGetAllocated());
+    ASSERT_EQ(1, second->count);
+    assertStringHeaderAdded(&second->items[0], "Material", "Apple");
+}
+
+/*
+ * Check that values are found and replaced by key when there are enough
+ * keys for the hash table to grow many times, and that keys which differ
+ * only by case or length are different items.
+ */
+TEST_F(Evidence, FlatEvidence_ManyKeys) {
+    FlatEvidence flat;
+    for (int i = 0; i < 1000; i++) {
+        std::string index = std::to_string(i);
+        flat.add("header.Key" + index, "Value" + index);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        std::string index = std::to_string(i);
+        flat.add("header.Key" + index, "Replaced" + index);
+    }
+    flat.add("header.KEY1", "Upper");
+    flat.add("header.Key", "Short");
+    EXPECT_EQ(1002u, flat.getItemCount());
+    fiftyoneDegreesEvidenceKeyValuePairArray* pairs = flat.get();
+    ASSERT_EQ(1002, pairs->count);
+    for (int i = 0; i < 1000; i++) {
+        std::string index = std::to_string(i);
+        std::string expected = (i % 2 ? "Value" : "Replaced") + index;
+        EXPECT_EQ(expected, flat.getValue("header.Key" + index));
+        assertStringHeaderAdded(
+            &pairs->items[i],
+            ("Key" + index).c_str(),
+            expected.c_str());
+    }
+    EXPECT_EQ("Upper", flat.getValue("header.KEY1"));
+    EXPECT_EQ("Short", flat.getValue("header.Key"));
+    EXPECT_EQ(nullptr, flat.getValue("header.Key1000").data());
+
+    flat.clear();
+    EXPECT_EQ(nullptr, flat.getValue("header.Key1").data());
+    flat.add("header.Key1", "Again");
+    EXPECT_EQ("Again", flat.getValue("header.Key1"));
+    EXPECT_EQ(1u, flat.getItemCount());
+}
+
+/*
+ * Check that a replacement value which fits is written over the previous
+ * value rather than added to the end of the arena.
+ */
+TEST_F(Evidence, FlatEvidence_ReplaceInPlace) {
+    FlatEvidence flat;
+    flat.add("header.Size", "Large");
+    fiftyoneDegreesEvidenceKeyValuePairArray* pairs = flat.get();
+    const char* first = flat.getValue("header.Size").data();
+    flat.add("header.Size", "Big");
+    EXPECT_EQ(first, flat.getValue("header.Size").data());
+    EXPECT_EQ("Big", flat.getValue("header.Size"));
+    assertStringHeaderAdded(&pairs->items[0], "Size", "Big");
+    EXPECT_EQ(3u, pairs->items[0].item.valueLength);
+    flat.add("header.Size", "Small");
+    EXPECT_EQ(first, flat.getValue("header.Size").data());
+    assertStringHeaderAdded(&pairs->items[0], "Size", "Small");
+    flat.add("header.Size", "Enormous");
+    EXPECT_NE(first, flat.getValue("header.Size").data());
+    assertStringHeaderAdded(&pairs->items[0], "Size", "Enormous");
+    EXPECT_EQ(1u, flat.getItemCount());
+}
+
+/*
+ * Check that flat evidence can be moved but not copied, and that the moved
+ * to instance keeps the C structure whilst the moved from instance is empty
+ * and can be used again.
+ */
+TEST_F(Evidence, FlatEvidence_Move) {
+    EXPECT_FALSE(std::is_copy_constructible<FlatEvidence>::value);
+    EXPECT_FALSE(std::is_copy_assignable<FlatEvidence>::value);
+    FlatEvidence flat;
+    flat.add("header.Size", "Big");
+    fiftyoneDegreesEvidenceKeyValuePairArray* pairs = flat.get();
+
+    FlatEvidence moved(std::move(flat));
+    EXPECT_EQ(pairs, moved.get());
+    assertStringHeaderAdded(&pairs->items[0], "Size", "Big");
+    EXPECT_EQ(0u, flat.getItemCount());
+    EXPECT_EQ(0u, flat.get()->count);
+
+    FlatEvidence assigned;
+    assigned.add("header.Color", "Green");
+    assigned = std::move(moved);
+    EXPECT_EQ(pairs, assigned.get());
+    EXPECT_EQ("Big", assigned.getValue("header.Size"));
+    EXPECT_EQ(nullptr, assigned.getValue("header.Color").data());
+    EXPECT_EQ(0u, moved.getItemCount());
+
+    flat.add("header.Material", "Apple");
+    ASSERT_EQ(1u, flat.get()->count);
+    assertStringHeaderAdded(&flat.get()->items[0], "Material", "Apple");
+}
+
+// Engine which records the evidence it is given to process.
+class RecordingEngine : public EngineBase {
+public:
+    RecordingEngine() : EngineBase(nullptr, nullptr) {}
+    using EngineBase::processBase;
+    ResultsBase* processBase(EvidenceBase *evidence) const override {
+        processed = *evidence;
+        return nullptr;
+    }
+    void refreshData() const override {}
+    void refreshData(const char *) const override {}
+    void refreshData(void *, fiftyoneDegreesFileOffset) const override {}
+    void refreshData(
+        unsigned char[],
+        fiftyoneDegreesFileOffset) const override {}
+    string getDataFilePath() const override { return ""; }
+    string getDataFileTempPath() const override { return ""; }
+    Date getPublishedTime() const override { return Date(); }
+    Date getUpdateAvailableTime() const override { return Date(); }
+    string getProduct() const override { return "Recording"; }
+    string getType() const override { return "Test"; }
+    mutable map<string, string> processed;
+};
+
+/*
+ * Check that an engine which only processes evidence maps is given all the
+ * items of flat evidence, including those which are not relevant, with the
+ * latest values.
+ */
+TEST_F(Evidence, FlatEvidence_ProcessedByEngine) {
+    RecordingEngine engine;
+    const EngineBase *base = &engine;
+    FlatEvidence flat;
+    flat.add("header.Size", "Large");
+    flat.add("unknown.Color", "Green");
+    flat.add("query.Material", "Apple");
+    flat.add("header.Size", "Big");
+    EXPECT_EQ(nullptr, base->processBase(&flat));
+    map<string, string> expected = {
+        { "header.Size", "Big" },
+        { "unknown.Color", "Green" },
+        { "query.Material", "Apple" } };
+    EXPECT_EQ(expected, engine.processed);
+}
+
 TEST_F(Evidence, freeNullEvidence) {
     fiftyoneDegreesEvidenceKeyValuePairArray *evidence2 = NULL;
     EvidenceFree(evidence2);
@@ -278,6 +278,55 @@ TEST_F(HeadersTests, HttpPrefix) {
 			strlen("HTTP_Black")));
 }
 
+// ----------------------------------------------------------------------
+// Check that the index of every header can be found regardless of the case
+// of the name, and that names which are not headers, or are only a prefix of
+// a header, are not found.
+// ----------------------------------------------------------------------
+const char* testHeaders_GetIndex[] = {
+	"User-Agent",
+	"Accept-Language",
+	"Sec-CH-UA",
+	"Sec-CH-UA-Mobile",
+	"Sec-CH-UA-Platform",
+	"Sec-CH-UA-Platform-Version",
+	"Sec-CH-UA-Model",
+	"Sec-CH-UA-Full-Version-List",
+	"X-Forwarded-For",
+	"Host",
+};
+
+TEST_F(HeadersTests, GetIndexCaseInsensitive) {
+	CreateHeaders(
+		testHeaders_GetIndex,
+		sizeof(testHeaders_GetIndex) / sizeof(const char*),
+		true);
+	for (uint32_t i = 0; i < headers->count; i++) {
+		std::string name = headers->items[i].name;
+		std::string upper = name, lower = name;
+		std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+		std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+		std::string prefixed = "HTTP_" + upper;
+		EXPECT_EQ((int)i, fiftyoneDegreesHeaderGetIndex(
+			headers, name.c_str(), name.length()));
+		EXPECT_EQ((int)i, fiftyoneDegreesHeaderGetIndex(
+			headers, upper.c_str(), upper.length()));
+		EXPECT_EQ((int)i, fiftyoneDegreesHeaderGetIndex(
+			headers, lower.c_str(), lower.length()));
+		EXPECT_EQ((int)i, fiftyoneDegreesHeaderGetIndex(
+			headers, prefixed.c_str(), prefixed.length()));
+	}
+	EXPECT_EQ(-1, fiftyoneDegreesHeaderGetIndex(
+		headers, "Sec-CH", strlen("Sec-CH")));
+	EXPECT_EQ(-1, fiftyoneDegreesHeaderGetIndex(
+		headers, "User-Agent-X", strlen("User-Agent-X")));
+	EXPECT_EQ(-1, fiftyoneDegreesHeaderGetIndex(
+		headers, "", 0));
+	// Only the length provided is considered.
+	EXPECT_EQ(0, fiftyoneDegreesHeaderGetIndex(
+		headers, "user-agentXYZ", strlen("user-agent")));
+}
+
 TEST_F(HeadersTests, IsHttp) {
     CreateHeaders(
         testHeaders_HttpPrefix,
@@ -437,3 +437,94 @@ TEST(CompareIp, CompareIp_Ip_Invalid) {
 			IP_TYPE_INVALID) == 0) << "Result should be 0 "
 		"where type is invalid\n";
 }
+
+// ------------------------------------------------------------------------------
+// Embedded IPv4 and list tests
+// ------------------------------------------------------------------------------
+TEST(ParseIp, ParseIp_Ipv6_EmbeddedIpv4)
+{
+	auto const result = parseIpAddressString("::ffff:192.168.1.2");
+	byte expected[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 255, 255, 192, 168, 1, 2 };
+	ASSERT_TRUE(result) <<
+		L"Expected result to be non-NULL.";
+	EXPECT_TRUE(CheckResult(result->value, expected, sizeof(expected))) <<
+		L"Expected result to be '::ffff:192.168.1.2'";
+	EXPECT_EQ(result->type, FIFTYONE_DEGREES_IP_TYPE_IPV6) <<
+		L"Expected type to be IPv6";
+}
+TEST(ParseIp, ParseIp_Ipv6_Full_EmbeddedIpv4)
+{
+	auto const result = parseIpAddressString("1:2:3:4:5:6:7.8.9.10");
+	byte expected[] = { 0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6, 7, 8, 9, 10 };
+	ASSERT_TRUE(result) <<
+		L"Expected result to be non-NULL.";
+	EXPECT_TRUE(CheckResult(result->value, expected, sizeof(expected))) <<
+		L"Expected result to be '1:2:3:4:5:6:7.8.9.10'";
+}
+TEST(ParseIp, ParseIp_Invalid_ipv6TwoAbbreviations)
+{
+	auto const result = parseIpAddressString("1::2::3");
+	EXPECT_FALSE(result);
+}
+TEST(ParseIp, ParseIp_Invalid_ipv6EmbeddedIpv4TooMany)
+{
+	auto const result = parseIpAddressString("1:2:3:4:5:6:7:8.9.10.11");
+	EXPECT_FALSE(result);
+}
+TEST(ParseIp, ParseIp_Invalid_ipv6EmbeddedIpv4NotLast)
+{
+	auto const result = parseIpAddressString("::1.2.3.4:5");
+	EXPECT_FALSE(result);
+}
+TEST(ParseIp, ParseIp_Invalid_ipv6AbbreviationOfNoGroups)
+{
+	EXPECT_FALSE(parseIpAddressString("1:2:3:4:5:6:7:8::"));
+	EXPECT_FALSE(parseIpAddressString("::1:2:3:4:5:6:7:8"));
+	EXPECT_FALSE(parseIpAddressString("1:2:3:4::5:6:7:8"));
+	EXPECT_FALSE(parseIpAddressString("1:2:3:4:5:6::1.2.3.4"));
+}
+TEST(ParseIp, ParseIp_Invalid_ipv6LeadingColon)
+{
+	auto const result = parseIpAddressString(":1::2");
+	EXPECT_FALSE(result);
+}
+TEST(ParseIp, ParseIp_Invalid_NotModified)
+{
+	constexpr byte initial[] {
+		67, 13, 43, 47, 53, 29, 61, 19, 41, 31, 59, 71, 23, 37, 17, 11,
+	};
+	std::unique_ptr<IpAddress> ipAddress = std::make_unique<IpAddress>();
+	memcpy(ipAddress->value, initial, sizeof(initial));
+	const char ip[] = "1:2:3:4:5:6:7";
+	EXPECT_FALSE(parseIpAddressInPlace(ipAddress, ip, sizeof(ip) - 1));
+	EXPECT_TRUE(CheckResult(ipAddress->value, initial, sizeof(initial)));
+}
+TEST(ParseIp, ParseIps_List)
+{
+	const char ips[] = " 1.2.3.4, [2001::1]:80 ,,invalid,5.6.7.8:443,::1";
+	IpAddress addresses[5];
+	const uint32_t count = IpAddressesParse(
+		ips, ips + sizeof(ips) - 1, addresses, 5);
+	ASSERT_EQ(5, count);
+	byte expected0[] = { 1, 2, 3, 4 };
+	byte expected1[] = { 32, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+	byte expected3[] = { 5, 6, 7, 8 };
+	byte expected4[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+	EXPECT_EQ(FIFTYONE_DEGREES_IP_TYPE_IPV4, addresses[0].type);
+	EXPECT_TRUE(CheckResult(addresses[0].value, expected0, sizeof(expected0)));
+	EXPECT_EQ(FIFTYONE_DEGREES_IP_TYPE_IPV6, addresses[1].type);
+	EXPECT_TRUE(CheckResult(addresses[1].value, expected1, sizeof(expected1)));
+	EXPECT_EQ(FIFTYONE_DEGREES_IP_TYPE_INVALID, addresses[2].type);
+	EXPECT_EQ(FIFTYONE_DEGREES_IP_TYPE_IPV4, addresses[3].type);
+	EXPECT_TRUE(CheckResult(addresses[3].value, expected3, sizeof(expected3)));
+	EXPECT_EQ(FIFTYONE_DEGREES_IP_TYPE_IPV6, addresses[4].type);
+	EXPECT_TRUE(CheckResult(addresses[4].value, expected4, sizeof(expected4)));
+}
+TEST(ParseIp, ParseIps_Capacity)
+{
+	const char ips[] = "1.2.3.4,5.6.7.8,9.10.11.12";
+	IpAddress addresses[2];
+	EXPECT_EQ(2, IpAddressesParse(ips, ips + sizeof(ips) - 1, addresses, 2));
+	EXPECT_EQ(5, addresses[1].value[0]);
+	EXPECT_EQ(0, IpAddressesParse(nullptr, nullptr, addresses, 2));
+}
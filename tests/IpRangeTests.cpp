@@ -0,0 +1,237 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "pch.h"
+#include "Base.hpp"
+#include "FixedSizeCollection.hpp"
+#include "../ipRange.h"
+#include "../fiftyone.h"
+#include <random>
+
+/**
+ * Range as it might be stored in a data file with a value before the start
+ * IP address so that the start offset is exercised.
+ */
+typedef struct test_ip_range_t {
+	uint32_t value;
+	byte start[FIFTYONE_DEGREES_IPV6_LENGTH];
+} testIpRange;
+
+/**
+ * IP range index test class used to compare the index lookups with a binary
+ * search of the ranges.
+ */
+class IpRangeTests : public Base {
+protected:
+	std::vector<testIpRange> ranges;
+
+	void SetUp() {
+		Base::SetUp();
+	}
+
+	void TearDown() {
+		Base::TearDown();
+	}
+
+	/**
+	 * Creates count ranges in ascending order with random gaps between the
+	 * start addresses.
+	 */
+	void createRanges(uint32_t count, IpType type, uint32_t seed) {
+		std::mt19937 random(seed);
+		uint32_t length = type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+			FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+		byte current[FIFTYONE_DEGREES_IPV6_LENGTH] = { 0 };
+		current[0] = 1;
+		ranges.clear();
+		for (uint32_t i = 0; i < count; i++) {
+			// Add a random amount to the last four bytes so that ranges share
+			// long prefixes, with an occasional carry into the first byte.
+			uint32_t add = (random() % 1000) + 1;
+			for (int b = (int)length - 1; b >= 0 && add > 0; b--) {
+				uint32_t sum = current[b] + (add & 0xFF);
+				current[b] = (byte)sum;
+				add = (add >> 8) + (sum >> 8);
+			}
+			testIpRange range;
+			memset(&range, 0, sizeof(range));
+			range.value = i;
+			memcpy(range.start, current, length);
+			ranges.push_back(range);
+		}
+	}
+
+	/**
+	 * Reference implementation returning the last range with a start address
+	 * less than or equal to the address.
+	 */
+	long find(const byte *address, IpType type) {
+		long result = -1;
+		for (size_t i = 0; i < ranges.size(); i++) {
+			if (IpAddressesCompare(ranges[i].start, address, type) <= 0) {
+				result = (long)i;
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * Checks that the index returns the same result as the reference for the
+	 * start of every range, the address before it, and random addresses.
+	 */
+	void verify(IpRangeIndex *index, IpType type, uint32_t seed) {
+		std::mt19937 random(seed);
+		uint32_t length = type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+			FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+		byte address[FIFTYONE_DEGREES_IPV6_LENGTH];
+		for (size_t i = 0; i < ranges.size(); i++) {
+			EXPECT_EQ((long)i, IpRangeIndexLookup(index, ranges[i].start));
+			memcpy(address, ranges[i].start, length);
+			for (int b = (int)length - 1; b >= 0; b--) {
+				if (address[b]-- != 0) {
+					break;
+				}
+			}
+			EXPECT_EQ(find(address, type), IpRangeIndexLookup(index, address));
+		}
+		for (int i = 0; i < 200; i++) {
+			for (uint32_t b = 0; b < length; b++) {
+				address[b] = (byte)random();
+			}
+			address[0] = (byte)(address[0] % 3);
+			EXPECT_EQ(find(address, type), IpRangeIndexLookup(index, address));
+		}
+	}
+
+	IpRangeIndex* create(IpType type, Exception *exception) {
+		FixedSizeCollection<testIpRange> collection(ranges);
+		return IpRangeIndexCreate(
+			collection.getState()->collection,
+			(uint32_t)ranges.size(),
+			offsetof(testIpRange, start),
+			type,
+			exception);
+	}
+};
+
+/**
+ * Check that lookups of IPv4 addresses match a search of the ranges for
+ * sizes either side of a single block and with several levels.
+ */
+TEST_F(IpRangeTests, LookupIpv4) {
+	uint32_t counts[] = { 1, 15, 16, 17, 256, 257, 5000 };
+	for (uint32_t count : counts) {
+		EXCEPTION_CREATE
+		createRanges(count, FIFTYONE_DEGREES_IP_TYPE_IPV4, count);
+		IpRangeIndex *index = create(FIFTYONE_DEGREES_IP_TYPE_IPV4, exception);
+		EXCEPTION_THROW
+		ASSERT_NE(nullptr, index);
+		verify(index, FIFTYONE_DEGREES_IP_TYPE_IPV4, count);
+		IpRangeIndexFree(index);
+	}
+}
+
+/**
+ * Check that lookups of IPv6 addresses match a search of the ranges.
+ */
+TEST_F(IpRangeTests, LookupIpv6) {
+	uint32_t counts[] = { 1, 4, 5, 64, 65, 3000 };
+	for (uint32_t count : counts) {
+		EXCEPTION_CREATE
+		createRanges(count, FIFTYONE_DEGREES_IP_TYPE_IPV6, count);
+		IpRangeIndex *index = create(FIFTYONE_DEGREES_IP_TYPE_IPV6, exception);
+		EXCEPTION_THROW
+		ASSERT_NE(nullptr, index);
+		verify(index, FIFTYONE_DEGREES_IP_TYPE_IPV6, count);
+		IpRangeIndexFree(index);
+	}
+}
+
+/**
+ * Check that an index with no ranges never finds a range.
+ */
+TEST_F(IpRangeTests, Empty) {
+	EXCEPTION_CREATE
+	createRanges(1, FIFTYONE_DEGREES_IP_TYPE_IPV4, 0);
+	FixedSizeCollection<testIpRange> collection(ranges);
+	IpRangeIndex *index = IpRangeIndexCreate(
+		collection.getState()->collection,
+		0,
+		offsetof(testIpRange, start),
+		FIFTYONE_DEGREES_IP_TYPE_IPV4,
+		exception);
+	EXCEPTION_THROW
+	byte address[FIFTYONE_DEGREES_IPV4_LENGTH] = { 255, 255, 255, 255 };
+	EXPECT_EQ(-1, IpRangeIndexLookup(index, address));
+	IpRangeIndexFree(index);
+}
+
+/**
+ * Check that ranges which are not in ascending order are reported as corrupt.
+ */
+TEST_F(IpRangeTests, Unordered) {
+	EXCEPTION_CREATE
+	createRanges(100, FIFTYONE_DEGREES_IP_TYPE_IPV4, 1);
+	std::swap(ranges[40], ranges[41]);
+	IpRangeIndex *index = create(FIFTYONE_DEGREES_IP_TYPE_IPV4, exception);
+	EXPECT_EQ(nullptr, index);
+	EXPECT_EQ(FIFTYONE_DEGREES_STATUS_CORRUPT_DATA, exception->status);
+}
+
+/**
+ * Check that an index created over a copy of the image of another index, as
+ * would happen with a memory mapped file, returns the same results and that
+ * an invalid image is rejected.
+ */
+TEST_F(IpRangeTests, FromMemory) {
+	EXCEPTION_CREATE
+	createRanges(1000, FIFTYONE_DEGREES_IP_TYPE_IPV6, 2);
+	IpRangeIndex *index = create(FIFTYONE_DEGREES_IP_TYPE_IPV6, exception);
+	EXCEPTION_THROW
+	EXPECT_EQ(
+		IpRangeIndexSize(FIFTYONE_DEGREES_IP_TYPE_IPV6, 1000),
+		index->size);
+	std::vector<uint64_t> image(index->size / sizeof(uint64_t));
+	memcpy(image.data(), index->memory, index->size);
+	IpRangeIndexFree(index);
+
+	IpRangeIndex *mapped = IpRangeIndexCreateFromMemory(
+		image.data(),
+		image.size() * sizeof(uint64_t),
+		exception);
+	EXCEPTION_THROW
+	ASSERT_NE(nullptr, mapped);
+	EXPECT_EQ(nullptr, mapped->memoryToFree);
+	verify(mapped, FIFTYONE_DEGREES_IP_TYPE_IPV6, 2);
+	IpRangeIndexFree(mapped);
+
+	EXPECT_EQ(nullptr, IpRangeIndexCreateFromMemory(
+		image.data(),
+		image.size() * sizeof(uint64_t) - 64,
+		exception));
+	EXPECT_EQ(FIFTYONE_DEGREES_STATUS_CORRUPT_DATA, exception->status);
+	image[0] = 0;
+	EXPECT_EQ(nullptr, IpRangeIndexCreateFromMemory(
+		image.data(),
+		image.size() * sizeof(uint64_t),
+		exception));
+}
@@ -171,7 +171,7 @@ TEST_F(JsonTests, basicJsonForming) {
 
     fiftyoneDegreesJsonDocumentEnd(&json);
 
-    EXPECT_STREQ(json.builder.ptr, "{\"Brightness\":\"Bright\",\"Color\":[\"Black\",\"Blue\"],\"Condition\":\"\\\"Bro\\ken\\\"\",\"Flexibility\":\"\\t\\r\\f\\bBendable\\n\"}");
+    EXPECT_STREQ(json.builder.ptr, "{\"Brightness\":\"Bright\",\"Color\":[\"Black\",\"Blue\"],\"Condition\":\"\\\"Bro\\\\ken\\\"\",\"Flexibility\":\"\\t\\r\\f\\bBendable\\n\"}");
 
     fiftyoneDegreesFree(builder.ptr);
 }
@@ -214,3 +214,310 @@ TEST_F(JsonTests, unhappyPaths) {
     
     fiftyoneDegreesFree(builder.ptr);
 }
+
+// Appends the characters passed by the string builder to a std::string.
+static void appendToString(void *state, const char *chars, size_t length) {
+    ((std::string*)state)->append(chars, length);
+}
+
+// Writes all the properties with their first value to the JSON document.
+static void writeAllProperties(
+    fiftyoneDegreesJson *json,
+    fiftyoneDegreesCollection *propertiesCollection,
+    fiftyoneDegreesCollection *valuesCollection,
+    fiftyoneDegreesCollection *stringsCollection,
+    int count,
+    int perProperty) {
+    fiftyoneDegreesException *exception = json->exception;
+    fiftyoneDegreesJsonDocumentStart(json);
+    for (int propIdx = 0; propIdx < count; ++propIdx) {
+        fiftyoneDegreesCollectionItem propertyItem;
+        fiftyoneDegreesCollectionItem valueItem;
+        fiftyoneDegreesDataReset(&propertyItem.data);
+        fiftyoneDegreesDataReset(&valueItem.data);
+        fiftyoneDegreesProperty *property = fiftyoneDegreesPropertyGet(
+            propertiesCollection, propIdx, &propertyItem, exception);
+        fiftyoneDegreesList valuesList;
+        fiftyoneDegreesListInit(&valuesList, 1);
+        const fiftyoneDegreesValue *value = fiftyoneDegreesValueGet(
+            valuesCollection, propIdx * (perProperty - 1), &valueItem, exception);
+        fiftyoneDegreesValueGetName(stringsCollection, value, &valueItem, exception);
+        fiftyoneDegreesListAdd(&valuesList, &valueItem);
+        json->property = property;
+        json->values = &valuesList;
+        if (propIdx > 0) {
+            fiftyoneDegreesJsonPropertySeparator(json);
+        }
+        fiftyoneDegreesJsonPropertyStart(json);
+        fiftyoneDegreesJsonPropertyValues(json);
+        fiftyoneDegreesJsonPropertyEnd(json);
+        fiftyoneDegreesListFree(&valuesList);
+    }
+    fiftyoneDegreesJsonDocumentEnd(json);
+}
+
+/**
+ * Check that a document written through a sink with a buffer much smaller
+ * than the output is the same as one written to a buffer large enough to
+ * hold the whole document.
+ */
+TEST_F(JsonTests, sinkMatchesBuffer) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    std::vector<char> large(4096);
+    fiftyoneDegreesJson json {
+        { large.data(), large.size() },
+        stringsCollection,
+        NULL,
+        NULL,
+        exception,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+    };
+    writeAllProperties(
+        &json,
+        propertiesCollection,
+        valuesCollection,
+        stringsCollection,
+        N_PROPERTIES,
+        N_PER_PROPERTY);
+    EXPECT_TRUE(EXCEPTION_OKAY);
+    EXPECT_FALSE(json.builder.full);
+    std::string expected(large.data());
+
+    std::string streamed;
+    char small[8];
+    fiftyoneDegreesJson sinkJson {
+        { small, sizeof(small) },
+        stringsCollection,
+        NULL,
+        NULL,
+        exception,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+    };
+    sinkJson.builder.sink = appendToString;
+    sinkJson.builder.sinkState = &streamed;
+    writeAllProperties(
+        &sinkJson,
+        propertiesCollection,
+        valuesCollection,
+        stringsCollection,
+        N_PROPERTIES,
+        N_PER_PROPERTY);
+    EXPECT_TRUE(EXCEPTION_OKAY);
+    EXPECT_FALSE(sinkJson.builder.full);
+    EXPECT_EQ(expected, streamed);
+    EXPECT_EQ(json.builder.added, sinkJson.builder.added);
+    EXPECT_STREQ("", small);
+}
+
+// Reference implementation of the JSON escaping of a string value.
+static std::string escapeReference(const std::string &value) {
+    static const char hex[] = "0123456789abcdef";
+    std::string result = "\"";
+    for (char c : value) {
+        switch (c) {
+        case '\"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\b': result += "\\b"; break;
+        case '\f': result += "\\f"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                result += "\\u00";
+                result += hex[((unsigned char)c >> 4) & 0x0F];
+                result += hex[(unsigned char)c & 0x0F];
+            }
+            else {
+                result += c;
+            }
+            break;
+        }
+    }
+    return result + "\"";
+}
+
+/**
+ * Check that every control character, the quote and the reverse solidus are
+ * escaped, including control characters without a short escape sequence,
+ * wherever they appear in strings longer and shorter than a vector.
+ */
+TEST_F(JsonTests, escapeAllControlCharacters) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    std::vector<char> buffer(1024);
+    std::vector<std::string> values;
+    for (int c = 0; c < 0x20; c++) {
+        values.push_back(std::string(1, (char)c) + "abc");
+    }
+    values.push_back("\"");
+    values.push_back("\\");
+    values.push_back("C:\\Windows\\");
+    values.push_back("no escaping needed in this long value at all");
+    for (size_t position = 0; position < 40; position += 3) {
+        std::string value(40, 'x');
+        value[position] = position / 3 % 3 == 0 ? '\"' :
+            position / 3 % 3 == 1 ? '\\' : '\x1e';
+        values.push_back(value);
+    }
+    for (const std::string &value : values) {
+        std::vector<byte> stored(sizeof(int16_t) + value.size() + 1);
+        *(int16_t*)stored.data() = (int16_t)(value.size() + 1);
+        memcpy(stored.data() + sizeof(int16_t), value.c_str(), value.size() + 1);
+        fiftyoneDegreesCollectionItem item;
+        fiftyoneDegreesDataReset(&item.data);
+        item.data.ptr = stored.data();
+        fiftyoneDegreesList list;
+        list.items = &item;
+        list.count = 1;
+        list.capacity = 1;
+        fiftyoneDegreesJson json {
+            { buffer.data(), buffer.size() },
+            stringsCollection,
+            NULL,
+            &list,
+            exception,
+            FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+        };
+        fiftyoneDegreesStringBuilderInit(&json.builder);
+        fiftyoneDegreesJsonPropertyValues(&json);
+        fiftyoneDegreesStringBuilderComplete(&json.builder);
+        EXPECT_TRUE(EXCEPTION_OKAY);
+        EXPECT_EQ(escapeReference(value), std::string(buffer.data()));
+    }
+}
+
+/**
+ * Check that a document written from pre-rendered fragments is the same as
+ * one where the names and values are fetched and escaped, including for a
+ * property which was not available when the fragments were created.
+ */
+TEST_F(JsonTests, fragmentsMatchRendered) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    const uint32_t availableCount = 4;
+    const uint32_t writtenCount = 5;
+    fiftyoneDegreesPropertiesAvailable * FIFTYONE_DEGREES_ARRAY_CREATE(
+        fiftyoneDegreesPropertyAvailable, available, availableCount);
+    for (uint32_t i = 0; i < availableCount; i++) {
+        available->items[i].propertyIndex = i;
+        fiftyoneDegreesDataReset(&available->items[i].name.data);
+        available->items[i].evidenceProperties = NULL;
+        available->items[i].delayExecution = false;
+        available->count++;
+    }
+    fiftyoneDegreesJsonFragments *fragments =
+        fiftyoneDegreesJsonFragmentsCreate(
+            propertiesCollection,
+            NULL,
+            valuesCollection,
+            stringsCollection,
+            available,
+            exception);
+    ASSERT_TRUE(EXCEPTION_OKAY);
+    ASSERT_NE(nullptr, fragments);
+    EXPECT_EQ(availableCount * (N_PER_PROPERTY - 1), fragments->valuesCount);
+
+    std::string results[2];
+    for (int useFragments = 0; useFragments < 2; useFragments++) {
+        std::vector<char> buffer(BUFFER_SIZE);
+        fiftyoneDegreesJson json {
+            { buffer.data(), buffer.size() },
+            stringsCollection,
+            NULL,
+            NULL,
+            exception,
+            FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+            useFragments ? fragments : NULL,
+        };
+        fiftyoneDegreesJsonDocumentStart(&json);
+        for (uint32_t propIdx = 0; propIdx < writtenCount; propIdx++) {
+            fiftyoneDegreesCollectionItem propertyItem;
+            fiftyoneDegreesDataReset(&propertyItem.data);
+            json.property = fiftyoneDegreesPropertyGet(
+                propertiesCollection, propIdx, &propertyItem, exception);
+            uint32_t valueIndexes[] = {
+                json.property->firstValueIndex,
+                json.property->firstValueIndex + 2 };
+            if (propIdx > 0) {
+                fiftyoneDegreesJsonPropertySeparator(&json);
+            }
+            fiftyoneDegreesJsonPropertyStart(&json);
+            if (useFragments) {
+                fiftyoneDegreesJsonPropertyValueIndexes(
+                    &json, valueIndexes, 2);
+            }
+            else {
+                fiftyoneDegreesList valuesList;
+                fiftyoneDegreesCollectionItem valueItems[2];
+                fiftyoneDegreesListInit(&valuesList, 2);
+                for (int v = 0; v < 2; v++) {
+                    fiftyoneDegreesDataReset(&valueItems[v].data);
+                    const fiftyoneDegreesValue *value = fiftyoneDegreesValueGet(
+                        valuesCollection, valueIndexes[v], &valueItems[v], exception);
+                    fiftyoneDegreesValueGetName(
+                        stringsCollection, value, &valueItems[v], exception);
+                    fiftyoneDegreesListAdd(&valuesList, &valueItems[v]);
+                }
+                json.values = &valuesList;
+                fiftyoneDegreesJsonPropertyValues(&json);
+                fiftyoneDegreesListFree(&valuesList);
+            }
+            fiftyoneDegreesJsonPropertyEnd(&json);
+            COLLECTION_RELEASE(propertiesCollection, &propertyItem);
+        }
+        fiftyoneDegreesJsonDocumentEnd(&json);
+        EXPECT_TRUE(EXCEPTION_OKAY);
+        results[useFragments] = buffer.data();
+    }
+    EXPECT_EQ(results[0], results[1]);
+    EXPECT_NE(std::string::npos, results[1].find("\"Material\":\"Fabric\""));
+
+    fiftyoneDegreesJsonFragmentsFree(fragments);
+    fiftyoneDegreesFree(available);
+}
+
+/**
+ * Check that a well known binary value is written as a WKT string by default
+ * and as a GeoJSON object when geometryAsGeoJson is set.
+ */
+TEST_F(JsonTests, geometryAsGeoJson) {
+    FIFTYONE_DEGREES_EXCEPTION_CREATE;
+    byte stored[] = {
+        21, 0, // length of the WKB
+        0x01, 0x01, 0x00, 0x00, 0x00, // POINT
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x40,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xbf };
+    fiftyoneDegreesProperty property = {
+        0, 0, 1, 0, 1, 0, 1, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB, 0,
+        stringsCollectionHelper->getState()->offsets[48],
+        0, 0, 0, 0, 0, 0, 0 };
+    fiftyoneDegreesCollectionItem valueItem;
+    fiftyoneDegreesDataReset(&valueItem.data);
+    valueItem.data.ptr = stored;
+    fiftyoneDegreesList list;
+    list.items = &valueItem;
+    list.count = 1;
+    list.capacity = 1;
+    const char *expected[] = {
+        "{\"Shape\":\"POINT(10 -0.5)\"}",
+        "{\"Shape\":{\"type\":\"Point\",\"coordinates\":[10,-0.5]}}" };
+    for (int geoJson = 0; geoJson < 2; geoJson++) {
+        char buffer[BUFFER_SIZE];
+        fiftyoneDegreesJson json {
+            { buffer, sizeof(buffer) },
+            stringsCollection,
+            &property,
+            &list,
+            exception,
+            FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
+            NULL,
+            geoJson == 1,
+        };
+        fiftyoneDegreesJsonDocumentStart(&json);
+        fiftyoneDegreesJsonPropertyStart(&json);
+        fiftyoneDegreesJsonPropertyValues(&json);
+        fiftyoneDegreesJsonPropertyEnd(&json);
+        fiftyoneDegreesJsonDocumentEnd(&json);
+        EXPECT_TRUE(EXCEPTION_OKAY);
+        EXPECT_STREQ(expected[geoJson], buffer);
+    }
+}
@@ -23,6 +23,7 @@
 #include "pch.h"
 #include "../overrides.h"
 #include "../string.h"
+#include "StringCollection.hpp"
 
 #ifdef _MSC_VER
 // This is a mock implementation of the method
@@ -104,3 +105,180 @@ TEST(OverrideValuesResetTests, Positive) {
 TEST(OverrideValuesResetTests, Negative) {
 	fiftyoneDegreesOverrideValuesReset(NULL);
 }
+
+#ifdef _MSC_VER
+// These are mock implementations of the methods
+#pragma warning (disable: 4100)
+#endif
+static uint32_t noEvidenceProperties(
+	void* state,
+	fiftyoneDegreesPropertyAvailable* property,
+	fiftyoneDegreesEvidenceProperties* evidenceProperties) {
+	return 0;
+}
+static bool allButIsMobile(void *state, uint32_t requiredPropertyIndex) {
+	return strcmp(FIFTYONE_DEGREES_STRING(
+		((fiftyoneDegreesPropertiesAvailable*)state)->items[
+			requiredPropertyIndex].name.data.ptr), "IsMobile") != 0;
+}
+#ifdef _MSC_VER
+#pragma warning (default: 4100)
+#endif
+
+// Returns the override value for the property name, or an empty string.
+static std::string getOverride(
+	fiftyoneDegreesPropertiesAvailable *available,
+	fiftyoneDegreesOverrideValueArray *values,
+	const char *name) {
+	fiftyoneDegreesCollectionItem item;
+	fiftyoneDegreesDataReset(&item.data);
+	int index = fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(
+		available,
+		name);
+	fiftyoneDegreesString *value = index >= 0 ?
+		fiftyoneDegreesOverrideValuesGetFirst(values, index, &item) : NULL;
+	return value != NULL ? std::string(&value->value) : std::string();
+}
+
+// Check that overridable properties are found in query and cookie evidence
+// with and without the prefix in any case, and that other keys are ignored.
+TEST(OverridesExtractTests, PrefixedAndUnprefixed) {
+	const char *names[] = {
+		"ScreenPixelsWidth", "ScreenPixelsHeight", "IsMobile", "ScreenInches" };
+	StringCollection strings(names, 4);
+	fiftyoneDegreesPropertiesAvailable *available =
+		fiftyoneDegreesPropertiesCreate(
+			NULL,
+			strings.getState(),
+			getStringValue,
+			noEvidenceProperties);
+	fiftyoneDegreesOverridePropertyArray *properties =
+		fiftyoneDegreesOverridePropertiesCreate(
+			available,
+			true,
+			available,
+			allButIsMobile);
+	ASSERT_NE(nullptr, properties);
+	EXPECT_EQ(3u, properties->count);
+	fiftyoneDegreesOverrideValueArray *values =
+		fiftyoneDegreesOverrideValuesCreate(properties->count);
+	fiftyoneDegreesEvidenceKeyValuePairArray *evidence =
+		fiftyoneDegreesEvidenceCreate(6);
+	fiftyoneDegreesEvidenceAddString(
+		evidence,
+		FIFTYONE_DEGREES_EVIDENCE_QUERY,
+		"51d_screenpixelswidth",
+		"800");
+	fiftyoneDegreesEvidenceAddString(
+		evidence,
+		FIFTYONE_DEGREES_EVIDENCE_COOKIE,
+		"ScreenPixelsHeight",
+		"600");
+	fiftyoneDegreesEvidenceAddString(
+		evidence,
+		FIFTYONE_DEGREES_EVIDENCE_QUERY,
+		"51D_IsMobile",
+		"True");
+	fiftyoneDegreesEvidenceAddString(
+		evidence,
+		FIFTYONE_DEGREES_EVIDENCE_QUERY,
+		"51D_ScreenPixels",
+		"1");
+	fiftyoneDegreesEvidenceAddString(
+		evidence,
+		FIFTYONE_DEGREES_EVIDENCE_HTTP_HEADER_STRING,
+		"51D_ScreenInches",
+		"5");
+
+	fiftyoneDegreesOverridesExtractFromEvidence(properties, values, evidence);
+	EXPECT_EQ(2u, values->count);
+	EXPECT_EQ("800", getOverride(available, values, "ScreenPixelsWidth"));
+	EXPECT_EQ("600", getOverride(available, values, "ScreenPixelsHeight"));
+	EXPECT_EQ("", getOverride(available, values, "IsMobile"));
+	EXPECT_EQ("", getOverride(available, values, "ScreenInches"));
+
+	fiftyoneDegreesEvidenceFree(evidence);
+	fiftyoneDegreesOverrideValuesFree(values);
+	fiftyoneDegreesOverridePropertiesFree(properties);
+	fiftyoneDegreesPropertiesFree(available);
+}
+
+// Check that overrides in the query string of a header block, whose keys and
+// values are not null terminated, are extracted using their lengths.
+TEST(OverridesExtractTests, HeaderBlockQuery) {
+	const char *names[] = { "ScreenPixelsWidth", "ScreenPixelsHeight" };
+	StringCollection strings(names, 2);
+	fiftyoneDegreesPropertiesAvailable *available =
+		fiftyoneDegreesPropertiesCreate(
+			NULL,
+			strings.getState(),
+			getStringValue,
+			noEvidenceProperties);
+	fiftyoneDegreesOverridePropertyArray *properties =
+		fiftyoneDegreesOverridePropertiesCreate(
+			available,
+			true,
+			available,
+			allButIsMobile);
+	ASSERT_NE(nullptr, properties);
+	fiftyoneDegreesOverrideValueArray *values =
+		fiftyoneDegreesOverrideValuesCreate(properties->count);
+	fiftyoneDegreesEvidenceKeyValuePairArray *evidence =
+		fiftyoneDegreesEvidenceCreate(4);
+	const char block[] =
+		"GET /?51D_ScreenPixelsWidth=1024&51D_ScreenPixelsHeight=768 "
+		"HTTP/1.1\r\nHost: example.com\r\n\r\n";
+	fiftyoneDegreesEvidenceAddHeaderBlock(
+		evidence,
+		block,
+		sizeof(block) - 1,
+		true);
+
+	fiftyoneDegreesOverridesExtractFromEvidence(properties, values, evidence);
+	EXPECT_EQ(2u, values->count);
+	EXPECT_EQ("1024", getOverride(available, values, "ScreenPixelsWidth"));
+	EXPECT_EQ("768", getOverride(available, values, "ScreenPixelsHeight"));
+
+	fiftyoneDegreesEvidenceFree(evidence);
+	fiftyoneDegreesOverrideValuesFree(values);
+	fiftyoneDegreesOverridePropertiesFree(properties);
+	fiftyoneDegreesPropertiesFree(available);
+}
+
+#ifdef _MSC_VER
+// This is a mock implementation of the method
+#pragma warning (disable: 4100)
+#endif
+static void collectProfileId(void *state, uint32_t profileId) {
+	((std::vector<uint32_t>*)state)->push_back(profileId);
+}
+#ifdef _MSC_VER
+#pragma warning (default: 4100)
+#endif
+
+// Check that profile ids in the query string of a header block, whose keys
+// and values are not null terminated, are read using their lengths. The
+// block is copied to memory of exactly its length so that reading past the
+// end is detected.
+TEST(OverridesExtractTests, HeaderBlockProfileIds) {
+	const char text[] =
+		"GET /?51D_ProfileIds=12-34&ProfileIds=56 HTTP/1.1\r\n"
+		"Host: example.com\r\n\r\n";
+	std::vector<char> block(text, text + sizeof(text) - 1);
+	fiftyoneDegreesEvidenceKeyValuePairArray *evidence =
+		fiftyoneDegreesEvidenceCreate(4);
+	fiftyoneDegreesEvidenceAddHeaderBlock(
+		evidence,
+		block.data(),
+		block.size(),
+		true);
+
+	std::vector<uint32_t> profileIds;
+	fiftyoneDegreesOverrideProfileIds(evidence, &profileIds, collectProfileId);
+	ASSERT_EQ(3u, profileIds.size());
+	EXPECT_EQ(12u, profileIds[0]);
+	EXPECT_EQ(34u, profileIds[1]);
+	EXPECT_EQ(56u, profileIds[2]);
+
+	fiftyoneDegreesEvidenceFree(evidence);
+}
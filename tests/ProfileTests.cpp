@@ -345,6 +345,85 @@ TEST_F(ProfileTests, ProfileIterateValues) {
     EXPECT_TRUE(EXCEPTION_OKAY);
 }
 
+bool iterateValueNameOffsets(void *state, fiftyoneDegreesCollectionItem *item) {
+    std::vector<uint32_t> *offsets = (std::vector<uint32_t> *)state;
+    offsets->push_back(
+        (uint32_t)((fiftyoneDegreesValue *)item->data.ptr)->nameOffset);
+    return true;
+}
+
+// Profiles in the other tests have fewer value indexes than are searched with
+// the binary search, so check profiles of many lengths against a scan of the
+// value indexes. The first value index of the property is before, inside and
+// after the value indexes of the profile, and the last value index of the
+// property is found in the same way. Each value's name offset is set to its
+// index so the values returned can be compared.
+TEST_F(ProfileTests, ProfileIterateValuesLongProfiles) {
+    constexpr uint32_t N_VALUES = 128;
+    constexpr uint32_t MAX_LENGTH = 40;
+    const uint32_t widths[] = { 0, 1, 2, 5, 17, 30, 64 };
+    EXCEPTION_CREATE
+    std::vector<fiftyoneDegreesValue> values;
+    for (uint32_t i = 0; i < N_VALUES; i++) {
+        values.push_back({ 0, (int32_t)i, 0, 0 });
+    }
+    FixedSizeCollection<fiftyoneDegreesValue> valuesHelper(values);
+    fiftyoneDegreesCollection *longValues = valuesHelper.getState()->collection;
+    for (uint32_t length = 0; length <= MAX_LENGTH; length++) {
+
+        // Value indexes 2, 5, 8... leave gaps either side of each index.
+        std::vector<byte> data(
+            sizeof(fiftyoneDegreesProfile) + length * sizeof(uint32_t));
+        fiftyoneDegreesProfile header = { 0, 1, length };
+        memcpy(data.data(), &header, sizeof(header));
+        std::vector<uint32_t> indexes;
+        for (uint32_t i = 0; i < length; i++) {
+            indexes.push_back(i * 3 + 2);
+        }
+        if (length > 0) {
+            memcpy(
+                data.data() + sizeof(header),
+                indexes.data(),
+                length * sizeof(uint32_t));
+        }
+        fiftyoneDegreesProfile *profile = (fiftyoneDegreesProfile*)data.data();
+
+        for (uint32_t first = 0; first <= length * 3 + 3; first++) {
+            for (uint32_t width : widths) {
+                uint32_t last = first + width;
+                if (width == 64) {
+                    last = UINT32_MAX;
+                }
+                fiftyoneDegreesProperty property = {
+                    0, 0, 0, 0, 0, 0, 0,
+                    FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+                    0, 0, 0, 0, 0, first, last, 0, 0 };
+                std::vector<uint32_t> expected;
+                for (uint32_t index : indexes) {
+                    if (index >= first && index <= last) {
+                        expected.push_back(index);
+                    }
+                }
+                std::vector<uint32_t> actual;
+                uint32_t count = fiftyoneDegreesProfileIterateValuesForProperty(
+                    longValues,
+                    profile,
+                    &property,
+                    &actual,
+                    iterateValueNameOffsets,
+                    exception);
+                EXPECT_TRUE(EXCEPTION_OKAY);
+                EXPECT_EQ(expected.size(), count) <<
+                    "length " << length << " first " << first <<
+                    " last " << last;
+                EXPECT_EQ(expected, actual) <<
+                    "length " << length << " first " << first <<
+                    " last " << last;
+            }
+        }
+    }
+}
+
 int ProfileTests::propertyIndexFromPropertyName(std::string &propertyName) {
     EXCEPTION_CREATE
     for (int i=0;i<N_PROPERTIES;++i) {
@@ -367,9 +446,9 @@ fiftyoneDegreesPropertyAvailableArray *ProfileTests::createAvailableProperties(s
         string &propertyName = propertyNames[j];
         int propIdx = propertyIndexFromPropertyName(propertyName);
         getStringValue(stringsCollectionHelper->getState(), N_PER_PROPERTY * propIdx, &item);
-        COLLECTION_RELEASE(item.collection, &item);
         propertiesAvailable->items[j].propertyIndex = propIdx;
         propertiesAvailable->items[j].name = item;
+        COLLECTION_RELEASE(item.collection, &item);
         propertiesAvailable->items[j].evidenceProperties = NULL;
         propertiesAvailable->items[j].delayExecution = false;
         propertiesAvailable->count++;
@@ -442,6 +521,50 @@ TEST_F(ProfileTests, profileIterateForPropertyAndValue) {
     EXPECT_EQ(profileIndexFromProfileId(profiles[0]->profileId), 4);
 }
 
+// Returns the ids of the profiles iterated.
+static std::vector<uint32_t> profileIds(
+    const std::vector<fiftyoneDegreesProfile *> &profiles) {
+    std::vector<uint32_t> ids;
+    for (fiftyoneDegreesProfile *profile : profiles) {
+        ids.push_back(profile->profileId);
+    }
+    return ids;
+}
+
+TEST_F(ProfileTests, profileIterateForPropertyAndValueWithIndex) {
+    // Available properties are found by name so must be in name order.
+    std::vector<std::string> propertyNames {"Brightness","Position","Texture","Volume","Weight"};
+    EXCEPTION_CREATE
+    fiftyoneDegreesPropertiesAvailable *availableProperties = createAvailableProperties(propertyNames);
+    fiftyoneDegreesIndicesPropertyValue *index = fiftyoneDegreesIndicesPropertyValueCreate(propertiesCollection, NULL, valuesCollection, stringsCollection, availableProperties, exception);
+    ASSERT_TRUE(EXCEPTION_OKAY);
+    ASSERT_NE((fiftyoneDegreesIndicesPropertyValue *) NULL, index);
+    ASSERT_EQ(3, fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(availableProperties, "Volume"));
+
+    // Every value of the available properties, and a property which is not
+    // available, must find the same profiles as searching the values.
+    propertyNames.push_back("Size");
+    for (const std::string &propertyName : propertyNames) {
+        const fiftyoneDegreesProperty *property = fiftyoneDegreesPropertyGetByName(propertiesCollection, stringsCollection, propertyName.c_str(), &item, exception);
+        COLLECTION_RELEASE(item.collection, &item);
+        for (uint32_t v=property->firstValueIndex;v<=property->lastValueIndex;v++) {
+            const char *valueName = strings[valueNameStringIndexFromValueIndex(v)];
+            std::vector<fiftyoneDegreesProfile *> expected, indexed, unindexed;
+            fiftyoneDegreesProfileIterateProfilesForPropertyAndValue(stringsCollection, propertiesCollection, valuesCollection, profilesCollection, profileOffsetsCollection, propertyName.c_str(), valueName, &expected, iterateProfiles, exception);
+            fiftyoneDegreesProfileIterateProfilesForPropertyAndValueWithIndex(stringsCollection, propertiesCollection, NULL, valuesCollection, profilesCollection, profileOffsetsCollection, fiftyoneDegreesProfileOffsetToPureOffset, availableProperties, index, propertyName.c_str(), valueName, &indexed, iterateProfiles, exception);
+            fiftyoneDegreesProfileIterateProfilesForPropertyAndValueWithIndex(stringsCollection, propertiesCollection, NULL, valuesCollection, profilesCollection, profileOffsetsCollection, fiftyoneDegreesProfileOffsetToPureOffset, availableProperties, NULL, propertyName.c_str(), valueName, &unindexed, iterateProfiles, exception);
+            EXPECT_FALSE(expected.empty()) << propertyName << "=" << valueName;
+            EXPECT_EQ(profileIds(expected), profileIds(indexed)) << propertyName << "=" << valueName;
+            EXPECT_EQ(profileIds(expected), profileIds(unindexed)) << propertyName << "=" << valueName;
+        }
+    }
+    EXPECT_EQ(0u, fiftyoneDegreesProfileIterateProfilesForPropertyAndValueWithIndex(stringsCollection, propertiesCollection, NULL, valuesCollection, profilesCollection, profileOffsetsCollection, fiftyoneDegreesProfileOffsetToPureOffset, availableProperties, index, "Weight", "NonExistantName", NULL, iterateProfiles, exception));
+    EXPECT_TRUE(EXCEPTION_OKAY);
+
+    fiftyoneDegreesIndicesPropertyValueFree(index);
+    fiftyoneDegreesFree(availableProperties);
+}
+
 void ProfileTests::indicesLookup(std::vector<std::string> &propertyNames) {
     EXCEPTION_CREATE
     fiftyoneDegreesPropertiesAvailable *availableProperties = createAvailableProperties(propertyNames);
@@ -478,6 +601,149 @@ TEST_F(ProfileTests, indicesLookup) {
     //indicesLookup(propertyNamesRepetitive);
 }
 
+TEST_F(ProfileTests, indicesPropertyValueLookup) {
+    std::vector<std::string> propertyNames {"Volume","Position","Texture","Weight","Brightness"};
+    EXCEPTION_CREATE
+    fiftyoneDegreesPropertiesAvailable *availableProperties = createAvailableProperties(propertyNames);
+    fiftyoneDegreesIndicesPropertyValue *index = fiftyoneDegreesIndicesPropertyValueCreate(propertiesCollection, NULL, valuesCollection, stringsCollection, availableProperties, exception);
+    ASSERT_TRUE(EXCEPTION_OKAY);
+    ASSERT_NE((fiftyoneDegreesIndicesPropertyValue *) NULL, index);
+    EXPECT_EQ((uint32_t)(availableProperties->count * (N_PER_PROPERTY - 1)), index->filled);
+
+    for (uint32_t j=0;j<availableProperties->count;j++) {
+        fiftyoneDegreesProperty *property = fiftyoneDegreesPropertyGet(propertiesCollection, availableProperties->items[j].propertyIndex, &item, exception);
+        COLLECTION_RELEASE(item.collection, &item);
+        for (uint32_t v=property->firstValueIndex;v<=property->lastValueIndex;v++) {
+            const char *valueName = strings[valueNameStringIndexFromValueIndex(v)];
+            //the index must agree with the binary search for every value
+            EXPECT_EQ((long)v, fiftyoneDegreesIndicesPropertyValueLookup(index, valuesCollection, stringsCollection, j, valueName, exception));
+            EXPECT_EQ(fiftyoneDegreesValueGetIndexByName(valuesCollection, stringsCollection, property, valueName, exception),
+                fiftyoneDegreesIndicesPropertyValueLookup(index, valuesCollection, stringsCollection, j, valueName, exception));
+        }
+        EXPECT_EQ(-1, fiftyoneDegreesIndicesPropertyValueLookup(index, valuesCollection, stringsCollection, j, "NonExistantName", exception));
+        //value names are case sensitive
+        EXPECT_EQ(-1, fiftyoneDegreesIndicesPropertyValueLookup(index, valuesCollection, stringsCollection, j, "moderate", exception));
+    }
+    EXPECT_TRUE(EXCEPTION_OKAY);
+
+    fiftyoneDegreesIndicesPropertyValueFree(index);
+    fiftyoneDegreesFree(availableProperties);
+}
+
+// Appends the bytes of the value to the stored values returning its offset.
+template<typename T>
+static uint32_t appendStored(std::vector<byte> &stored, T value) {
+    uint32_t offset = (uint32_t)stored.size();
+    stored.resize(stored.size() + sizeof(T));
+    memcpy(stored.data() + offset, &value, sizeof(T));
+    return offset;
+}
+
+// Appends a well known binary 2D point with its length returning its offset.
+static uint32_t appendPoint(std::vector<byte> &stored, double x, double y) {
+    uint32_t offset = appendStored(stored, (int16_t)21);
+    appendStored(stored, (byte)1); // little endian
+    appendStored(stored, (uint32_t)1); // point
+    appendStored(stored, x);
+    appendStored(stored, y);
+    return offset;
+}
+
+/**
+ * Check that the property value index finds integer values through the hash
+ * table, and float and well known binary values, which aren't indexed,
+ * through the binary search when a property types collection is provided.
+ */
+TEST_F(ProfileTests, indicesPropertyValueLookupTyped) {
+    EXCEPTION_CREATE
+    std::vector<byte> stored;
+    std::vector<uint32_t> offsets = {
+        appendStored(stored, (int32_t)-5),
+        appendStored(stored, (int32_t)3),
+        appendStored(stored, (int32_t)42),
+        appendStored(stored, 0.5f),
+        appendStored(stored, 1.25f),
+        appendStored(stored, 2.75f),
+        appendPoint(stored, 1, 2),
+        appendPoint(stored, 3, 4) };
+    VariableSizeCollection<byte> storedHelper(stored);
+    fiftyoneDegreesCollection *storedCollection =
+        storedHelper.getState()->collection;
+
+    std::vector<fiftyoneDegreesValue> values;
+    for (size_t i = 0; i < offsets.size(); i++) {
+        int16_t propertyIndex = i < 3 ? 0 : i < 6 ? 1 : 2;
+        values.push_back({
+            propertyIndex,
+            (int32_t)offsets[i],
+            (int32_t)offsets[i],
+            (int32_t)offsets[i] });
+    }
+    FixedSizeCollection<fiftyoneDegreesValue> valuesHelper(values);
+
+    const fiftyoneDegreesPropertyValueType types[] = {
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB };
+    const uint32_t firstValues[] = { 0, 3, 6 };
+    const uint32_t lastValues[] = { 2, 5, 7 };
+    std::vector<fiftyoneDegreesProperty> properties;
+    std::vector<fiftyoneDegreesPropertyTypeRecord> propertyTypes;
+    for (byte i = 0; i < 3; i++) {
+        properties.push_back({
+            0, i, 1, 0, 1, 0, 1, (byte)types[i], firstValues[i],
+            0, 0, 0, 0, firstValues[i], lastValues[i], 0, 0 });
+        propertyTypes.push_back({ 0, (byte)types[i] });
+    }
+    FixedSizeCollection<fiftyoneDegreesProperty> propertiesHelper(properties);
+    FixedSizeCollection<fiftyoneDegreesPropertyTypeRecord> propertyTypesHelper(
+        propertyTypes);
+
+    fiftyoneDegreesPropertyAvailableArray * FIFTYONE_DEGREES_ARRAY_CREATE(
+        fiftyoneDegreesPropertyAvailable, available, 3);
+    for (uint32_t i = 0; i < 3; i++) {
+        fiftyoneDegreesDataReset(&available->items[i].name.data);
+        available->items[i].propertyIndex = i;
+        available->items[i].evidenceProperties = NULL;
+        available->items[i].delayExecution = false;
+        available->count++;
+    }
+
+    fiftyoneDegreesIndicesPropertyValue *index =
+        fiftyoneDegreesIndicesPropertyValueCreate(
+            propertiesHelper.getState()->collection,
+            propertyTypesHelper.getState()->collection,
+            valuesHelper.getState()->collection,
+            storedCollection,
+            available,
+            exception);
+    ASSERT_TRUE(EXCEPTION_OKAY);
+    ASSERT_NE((fiftyoneDegreesIndicesPropertyValue *) NULL, index);
+    EXPECT_NE(0u, index->masks[0]);
+    EXPECT_EQ(0u, index->masks[1]);
+    EXPECT_EQ(0u, index->masks[2]);
+    EXPECT_EQ(3u, index->filled);
+
+    fiftyoneDegreesCollection *valuesCollection =
+        valuesHelper.getState()->collection;
+    const char *names[] = {
+        "-5", "3", "42", "0.5", "1.25", "2.75", "POINT(1 2)", "POINT(3 4)" };
+    for (uint32_t v = 0; v < offsets.size(); v++) {
+        uint32_t property = v < 3 ? 0 : v < 6 ? 1 : 2;
+        EXPECT_EQ((long)v, fiftyoneDegreesIndicesPropertyValueLookup(
+            index, valuesCollection, storedCollection, property, names[v],
+            exception)) << names[v];
+    }
+    EXPECT_EQ(-1, fiftyoneDegreesIndicesPropertyValueLookup(
+        index, valuesCollection, storedCollection, 0, "7", exception));
+    EXPECT_EQ(-1, fiftyoneDegreesIndicesPropertyValueLookup(
+        index, valuesCollection, storedCollection, 1, "7", exception));
+    EXPECT_TRUE(EXCEPTION_OKAY);
+
+    fiftyoneDegreesIndicesPropertyValueFree(index);
+    fiftyoneDegreesFree(available);
+}
+
 bool collectValues(void *state, fiftyoneDegreesCollectionItem *item) {
     std::vector<fiftyoneDegreesValue *> *values = (std::vector<fiftyoneDegreesValue *> *)state;
     values->push_back((fiftyoneDegreesValue *)item->data.ptr);
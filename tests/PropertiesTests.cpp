@@ -478,4 +478,135 @@ TEST_F(Properties, EvidenceProperties_IsSetHeaderRequired) {
 	// required properties
 	isIncluded = fiftyoneDegreesPropertiesIsSetHeaderAvailable(properties);
 	ASSERT_FALSE(isIncluded);
-}
\ No newline at end of file
+}
+
+/**
+ * Check that with many properties every name, in any case, is found through
+ * the name hash table at the same index as a search of the sorted names, and
+ * that names which are not required are not found.
+ */
+TEST_F(Properties, ManyPropertiesHashLookup) {
+	std::vector<std::string> names;
+	for (int i = 0; i < 300; i++) {
+		names.push_back("Property" + std::to_string(i * 7919 % 1000));
+	}
+	std::vector<const char*> values;
+	for (const std::string &name : names) {
+		values.push_back(name.c_str());
+	}
+	StringCollection many(values.data(), (int)values.size());
+	properties = fiftyoneDegreesPropertiesCreate(
+		NULL,
+		many.getState(),
+		getStringValue,
+		getEvidenceProperties);
+	ASSERT_NE(nullptr, properties);
+	ASSERT_NE(nullptr, properties->nameSlots);
+	for (uint32_t i = 0; i < properties->count; i++) {
+		std::string name = FIFTYONE_DEGREES_STRING(
+			fiftyoneDegreesPropertiesGetNameFromRequiredIndex(
+				properties,
+				(int)i));
+		EXPECT_EQ((int)i,
+			fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(
+				properties,
+				name.c_str()));
+		for (char &c : name) {
+			c = (char)toupper(c);
+		}
+		EXPECT_EQ((int)i,
+			fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(
+				properties,
+				name.c_str()));
+	}
+	EXPECT_EQ(300u, properties->count);
+	EXPECT_EQ(-1, fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(
+		properties,
+		"Property1001"));
+	EXPECT_EQ(-1, fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(
+		properties,
+		""));
+	fiftyoneDegreesPropertiesFree(properties);
+	properties = nullptr;
+}
+
+/**
+ * Check that the property index of every required property maps back to its
+ * required property index, and that properties which are not required, or are
+ * beyond the end of the table, are not found.
+ */
+TEST_F(Properties, RequiredIndexFromPropertyIndex) {
+	const char* tests[]{ "Green", "Black", "Red" };
+	fiftyoneDegreesPropertiesRequired required;
+	required.string = NULL;
+	required.array = tests;
+	required.count = sizeof(tests) / sizeof(const char*);
+	required.existing = NULL;
+	CreateProperties(&required);
+	ASSERT_NE(nullptr, properties->requiredIndexes);
+	for (uint32_t i = 0; i < properties->count; i++) {
+		EXPECT_EQ((int)i,
+			fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex(
+				properties,
+				properties->items[i].propertyIndex));
+	}
+	int found = 0;
+	for (int i = 0; i < count; i++) {
+		if (fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex(
+			properties,
+			(uint32_t)i) >= 0) {
+			found++;
+		}
+	}
+	EXPECT_EQ(3, found);
+	EXPECT_EQ(-1,
+		fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex(
+			properties,
+			1000));
+}
+
+/**
+ * Check that an array built by hand, rather than by
+ * fiftyoneDegreesPropertiesCreate, has no name or required index tables and
+ * that the lookups fall back to searching the items.
+ */
+TEST_F(Properties, HandBuiltArraySearched) {
+	// Indexes of "Black", "Green" and "Red" which are in name order.
+	const uint32_t indexes[] = { 5, 2, 0 };
+	fiftyoneDegreesPropertiesAvailable * FIFTYONE_DEGREES_ARRAY_CREATE(
+		fiftyoneDegreesPropertyAvailable, available, 3);
+	ASSERT_NE(nullptr, available);
+	EXPECT_EQ(nullptr, available->nameSlots);
+	EXPECT_EQ(nullptr, available->nameDisplacements);
+	EXPECT_EQ(nullptr, available->requiredIndexes);
+	EXPECT_EQ(0u, available->requiredIndexesCount);
+	for (uint32_t i = 0; i < 3; i++) {
+		fiftyoneDegreesDataReset(&available->items[i].name.data);
+		getStringValue(
+			strings->getState(),
+			indexes[i],
+			&available->items[i].name);
+		available->items[i].propertyIndex = indexes[i];
+		available->items[i].evidenceProperties = NULL;
+		available->items[i].delayExecution = false;
+		available->count++;
+	}
+	for (uint32_t i = 0; i < 3; i++) {
+		EXPECT_EQ((int)i,
+			fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(
+				available,
+				testValues[indexes[i]]));
+		EXPECT_EQ((int)i,
+			fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex(
+				available,
+				indexes[i]));
+	}
+	EXPECT_EQ(-1, fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromName(
+		available,
+		"Blue"));
+	EXPECT_EQ(-1,
+		fiftyoneDegreesPropertiesGetRequiredPropertyIndexFromPropertyIndex(
+			available,
+			3));
+	fiftyoneDegreesFree(available);
+}
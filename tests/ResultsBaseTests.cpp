@@ -0,0 +1,266 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "pch.h"
+#include <cmath>
+#include "Base.hpp"
+#include "StoredValues.hpp"
+#include "../ResultsBase.hpp"
+#include "../storedBinaryValue.h"
+#include "../columns.h"
+#include "../dataset.h"
+
+using std::vector;
+using namespace FiftyoneDegrees::Common;
+
+#ifdef _MSC_VER
+// The mock results don't use all the parameters
+#pragma warning (disable: 4100)
+#endif
+/**
+ * Results which hold a fixed set of stored values for each required property
+ * index, and optionally provide them to the base class directly.
+ */
+class StoredResults : public ResultsBase {
+public:
+	StoredResults(
+		fiftyoneDegreesResultsBase *results,
+		vector<fiftyoneDegreesPropertyValueType> types,
+		vector<vector<vector<byte>>> values,
+		bool provideStored)
+		: ResultsBase(results, nullptr),
+		types(types),
+		values(values),
+		provideStored(provideStored) {
+		items.resize(this->values.size());
+		lists.resize(this->values.size());
+		for (size_t i = 0; i < this->values.size(); i++) {
+			items[i].resize(this->values[i].size());
+			for (size_t j = 0; j < this->values[i].size(); j++) {
+				fiftyoneDegreesDataReset(&items[i][j].data);
+				items[i][j].data.ptr = this->values[i][j].data();
+				items[i][j].collection = nullptr;
+			}
+			lists[i].items = items[i].data();
+			lists[i].count = (uint32_t)items[i].size();
+			lists[i].capacity = lists[i].count;
+		}
+	}
+
+protected:
+	void getValuesInternal(
+		int requiredPropertyIndex,
+		vector<string> &result) override {
+		for (const fiftyoneDegreesCollectionItem &item :
+			items[requiredPropertyIndex]) {
+			const fiftyoneDegreesStoredBinaryValue *value =
+				(const fiftyoneDegreesStoredBinaryValue*)item.data.ptr;
+			switch (types[requiredPropertyIndex]) {
+			case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER:
+				result.push_back(std::to_string(value->intValue));
+				break;
+			case FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT:
+				result.push_back(std::to_string(
+					FIFTYONE_DEGREES_FLOAT_TO_NATIVE(value->floatValue)));
+				break;
+			default:
+				result.push_back(&value->stringValue.value);
+				break;
+			}
+		}
+	}
+
+	bool hasValuesInternal(int requiredPropertyIndex) override {
+		return requiredPropertyIndex >= 0 &&
+			requiredPropertyIndex < (int)values.size();
+	}
+
+	const char* getNoValueMessageInternal(
+		fiftyoneDegreesResultsNoValueReason reason) override {
+		return reason == FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_UNKNOWN ?
+			"Unknown" : "Invalid property";
+	}
+
+	fiftyoneDegreesResultsNoValueReason getNoValueReasonInternal(
+		int requiredPropertyIndex) override {
+		return FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_INVALID_PROPERTY;
+	}
+
+	const fiftyoneDegreesList* getStoredValuesInternal(
+		int requiredPropertyIndex,
+		fiftyoneDegreesPropertyValueType *storedValueType) override {
+		if (provideStored == false) {
+			return nullptr;
+		}
+		*storedValueType = types[requiredPropertyIndex];
+		return &lists[requiredPropertyIndex];
+	}
+
+private:
+	vector<fiftyoneDegreesPropertyValueType> types;
+	vector<vector<vector<byte>>> values;
+	vector<vector<fiftyoneDegreesCollectionItem>> items;
+	vector<fiftyoneDegreesList> lists;
+	bool provideStored;
+};
+#ifdef _MSC_VER
+#pragma warning (default: 4100)
+#endif
+
+/**
+ * Results base test class used to test the typed getters and value views
+ * with and without the stored values being provided.
+ */
+class ResultsBaseTests : public Base {
+protected:
+	// Required property indexes of the test values.
+	static const int NAME = 0;
+	static const int TAGS = 1;
+	static const int COUNT = 2;
+	static const int IS_MOBILE = 3;
+	static const int RATIO = 4;
+
+	vector<byte> dataSet;
+	fiftyoneDegreesPropertiesAvailable available;
+	fiftyoneDegreesResultsBase results;
+
+	void SetUp() {
+		Base::SetUp();
+		memset(&available, 0, sizeof(available));
+		available.count = RATIO + 1;
+		dataSet.resize(sizeof(fiftyoneDegreesDataSetBase));
+		((fiftyoneDegreesDataSetBase*)dataSet.data())->available = &available;
+		results.dataSet = dataSet.data();
+	}
+
+	void TearDown() {
+		Base::TearDown();
+	}
+
+	StoredResults* createResults(bool provideStored) {
+		return new StoredResults(
+			&results,
+			{
+				FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+				FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+				FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+				FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+				FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT
+			},
+			{
+				{ storedString("Phone") },
+				{ storedString("a"), storedString("b") },
+				{ storedInteger(-42) },
+				{ storedString("True") },
+				{ storedFloat(0.5f) }
+			},
+			provideStored);
+	}
+};
+
+/**
+ * Check that the typed getters return the same values whether they are read
+ * from the stored values directly or from the text values.
+ */
+TEST_F(ResultsBaseTests, TypedGettersMatchText) {
+	for (bool provideStored : { false, true }) {
+		StoredResults *stored = createResults(provideStored);
+		EXPECT_EQ("Phone", *stored->getValueAsString(NAME));
+		EXPECT_EQ("a|b", *stored->getValueAsString(TAGS));
+		EXPECT_EQ(-42, *stored->getValueAsInteger(COUNT));
+		EXPECT_EQ(-42.0, *stored->getValueAsDouble(COUNT));
+		EXPECT_TRUE(*stored->getValueAsBool(IS_MOBILE));
+		EXPECT_FALSE(*stored->getValueAsBool(NAME));
+		EXPECT_FALSE(*stored->getValueAsBool(COUNT));
+		EXPECT_FALSE(*stored->getValueAsBool(RATIO));
+		EXPECT_EQ(0.5, *stored->getValueAsDouble(RATIO));
+		EXPECT_EQ(
+			FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_TOO_MANY_VALUES,
+			stored->getValueAsInteger(TAGS).getNoValueReason());
+		EXPECT_EQ(
+			FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_INVALID_PROPERTY,
+			stored->getValueAsDouble(99).getNoValueReason());
+		delete stored;
+	}
+}
+
+/**
+ * Check that views point to the stored strings, and are not available for
+ * values which are not stored as strings or not provided by the results.
+ */
+TEST_F(ResultsBaseTests, Views) {
+	std::string_view views[1];
+	StoredResults *stored = createResults(true);
+	Value<std::string_view> name = stored->getValueAsStringView(NAME);
+	ASSERT_TRUE(name.hasValue());
+	EXPECT_EQ("Phone", *name);
+	EXPECT_EQ(
+		FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_TOO_MANY_VALUES,
+		stored->getValueAsStringView(TAGS).getNoValueReason());
+	EXPECT_EQ(
+		FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_UNKNOWN,
+		stored->getValueAsStringView(COUNT).getNoValueReason());
+	EXPECT_EQ(2u, stored->getValueViews(TAGS, views, 1));
+	EXPECT_EQ("a", views[0]);
+	EXPECT_EQ(0u, stored->getValueViews(COUNT, views, 1));
+	delete stored;
+
+	stored = createResults(false);
+	EXPECT_FALSE(stored->getValueAsStringView(NAME).hasValue());
+	EXPECT_EQ(0u, stored->getValueViews(NAME, views, 1));
+	delete stored;
+}
+
+/**
+ * Check that all the values of each results are added as a row of the
+ * columns in one call, with numbers for the numeric values, whether or not
+ * the stored values are provided.
+ */
+TEST_F(ResultsBaseTests, AddToColumns) {
+	size_t length;
+	const char *text;
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	fiftyoneDegreesColumns columns;
+	fiftyoneDegreesColumnsInit(&columns, RATIO + 1, 1, exception);
+	ASSERT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+	for (bool provideStored : { false, true }) {
+		StoredResults *stored = createResults(provideStored);
+		stored->addToColumns(&columns);
+		delete stored;
+	}
+	ASSERT_EQ(2u, columns.rowCount);
+	for (uint32_t row = 0; row < columns.rowCount; row++) {
+		text = fiftyoneDegreesColumnsGetText(&columns, row, NAME, &length);
+		EXPECT_EQ("Phone", std::string(text, length));
+		text = fiftyoneDegreesColumnsGetText(&columns, row, TAGS, &length);
+		EXPECT_EQ("a|b", std::string(text, length));
+		text = fiftyoneDegreesColumnsGetText(&columns, row, COUNT, &length);
+		EXPECT_EQ("-42", std::string(text, length));
+		EXPECT_TRUE(std::isnan(
+			fiftyoneDegreesColumnsGetNumber(&columns, row, NAME)));
+		EXPECT_TRUE(std::isnan(
+			fiftyoneDegreesColumnsGetNumber(&columns, row, TAGS)));
+		EXPECT_EQ(-42.0, fiftyoneDegreesColumnsGetNumber(&columns, row, COUNT));
+		EXPECT_EQ(0.5, fiftyoneDegreesColumnsGetNumber(&columns, row, RATIO));
+	}
+	fiftyoneDegreesColumnsFree(&columns);
+}
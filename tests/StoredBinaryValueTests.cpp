@@ -25,6 +25,7 @@
 #include "Base.hpp"
 #include "TestUtils_Pointers.hpp"
 #include "../collectionKeyTypes.h"
+#include <random>
 
 static void releaseFilePool(FilePool * const ptr) {
     if (ptr) {
@@ -1951,3 +1952,250 @@ TEST_F(StoredBinaryValues, StoredBinaryValue_ToBool_Default_54_2) {
         true);
     EXPECT_EQ(true, result);
 }
+
+// Compares the value with the target by forming the text of the value in a
+// builder sized in the same way as a value search.
+static int compareAsText(
+    const StoredBinaryValue * const value,
+    const PropertyValueType valueType,
+    const std::string &target) {
+    EXCEPTION_CREATE;
+    std::vector<char> buffer(target.length() + 3);
+    StringBuilder builder = { buffer.data(), buffer.size() };
+    StringBuilderInit(&builder);
+    StringBuilderAddStringValue(
+        &builder,
+        value,
+        valueType,
+        builder.length < MAX_DOUBLE_DECIMAL_PLACES ?
+            (uint8_t)builder.length : MAX_DOUBLE_DECIMAL_PLACES,
+        exception);
+    StringBuilderComplete(&builder);
+    return strcmp(builder.ptr, target.c_str());
+}
+
+// Returns the sign of the comparison of the value with the target using the
+// numeric comparison.
+static int compareWithString(
+    const StoredBinaryValue * const value,
+    const PropertyValueType valueType,
+    const std::string &target) {
+    EXCEPTION_CREATE;
+    std::vector<char> buffer(target.length() + 3);
+    StringBuilder builder = { buffer.data(), buffer.size() };
+    StringBuilderInit(&builder);
+    const int result = StoredBinaryValueCompareWithString(
+        value,
+        valueType,
+        target.c_str(),
+        &builder,
+        exception);
+    EXPECT_TRUE(EXCEPTION_OKAY);
+    return result;
+}
+
+// Checks that comparing each value with targets formed from the text of
+// nearby values gives the same result as comparing the text.
+static void checkCompareMatchesText(
+    const std::vector<StoredBinaryValue> &values,
+    const PropertyValueType valueType) {
+    const char *suffixes[] = { "", "0", "5", ".", ".5", "a", " ", "-" };
+    for (size_t i = 0; i < values.size(); i++) {
+        std::vector<std::string> targets = {
+            "", "-", "0", "-0", "007", "abc", "1e3", "99999999999999999999" };
+        for (size_t j = i > 2 ? i - 2 : 0; j < values.size() && j <= i + 2; j++) {
+            EXCEPTION_CREATE;
+            char buffer[64];
+            StringBuilder builder = { buffer, sizeof(buffer) };
+            StringBuilderInit(&builder);
+            StringBuilderAddStringValue(
+                &builder, &values[j], valueType, 15, exception);
+            StringBuilderComplete(&builder);
+            const std::string text = buffer;
+            for (const char *suffix : suffixes) {
+                targets.push_back(text + suffix);
+                if (text.length() > 1) {
+                    targets.push_back(text.substr(0, text.length() - 1) + suffix);
+                    targets.push_back(text.substr(0, 1) + suffix);
+                }
+            }
+        }
+        for (const std::string &target : targets) {
+            const int expected = compareAsText(&values[i], valueType, target);
+            const int actual = compareWithString(&values[i], valueType, target);
+            EXPECT_EQ(expected < 0, actual < 0) << target;
+            EXPECT_EQ(expected == 0, actual == 0) << target;
+        }
+    }
+}
+
+TEST_F(StoredBinaryValues, StoredBinaryValue_CompareWithString_Integer) {
+    std::mt19937 random(42);
+    std::vector<StoredBinaryValue> values;
+    const int32_t fixed[] = {
+        0, 1, -1, 9, 10, -10, 99, 100, 101, 1000, INT32_MAX, INT32_MIN };
+    for (int32_t x : fixed) {
+        StoredBinaryValue value;
+        value.intValue = x;
+        values.push_back(value);
+    }
+    for (int i = 0; i < 500; i++) {
+        StoredBinaryValue value;
+        value.intValue = (int32_t)random() >> (random() % 31);
+        values.push_back(value);
+    }
+    checkCompareMatchesText(values, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER);
+}
+
+TEST_F(StoredBinaryValues, StoredBinaryValue_CompareWithString_Byte) {
+    std::vector<StoredBinaryValue> values;
+    for (int i = 0; i < 256; i++) {
+        StoredBinaryValue value;
+        value.byteValue = (byte)i;
+        values.push_back(value);
+    }
+    checkCompareMatchesText(values, FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_BYTE);
+}
+
+TEST_F(StoredBinaryValues, StoredBinaryValue_CompareWithString_Float) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> distribution(-2000.0f, 2000.0f);
+    std::vector<StoredBinaryValue> values;
+    const float fixed[] = {
+        0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 5.8f, 9.99999f, 10.0f, 1e-7f, 
+        0.9999999f, 123456.7f };
+    for (float x : fixed) {
+        StoredBinaryValue value;
+        value.floatValue = FIFTYONE_DEGREES_NATIVE_TO_FLOAT(x);
+        values.push_back(value);
+    }
+    for (int i = 0; i < 500; i++) {
+        StoredBinaryValue value;
+        float x = distribution(random);
+        if (i % 3 == 0) {
+            x = (float)(int)x;
+        }
+        value.floatValue = FIFTYONE_DEGREES_NATIVE_TO_FLOAT(x);
+        values.push_back(value);
+    }
+    checkCompareMatchesText(
+        values, 
+        FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT);
+}
+
+/**
+ * Check values between -1 and 0, which are written as "-0." followed by
+ * digits, compare with targets the same way as their text.
+ */
+TEST_F(StoredBinaryValues, StoredBinaryValue_CompareWithString_NegativeFraction) {
+    std::vector<StoredBinaryValue> floats;
+    for (int i = 1; i < 1000; i += 7) {
+        StoredBinaryValue value;
+        value.floatValue = FIFTYONE_DEGREES_NATIVE_TO_FLOAT(-i / 1000.0f);
+        floats.push_back(value);
+    }
+    checkCompareMatchesText(
+        floats,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT);
+    std::vector<StoredBinaryValue> shorts;
+    for (int i = -1; i > -182; i -= 3) {
+        StoredBinaryValue value;
+        value.shortValue = (int16_t)i;
+        shorts.push_back(value);
+    }
+    checkCompareMatchesText(shorts, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_AZIMUTH);
+    checkCompareMatchesText(
+        shorts,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DECLINATION);
+}
+
+TEST_F(StoredBinaryValues, StoredBinaryValue_CompareWithString_Azimuth) {
+    std::vector<StoredBinaryValue> values;
+    for (int i = INT16_MIN; i <= INT16_MAX; i += 97) {
+        StoredBinaryValue value;
+        value.shortValue = (int16_t)i;
+        values.push_back(value);
+    }
+    checkCompareMatchesText(values, FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_AZIMUTH);
+    checkCompareMatchesText(
+        values, 
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DECLINATION);
+}
+
+static void checkWkbtotCache(
+    const fiftyoneDegreesCollection * const strings,
+    const Offset offset) {
+    EXCEPTION_CREATE;
+    fiftyoneDegreesWkbtotCache * const cache = WkbtotCacheCreate(
+        strings,
+        4,
+        1,
+        exception);
+    EXCEPTION_THROW;
+    ASSERT_NE(nullptr, cache);
+
+    // Convert the WKB directly to find the expected text.
+    char expected[REASONABLE_WKT_STRING_LENGTH];
+    {
+        ItemBox item;
+        const StoredBinaryValue * const value = StoredBinaryValueGet(
+            strings,
+            offset,
+            FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
+            *item,
+            exception);
+        EXCEPTION_THROW;
+        ConvertWkbToWkt(
+            &value->byteArrayValue.firstByte,
+            FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+            expected,
+            sizeof(expected),
+            3,
+            exception);
+        EXCEPTION_THROW;
+    }
+    EXPECT_STREQ("POINT(17.25 892.094)", expected);
+
+    // The second request for the same key is served from the cache, and a
+    // different precision is a different entry.
+    for (int i = 0; i < 2; i++) {
+        char buffer[REASONABLE_WKT_STRING_LENGTH];
+        StringBuilder builder = { buffer, sizeof(buffer) };
+        StringBuilderInit(&builder);
+        WkbtotCacheWriteToStringBuilder(
+            cache,
+            offset,
+            FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+            3,
+            &builder,
+            exception);
+        StringBuilderComplete(&builder);
+        EXCEPTION_THROW;
+        EXPECT_STREQ(expected, buffer);
+    }
+    EXPECT_EQ(1, cache->cache->misses);
+    EXPECT_EQ(1, cache->cache->hits);
+
+    fiftyoneDegreesCacheNode * const node = WkbtotCacheGet(
+        cache,
+        offset,
+        FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+        5,
+        exception);
+    EXCEPTION_THROW;
+    ASSERT_NE(nullptr, node);
+    EXPECT_STREQ("POINT(17.25 892.09375)", (const char *)node->data.ptr);
+    EXPECT_EQ(strlen((const char *)node->data.ptr) + 1, node->data.used);
+    CacheRelease(node);
+    EXPECT_EQ(2, cache->cache->misses);
+
+    WkbtotCacheFree(cache);
+}
+
+TEST_F(StoredBinaryValues, StoredBinaryValue_WkbtotCache_FromMemory) {
+    checkWkbtotCache(collection.memory.get(), offsets.wkb);
+}
+
+TEST_F(StoredBinaryValues, StoredBinaryValue_WkbtotCache_FromFileCache) {
+    checkWkbtotCache(collection.fileCache.ptr.get(), offsets.wkb);
+}
@@ -0,0 +1,46 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2023 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "pch.h"
+#include "StoredValues.hpp"
+#include <cstring>
+
+std::vector<byte> storedString(const char *value) {
+	size_t length = strlen(value) + 1;
+	std::vector<byte> stored(sizeof(int16_t) + length);
+	int16_t size = (int16_t)length;
+	memcpy(stored.data(), &size, sizeof(size));
+	memcpy(stored.data() + sizeof(int16_t), value, length);
+	return stored;
+}
+
+std::vector<byte> storedInteger(int32_t value) {
+	std::vector<byte> stored(sizeof(int32_t));
+	memcpy(stored.data(), &value, sizeof(value));
+	return stored;
+}
+
+std::vector<byte> storedFloat(float value) {
+	std::vector<byte> stored(sizeof(float));
+	memcpy(stored.data(), &value, sizeof(value));
+	return stored;
+}
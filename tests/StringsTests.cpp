@@ -24,6 +24,9 @@
 #include "../string.h"
 #include "Base.hpp"
 #include "limits.h"
+#include <clocale>
+#include <cmath>
+#include <string>
 
 constexpr size_t bufferSize = 512;
 
@@ -170,6 +173,22 @@ TEST_F(Strings, StringBuilder_AddMaxInt) {
     ASSERT_FALSE(builder->full);
 }
 
+TEST_F(Strings, StringBuilder_AddIntegerMatchesSnprintf) {
+    const int64_t values[] = {
+        0, 1, -1, 9, 10, -10, 99, 100, 999, 1000, 65535, -32768,
+        INT32_MAX, INT32_MIN, 9999999999LL, -10000000000LL,
+        INT64_MAX, INT64_MIN };
+    char buf[bufferSize];
+    for (int64_t x : values) {
+        fiftyoneDegreesStringBuilderInit(builder);
+        fiftyoneDegreesStringBuilderAddInteger(builder, x);
+        fiftyoneDegreesStringBuilderComplete(builder);
+        snprintf(buf, bufferSize, "%lld", (long long)x);
+        EXPECT_STREQ(buf, builder->ptr);
+        EXPECT_EQ(strlen(buf) + 1, builder->added);
+    }
+}
+
 TEST_F(Strings, StringBuilder_NullBuffer) {
     StringBuilder *prev = builder;
     StringBuilder local = {nullptr, 0};
@@ -200,6 +219,173 @@ TEST_F(Strings, StringBuilder_OneChar) {
     builder = prev;
 }
 
+// Allocator which counts the allocations made by a growable builder.
+typedef struct counting_allocator_state_t {
+    int allocations;
+    int releases;
+} countingAllocatorState;
+
+static void* countingAllocate(void *state, size_t size) {
+    ((countingAllocatorState*)state)->allocations++;
+    return fiftyoneDegreesMalloc(size);
+}
+
+static void countingRelease(void *state, void *ptr) {
+    ((countingAllocatorState*)state)->releases++;
+    fiftyoneDegreesFree(ptr);
+}
+
+TEST_F(Strings, StringBuilder_Growable) {
+    countingAllocatorState counts = { 0, 0 };
+    fiftyoneDegreesStringBuilderAllocator allocator = {
+        countingAllocate, countingRelease, &counts };
+    StringBuilder local = { nullptr, 0 };
+    StringBuilderInitGrowable(&local, &allocator);
+    std::string expected;
+    for (int i = 0; i < 1000; i++) {
+        StringBuilderAddInteger(&local, i);
+        StringBuilderAddChar(&local, ',');
+        expected += std::to_string(i) + ",";
+    }
+    StringBuilderAddChars(&local, expected.c_str(), expected.length());
+    expected += expected;
+    StringBuilderComplete(&local);
+    EXPECT_FALSE(local.full);
+    EXPECT_EQ(expected.length() + 1, local.added);
+    EXPECT_STREQ(expected.c_str(), local.ptr);
+
+    // Growth is geometric so only a few allocations are needed, and each
+    // previous buffer has been released.
+    EXPECT_LE(counts.allocations, 10);
+    EXPECT_EQ(counts.allocations - 1, counts.releases);
+
+    // Reinitializing keeps the capacity so no further allocations are made.
+    size_t capacity = local.length;
+    int allocations = counts.allocations;
+    StringBuilderInit(&local);
+    EXPECT_TRUE(StringBuilderReserve(&local, capacity - 1));
+    StringBuilderAddChars(&local, expected.c_str(), capacity - 1);
+    StringBuilderComplete(&local);
+    EXPECT_FALSE(local.full);
+    EXPECT_EQ(capacity, local.length);
+    EXPECT_EQ(allocations, counts.allocations);
+
+    // Reserving more than the capacity grows the buffer in one allocation.
+    EXPECT_TRUE(StringBuilderReserve(&local, capacity * 3));
+    EXPECT_LT(capacity * 3, local.remaining);
+    EXPECT_EQ(allocations + 1, counts.allocations);
+
+    StringBuilderFree(&local);
+    EXPECT_EQ(counts.allocations, counts.releases);
+    EXPECT_EQ(nullptr, local.ptr);
+}
+
+TEST_F(Strings, StringBuilder_GrowableCallerBuffer) {
+    char buffer[8];
+    StringBuilder local = { buffer, sizeof(buffer) };
+    StringBuilderInitGrowable(&local, nullptr);
+    StringBuilderAddChars(&local, "1234567", 7);
+    StringBuilderComplete(&local);
+    EXPECT_EQ(buffer, local.ptr);
+    EXPECT_EQ(nullptr, local.allocated);
+
+    StringBuilderInit(&local);
+    StringBuilderAddChars(&local, "1234567", 7);
+    StringBuilderAddDouble(&local, 8.5, 1);
+    StringBuilderComplete(&local);
+    EXPECT_NE(buffer, local.ptr);
+    EXPECT_FALSE(local.full);
+    EXPECT_STREQ("12345678.5", local.ptr);
+    StringBuilderFree(&local);
+}
+
+TEST_F(Strings, StringBuilder_ReserveFixed) {
+    StringBuilderInit(builder);
+    EXPECT_TRUE(StringBuilderReserve(builder, bufferSize - 1));
+    EXPECT_FALSE(StringBuilderReserve(builder, bufferSize));
+    EXPECT_EQ(bufferSize, builder->length);
+}
+
+// Appends the characters passed by the builder to the std::string state.
+static void truncateSink(void *state, const char *chars, size_t length) {
+    ((std::string *)state)->append(chars, length);
+}
+
+/**
+ * Check that truncating removes the characters after the length, including
+ * those lost when a fixed buffer is full, but not those passed to a sink.
+ */
+TEST_F(Strings, StringBuilder_Truncate) {
+    StringBuilderInit(builder);
+    StringBuilderAddChars(builder, "abcdef", 6);
+    StringBuilderTruncate(builder, 10);
+    EXPECT_EQ(6u, builder->added);
+    StringBuilderTruncate(builder, 2);
+    EXPECT_EQ(2u, builder->added);
+    EXPECT_EQ(bufferSize - 2, builder->remaining);
+    StringBuilderAddChar(builder, 'z');
+    StringBuilderComplete(builder);
+    EXPECT_STREQ("abz", builder->ptr);
+
+    // A full buffer is usable again once the lost characters are removed.
+    StringBuilderInit(builder);
+    for (size_t i = 0; i < bufferSize + 3; i++) {
+        StringBuilderAddChar(builder, 'a');
+    }
+    EXPECT_TRUE(builder->full);
+    StringBuilderTruncate(builder, bufferSize);
+    EXPECT_TRUE(builder->full);
+    EXPECT_EQ(bufferSize, builder->added);
+    StringBuilderTruncate(builder, 3);
+    EXPECT_FALSE(builder->full);
+    StringBuilderComplete(builder);
+    EXPECT_STREQ("aaa", builder->ptr);
+
+    // Characters already passed to the sink are kept.
+    std::string output;
+    char buffer[4];
+    StringBuilder local = { buffer, sizeof(buffer) };
+    local.sink = truncateSink;
+    local.sinkState = &output;
+    StringBuilderInit(&local);
+    StringBuilderAddChars(&local, "ab", 2);
+    StringBuilderTruncate(&local, 1);
+    StringBuilderFlush(&local);
+    StringBuilderAddChars(&local, "cd", 2);
+    StringBuilderTruncate(&local, 0);
+    EXPECT_EQ(3u, local.added);
+    StringBuilderTruncate(&local, 2);
+    StringBuilderComplete(&local);
+    EXPECT_EQ("ac", output);
+}
+
+/**
+ * Check that negative values keep their sign when the integer part is zero,
+ * round away from zero like positive values, and that a fraction which
+ * rounds to nothing still writes the integer part.
+ */
+TEST_F(Strings, StringBuilder_AddDoubleNegativeAndRounded) {
+    const struct { double value; uint8_t places; const char *expected; }
+    cases[] = {
+        { -0.5, 15, "-0.5" },
+        { -0.25, 1, "-0.3" },
+        { -2.7, 0, "-3" },
+        { -2.3, 0, "-2" },
+        { 2.7, 0, "3" },
+        { -0.0001, 2, "0" },
+        { 3.0001, 2, "3" },
+        { -3.0001, 2, "-3" },
+        { -0.9999, 2, "-1" },
+        { -12.125, 2, "-12.13" },
+    };
+    for (const auto &c : cases) {
+        StringBuilderInit(builder);
+        StringBuilderAddDouble(builder, c.value, c.places);
+        StringBuilderComplete(builder);
+        EXPECT_STREQ(c.expected, builder->ptr) << c.value;
+    }
+}
+
 TEST_F(Strings, StringBuilder_AddDouble) {
     {
         StringBuilderInit(builder);
@@ -375,6 +561,41 @@ TEST_F(Strings, StringBuilder_AddStringValue_Valid) {
     }
 }
 
+/**
+ * Check that stored floating point values between -1 and 0 keep their sign
+ * when converted to text, and that rounding is the same for negative values
+ * as for positive values.
+ */
+TEST_F(Strings, StringBuilder_AddStringValue_NegativeFloat) {
+    const struct { float value; uint8_t places; const char *expected; }
+    cases[] = {
+        { -0.5f, 3, "-0.5" },
+        { 0.5f, 3, "0.5" },
+        { -0.0625f, 2, "-0.06" },
+        { -0.0004f, 3, "0" },
+        { -2.5f, 0, "-3" },
+        { 2.5f, 0, "3" },
+        { -2.9996f, 3, "-3" },
+        { 2.9996f, 3, "3" },
+    };
+    EXCEPTION_CREATE;
+    for (const auto &c : cases) {
+        const fiftyoneDegreesFloat value =
+            FIFTYONE_DEGREES_NATIVE_TO_FLOAT(c.value);
+        EXCEPTION_CLEAR;
+        StringBuilderInit(builder);
+        StringBuilderAddStringValue(
+            builder,
+            (const StoredBinaryValue *)&value,
+            FIFTYONE_DEGREES_PROPERTY_VALUE_SINGLE_PRECISION_FLOAT,
+            c.places,
+            exception);
+        StringBuilderComplete(builder);
+        EXPECT_TRUE(EXCEPTION_OKAY) << ExceptionGetMessage(exception);
+        EXPECT_STREQ(c.expected, builder->ptr) << c.value;
+    }
+}
+
 TEST_F(Strings, StringBuilder_AddStringValue_Invalid) {
     EXCEPTION_CREATE;
     {
@@ -737,3 +958,240 @@ TEST_F(Strings, String_CompareLength) {
         EXPECT_NE(0, fiftyoneDegreesStringCompareLength(str1, str2, n));
     }
 }
+
+// Reference versions of the case insensitive methods which compare a single
+// character at a time.
+static int referenceCompare(const char *a, const char *b) {
+    for (; *a != '\0' && *b != '\0'; a++, b++) {
+        int d = tolower(*a) - tolower(*b);
+        if (d != 0) {
+            return d;
+        }
+    }
+    return *a == *b ? 0 : (*a == '\0' ? -1 : 1);
+}
+
+static int referenceCompareLength(const char *a, const char *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        int d = tolower(a[i]) - tolower(b[i]);
+        if (d != 0 || a[i] == '\0') {
+            return d;
+        }
+    }
+    return 0;
+}
+
+static const char *referenceSubString(const char *a, const char *b) {
+    for (; *a != '\0' && *b != '\0'; a++) {
+        const char *a1 = a, *b1 = b;
+        for (; *a1 != '\0' && *b1 != '\0' && 
+            tolower(*a1) == tolower(*b1); a1++, b1++);
+        if (*b1 == '\0') {
+            return a;
+        }
+    }
+    return nullptr;
+}
+
+/*
+ * Check that the methods return the same results as the reference methods
+ * for strings of many lengths, alignments, and positions of the first
+ * difference, including strings which end close to a page boundary.
+ */
+TEST_F(Strings, String_CompareMatchesReference) {
+    const char source[] = 
+        "Sec-CH-UA-Full-Version-List: \"Chromium\";v=\"118.0.5993.70\", "
+        "\"Google Chrome\";v=\"118.0.5993.70\", \"Not=A?Brand\";v=\"99.0.0.0\"";
+    const size_t sourceLength = sizeof(source) - 1;
+    std::vector<char> page(8192 + 128, '\0');
+    char *end = (char*)(((uintptr_t)page.data() + 4095) & ~(uintptr_t)4095) + 
+        4096;
+    std::vector<char> lower(sourceLength + 64), upper(sourceLength + 64);
+    for (size_t length = 0; length <= 80; length++) {
+        for (size_t offset = 0; offset < 3; offset++) {
+            // Lower case copy at an offset and upper case copy ending at a
+            // page boundary.
+            char *a = lower.data() + offset;
+            char *b = end - length - 1;
+            for (size_t i = 0; i < length; i++) {
+                a[i] = (char)tolower(source[i]);
+                b[i] = (char)toupper(source[i]);
+            }
+            a[length] = '\0';
+            b[length] = '\0';
+            EXPECT_EQ(0, fiftyoneDegreesStringCompare(a, b));
+            EXPECT_EQ(0, fiftyoneDegreesStringCompareLength(a, b, length));
+            EXPECT_EQ(length > 0 ? a : nullptr,
+                fiftyoneDegreesStringSubString(a, b));
+
+            // Change each character in turn.
+            for (size_t i = 0; i < length; i++) {
+                char original = b[i];
+                b[i] = '#';
+                EXPECT_EQ(referenceCompare(a, b), 
+                    fiftyoneDegreesStringCompare(a, b));
+                EXPECT_EQ(referenceCompareLength(a, b, length),
+                    fiftyoneDegreesStringCompareLength(a, b, length));
+                EXPECT_EQ(referenceSubString(a, b),
+                    fiftyoneDegreesStringSubString(a, b));
+                EXPECT_EQ(referenceSubString(b, a + i),
+                    fiftyoneDegreesStringSubString(b, a + i));
+                b[i] = original;
+            }
+
+            // Compare strings of different lengths, including with a length
+            // longer than both strings.
+            if (length > 0) {
+                EXPECT_EQ(referenceCompare(a, b + 1),
+                    fiftyoneDegreesStringCompare(a, b + 1));
+                EXPECT_EQ(referenceCompare(a + 1, b),
+                    fiftyoneDegreesStringCompare(a + 1, b));
+                EXPECT_EQ(referenceCompareLength(a, b + 1, length + 40),
+                    fiftyoneDegreesStringCompareLength(a, b + 1, length + 40));
+                EXPECT_EQ(referenceCompareLength(a + 1, b, length + 40),
+                    fiftyoneDegreesStringCompareLength(a + 1, b, length + 40));
+            }
+            EXPECT_EQ(0, fiftyoneDegreesStringCompareLength(
+                a, b, length + 40));
+        }
+    }
+    EXPECT_EQ(nullptr, fiftyoneDegreesStringSubString(source, ""));
+    EXPECT_EQ(source + sourceLength - 12, 
+        fiftyoneDegreesStringSubString(source, "V=\"99.0.0.0\""));
+}
+
+/*
+ * Check that comparing a length of characters which are not null terminated,
+ * such as a span of a larger header, only depends on the characters within
+ * the length for every length either side of the vector width.
+ */
+TEST_F(Strings, String_CompareLengthUnterminated) {
+    const char source[] = 
+        "Sec-CH-UA-Platform-Version: \"15.0.0\"; Sec-CH-UA-Mobile: ?0";
+    for (size_t length = 0; length <= 40; length++) {
+        // Exact size copies with different characters following the length
+        // in a larger buffer.
+        std::vector<char> a(source, source + length);
+        std::vector<char> b(length + 32, 'x');
+        for (size_t i = 0; i < length; i++) {
+            b[i] = (char)toupper(source[i]);
+        }
+        EXPECT_EQ(0, fiftyoneDegreesStringCompareLength(
+            a.data(), b.data(), length));
+        for (size_t i = 0; i < length; i++) {
+            char original = b[i];
+            b[i] = '#';
+            EXPECT_EQ(referenceCompareLength(a.data(), b.data(), length),
+                fiftyoneDegreesStringCompareLength(
+                    a.data(), b.data(), length));
+            b[i] = original;
+        }
+    }
+}
+
+/*
+ * Check that comparing a length stops at a null terminator in both strings,
+ * and at a shorter null terminated string, for every position either side of
+ * the vector width.
+ */
+TEST_F(Strings, String_CompareLengthStopsAtNull) {
+    for (size_t length = 0; length <= 40; length++) {
+        std::vector<char> a(length + 40, 'x');
+        std::vector<char> b(length + 40, 'y');
+        for (size_t i = 0; i < length; i++) {
+            a[i] = 'a';
+            b[i] = 'A';
+        }
+        a[length] = '\0';
+        b[length] = '\0';
+        EXPECT_EQ(0, fiftyoneDegreesStringCompareLength(
+            a.data(), b.data(), a.size()));
+        b[length] = 'A';
+        EXPECT_GT(0, fiftyoneDegreesStringCompareLength(
+            a.data(), b.data(), a.size()));
+        EXPECT_LT(0, fiftyoneDegreesStringCompareLength(
+            b.data(), a.data(), a.size()));
+    }
+}
+
+TEST_F(Strings, String_Hash) {
+    const char *names[] = { "Platform", "PLATFORM", "platform", "PlatformX" };
+    // Known FNV-1a hashes.
+    EXPECT_EQ(2166136261u, fiftyoneDegreesStringHash("", 0));
+    EXPECT_EQ(0xe40c292cu, fiftyoneDegreesStringHash("a", 1));
+    EXPECT_EQ(0xbf9cf968u, fiftyoneDegreesStringHash("foobar", 6));
+    // Only the case insensitive hash is the same for names which differ by
+    // case.
+    EXPECT_NE(fiftyoneDegreesStringHash(names[0], 8),
+        fiftyoneDegreesStringHash(names[1], 8));
+    EXPECT_EQ(fiftyoneDegreesStringHashCaseInsensitive(names[0], 8),
+        fiftyoneDegreesStringHashCaseInsensitive(names[1], 8));
+    EXPECT_EQ(fiftyoneDegreesStringHash(names[2], 8),
+        fiftyoneDegreesStringHashCaseInsensitive(names[1], 8));
+    // Only the length given is hashed.
+    EXPECT_EQ(fiftyoneDegreesStringHash(names[0], 8),
+        fiftyoneDegreesStringHash(names[3], 8));
+    EXPECT_NE(fiftyoneDegreesStringHash(names[0], 8),
+        fiftyoneDegreesStringHash(names[3], 9));
+}
+
+TEST_F(Strings, String_ToDouble) {
+    const char *valid[] = {
+        "0", "-0", "+1", "0.5", ".5", "5.", "-12.375", "1e3", "1E-3",
+        "2.5e+2", "000123.4500", "0.000000000000000000000000001",
+        "3.141592653589793238462643383279", "1.7976931348623157e308",
+        "4.9e-324", "123456789012345678", "9007199254740993" };
+    for (const char *text : valid) {
+        double number = -1;
+        EXPECT_TRUE(fiftyoneDegreesStringToDouble(
+            text, strlen(text), &number)) << text;
+        EXPECT_EQ(strtod(text, NULL), number) << text;
+    }
+    const char *invalid[] = {
+        "", "-", ".", "e5", "1e", "1e+", "1.2.3", "1,5", " 1", "1 ", "0x10",
+        "inf", "nan", "--1",
+        "12345678901234567890123456789012345678901" };
+    for (const char *text : invalid) {
+        double number = -1;
+        EXPECT_FALSE(fiftyoneDegreesStringToDouble(
+            text, strlen(text), &number)) << text;
+    }
+    // Only the length given is parsed.
+    double number = 0;
+    EXPECT_TRUE(fiftyoneDegreesStringToDouble("1.25x", 4, &number));
+    EXPECT_EQ(1.25, number);
+    // Exponents too large for an int are limited rather than overflowing.
+    EXPECT_TRUE(fiftyoneDegreesStringToDouble(
+        "1e99999999999", 13, &number));
+    EXPECT_EQ(HUGE_VAL, number);
+    EXPECT_TRUE(fiftyoneDegreesStringToDouble(
+        "1e-99999999999", 14, &number));
+    EXPECT_EQ(0, number);
+}
+
+TEST_F(Strings, String_ToDoubleIgnoresLocale) {
+    const char *locales[] = { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8",
+        "German_Germany.1252" };
+    std::string previous = setlocale(LC_NUMERIC, NULL);
+    bool set = false;
+    for (const char *locale : locales) {
+        if (setlocale(LC_NUMERIC, locale) != NULL) {
+            set = true;
+            break;
+        }
+    }
+    if (set == false) {
+        GTEST_SKIP() << "No locale with a comma decimal separator";
+    }
+    double number = 0;
+    bool parsed = fiftyoneDegreesStringToDouble("1.5", 3, &number) &&
+        number == 1.5;
+    bool parsedLong = fiftyoneDegreesStringToDouble(
+        "0.1234567890123456789", 21, &number) &&
+        number == 0.1234567890123456789;
+    bool parsedComma = fiftyoneDegreesStringToDouble("1,5", 3, &number);
+    setlocale(LC_NUMERIC, previous.c_str());
+    EXPECT_TRUE(parsed);
+    EXPECT_TRUE(parsedLong);
+    EXPECT_FALSE(parsedComma);
+}
@@ -1021,3 +1021,454 @@ TEST(WKBToT, WKBToT_String_Point_2D_NDR)
 	const byte * const wkbBytes = &wkbStringBytes[2];
 	convertAndCompare(wkbBytes, expected, "Point 2D (NDR) from String");
 }
+
+static void convertReducedAndCompare(
+	const byte * const wkbBytes,
+	const char * const expected,
+	const char * const comment) {
+
+	char buffer[DEFAULT_BUFFER_SIZE] = { 0 };
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+
+	fiftyoneDegreesConvertWkbToWkt(
+		wkbBytes,
+		FIFTYONE_DEGREES_WKBToT_REDUCTION_SHORT,
+		buffer, std::size(buffer),
+		3,
+		exception);
+
+	EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY) << comment;
+	EXPECT_STREQ(expected, buffer) << comment;
+}
+
+TEST(WKBToT, WKBToT_Reduced_LineString_NDR)
+{
+	const byte wkbBytes[] = {
+		0x01, // little endian
+		0x02, // LINESTRING (2D)
+		0x02,0x00, // 2 points
+		0x00,0x40, 0x00,0x40, // 16384 16384
+		0x01,0x80, 0x01,0x80, // -32767 -32767
+	};
+	convertReducedAndCompare(
+		wkbBytes,
+		"LINESTRING(90.003 45.001,-180 -90)",
+		"Reduced LineString (NDR)");
+}
+
+TEST(WKBToT, WKBToT_Reduced_LineString_XDR)
+{
+	const byte wkbBytes[] = {
+		0x00, // big endian
+		0x02, // LINESTRING (2D)
+		0x00,0x02, // 2 points
+		0x40,0x00, 0x40,0x00, // 16384 16384
+		0x80,0x01, 0x80,0x01, // -32767 -32767
+	};
+	convertReducedAndCompare(
+		wkbBytes,
+		"LINESTRING(90.003 45.001,-180 -90)",
+		"Reduced LineString (XDR)");
+}
+
+// Appends the reduced WKB short in the byte order provided, where 0 is big
+// endian and 1 is little endian.
+static void addReducedShort(std::vector<byte> &wkb, byte order, int value) {
+	const uint16_t bits = (uint16_t)(int16_t)value;
+	const byte high = (byte)(bits >> 8), low = (byte)(bits & 0xFF);
+	wkb.push_back(order ? low : high);
+	wkb.push_back(order ? high : low);
+}
+
+/**
+ * Check that reduced WKB gives the same text in either byte order for
+ * geometries whose counts and coordinates have different high and low
+ * bytes. The swapped short readers used to read the wrong bytes, so big
+ * endian reduced WKB decoded incorrectly on little endian machines.
+ */
+TEST(WKBToT, WKBToT_Reduced_ByteOrders)
+{
+	const int ring[][2] = {
+		{ 0, 0 }, { 32767, 0 }, { 0, 32767 }, { -32767, -258 }, { 0, 0 } };
+	const int point[] = { 0x1234, -0x1234 };
+	for (byte order = 0; order < 2; order++) {
+		std::vector<byte> polygon = { order, 0x03 }; // POLYGON (2D)
+		addReducedShort(polygon, order, 2); // 2 rings
+		for (int r = 0; r < 2; r++) {
+			addReducedShort(polygon, order, 5); // 5 points
+			for (const auto &p : ring) {
+				addReducedShort(polygon, order, r ? p[0] / 2 : p[0]);
+				addReducedShort(polygon, order, r ? p[1] / 2 : p[1]);
+			}
+		}
+		convertReducedAndCompare(
+			polygon.data(),
+			"POLYGON((0 0,180 0,0 90,-180 -0.709,0 0),"
+			"(0 0,89.997 0,0 44.999,-89.997 -0.354,0 0))",
+			order ? "Reduced Polygon (NDR)" : "Reduced Polygon (XDR)");
+
+		std::vector<byte> single = { order, 0x01 }; // POINT (2D)
+		addReducedShort(single, order, point[0]);
+		addReducedShort(single, order, point[1]);
+		convertReducedAndCompare(
+			single.data(),
+			"POINT(25.599 -12.799)",
+			order ? "Reduced Point (NDR)" : "Reduced Point (XDR)");
+	}
+}
+
+/**
+ * Check that a line string with more points than are decoded in one batch
+ * gives the same text in either byte order.
+ */
+TEST(WKBToT, WKBToT_Test_LineString_ManyPoints)
+{
+	const uint32_t count = 75;
+	std::string expected = "LINESTRING(";
+	for (uint32_t i = 0; i < count; i++) {
+		if (i) {
+			expected += ",";
+		}
+		expected += std::to_string(i) + (i ? " -" : " ") + std::to_string(i / 2) +
+			(i % 2 ? ".5" : "");
+	}
+	expected += ")";
+	for (byte order = 0; order < 2; order++) {
+		std::vector<byte> wkb;
+		auto add = [&](const void *value, size_t size) {
+			const byte *bytes = (const byte *)value;
+			for (size_t i = 0; i < size; i++) {
+				wkb.push_back(bytes[order ? i : size - 1 - i]);
+			}
+		};
+		const uint32_t type = 2;
+		wkb.push_back(order);
+		add(&type, sizeof(type));
+		add(&count, sizeof(count));
+		for (uint32_t i = 0; i < count; i++) {
+			const double x = i, y = -0.5 * i;
+			add(&x, sizeof(x));
+			add(&y, sizeof(y));
+		}
+		std::vector<char> buffer(4096);
+		FIFTYONE_DEGREES_EXCEPTION_CREATE;
+		fiftyoneDegreesConvertWkbToWkt(
+			wkb.data(),
+			FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+			buffer.data(), buffer.size(),
+			15,
+			exception);
+		EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		EXPECT_STREQ(expected.c_str(), buffer.data()) <<
+			"Byte order " << (int)order;
+	}
+}
+
+static const byte geometryCollectionWkb[] = {
+	0x01,
+	0x07, 0x00, 0x00, 0x00,
+	0x03, 0x00, 0x00, 0x00, // 3 geometries
+	0x01,
+	0x01, 0x00, 0x00, 0x00, // point
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x40,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x40,
+	0x00,
+	0x00, 0x00, 0x00, 0x03, // polygon (big endian)
+	0x00, 0x00, 0x00, 0x01, // 1 ring
+	0x00, 0x00, 0x00, 0x03, // 3 points
+	0x40, 0x3e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x40, 0x34, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x40, 0x46, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x40, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x40, 0x3e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x40, 0x34, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x01,
+	0x05, 0x00, 0x00, 0x00, // multi line string
+	0x01, 0x00, 0x00, 0x00, // 1 line string
+	0x01,
+	0xea, 0x03, 0x00, 0x00, // line string Z
+	0x02, 0x00, 0x00, 0x00, // 2 points
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2e, 0x40,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2e, 0x40,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x34, 0x40,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x34, 0x40,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xbf,
+};
+
+TEST(WKBToT, WKBToGeoJson_GeometryCollection)
+{
+	char buffer[DEFAULT_BUFFER_SIZE] = { 0 };
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	const auto result = fiftyoneDegreesConvertWkbToGeoJson(
+		geometryCollectionWkb,
+		FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+		buffer, std::size(buffer),
+		15,
+		exception);
+	EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+	EXPECT_FALSE(result.bufferTooSmall);
+	const char * const expected =
+		"{\"type\":\"GeometryCollection\",\"geometries\":["
+		"{\"type\":\"Point\",\"coordinates\":[10,10]},"
+		"{\"type\":\"Polygon\",\"coordinates\":[[[30,20],[45,40],[30,20]]]},"
+		"{\"type\":\"MultiLineString\",\"coordinates\":"
+		"[[[15,15,1],[20,20,-0.5]]]}"
+		"]}";
+	EXPECT_STREQ(expected, buffer);
+	EXPECT_EQ(strlen(expected) + 1, result.written);
+}
+
+TEST(WKBToT, WKBToGeoJson_Reduced)
+{
+	const byte wkbBytes[] = {
+		0x00, // big endian
+		0x02, // LINESTRING (2D)
+		0x00,0x02, // 2 points
+		0x40,0x00, 0x40,0x00, // 16384 16384
+		0x80,0x01, 0x80,0x01, // -32767 -32767
+	};
+	char buffer[DEFAULT_BUFFER_SIZE] = { 0 };
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	fiftyoneDegreesConvertWkbToGeoJson(
+		wkbBytes,
+		FIFTYONE_DEGREES_WKBToT_REDUCTION_SHORT,
+		buffer, std::size(buffer),
+		3,
+		exception);
+	EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+	EXPECT_STREQ(
+		"{\"type\":\"LineString\",\"coordinates\":"
+		"[[90.003,45.001],[-180,-90]]}",
+		buffer);
+}
+
+// Returns WKB in the machine byte order for a line string of the type
+// provided with the coordinates given, which include every dimension of each
+// point.
+static std::vector<byte> lineStringWkb(
+	uint32_t type,
+	uint32_t count,
+	const std::vector<double> &coordinates) {
+	const uint16_t one = 1;
+	std::vector<byte> wkb = { *(const byte *)&one };
+	auto add = [&](const void *value, size_t size) {
+		const byte *bytes = (const byte *)value;
+		wkb.insert(wkb.end(), bytes, bytes + size);
+	};
+	add(&type, sizeof(type));
+	add(&count, sizeof(count));
+	for (double coordinate : coordinates) {
+		add(&coordinate, sizeof(coordinate));
+	}
+	return wkb;
+}
+
+/**
+ * Check that M values are not written to GeoJSON positions, where the third
+ * member is the altitude, and that Z values are.
+ */
+TEST(WKBToT, WKBToGeoJson_MeasuredPositions)
+{
+	const struct {
+		uint32_t type;
+		std::vector<double> coordinates;
+		const char *expected;
+	} cases[] = {
+		{ 2002, { 1, 2, 7, 3, 4, 8 },
+			"{\"type\":\"LineString\",\"coordinates\":[[1,2],[3,4]]}" },
+		{ 3002, { 1, 2, 5, 7, 3, 4, 6, 8 },
+			"{\"type\":\"LineString\",\"coordinates\":[[1,2,5],[3,4,6]]}" },
+		{ 1002, { 1, 2, 5, 3, 4, 6 },
+			"{\"type\":\"LineString\",\"coordinates\":[[1,2,5],[3,4,6]]}" },
+	};
+	for (const auto &c : cases) {
+		const std::vector<byte> wkb = lineStringWkb(c.type, 2, c.coordinates);
+		char buffer[DEFAULT_BUFFER_SIZE] = { 0 };
+		FIFTYONE_DEGREES_EXCEPTION_CREATE;
+		fiftyoneDegreesConvertWkbToGeoJson(
+			wkb.data(),
+			FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+			buffer, std::size(buffer),
+			15,
+			exception);
+		EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY) << c.type;
+		EXPECT_STREQ(c.expected, buffer) << c.type;
+	}
+
+	// The WKT still has every dimension.
+	const std::vector<byte> wkb = lineStringWkb(
+		3002, 2, { 1, 2, 5, 7, 3, 4, 6, 8 });
+	char buffer[DEFAULT_BUFFER_SIZE] = { 0 };
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	fiftyoneDegreesConvertWkbToWkt(
+		wkb.data(),
+		FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+		buffer, std::size(buffer),
+		15,
+		exception);
+	EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+	EXPECT_STREQ("LINESTRING ZM(1 2 5 7,3 4 6 8)", buffer);
+}
+
+TEST(WKBToT, WKBToGeoJson_ReservedGeometry)
+{
+	const byte wkbBytes[] = {
+		0x01,
+		0x09, 0x00, 0x00, 0x00, // CompoundCurve
+	};
+	char buffer[DEFAULT_BUFFER_SIZE] = { 0 };
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	fiftyoneDegreesConvertWkbToGeoJson(
+		wkbBytes,
+		FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+		buffer, std::size(buffer),
+		15,
+		exception);
+	EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_CHECK(
+		FIFTYONE_DEGREES_STATUS_RESERVED_GEOMETRY));
+}
+
+// Records each run of points passed to the coordinates callback.
+struct CoordinateRuns {
+	std::vector<fiftyoneDegreesWkbCoordinates> runs;
+	std::vector<double> coordinates;
+	size_t stopAfter = SIZE_MAX;
+
+	static bool add(void *state, const fiftyoneDegreesWkbCoordinates *run) {
+		auto *self = (CoordinateRuns*)state;
+		self->runs.push_back(*run);
+		self->coordinates.insert(
+			self->coordinates.end(),
+			run->coordinates,
+			run->coordinates + run->count * run->dimensions);
+		return self->runs.size() < self->stopAfter;
+	}
+};
+
+TEST(WKBToT, WkbIterateCoordinates_GeometryCollection)
+{
+	CoordinateRuns runs;
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	const uint32_t points = fiftyoneDegreesWkbIterateCoordinates(
+		geometryCollectionWkb,
+		FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+		&runs,
+		CoordinateRuns::add,
+		exception);
+	EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+	EXPECT_EQ(6u, points);
+	ASSERT_EQ(3u, runs.runs.size());
+	EXPECT_EQ(1u, runs.runs[0].geometryCode);
+	EXPECT_EQ(0u, runs.runs[0].geometryIndex);
+	EXPECT_EQ(3u, runs.runs[1].geometryCode);
+	EXPECT_EQ(1u, runs.runs[1].geometryIndex);
+	EXPECT_EQ(3u, runs.runs[1].count);
+	EXPECT_EQ(2u, runs.runs[2].geometryCode);
+	EXPECT_EQ(2u, runs.runs[2].geometryIndex);
+	EXPECT_EQ(3u, runs.runs[2].dimensions);
+	const std::vector<double> expected = {
+		10, 10,
+		30, 20, 45, 40, 30, 20,
+		15, 15, 1, 20, 20, -0.5 };
+	EXPECT_EQ(expected, runs.coordinates);
+}
+
+/**
+ * Check that the runs say which of the coordinates are z and m.
+ */
+TEST(WKBToT, WkbIterateCoordinates_CoordinateTypes)
+{
+	const struct {
+		uint32_t type;
+		uint8_t dimensions;
+		bool hasZ;
+		bool hasM;
+	} cases[] = {
+		{ 2, 2, false, false },
+		{ 1002, 3, true, false },
+		{ 2002, 3, false, true },
+		{ 3002, 4, true, true },
+	};
+	for (const auto &c : cases) {
+		const std::vector<double> coordinates(c.dimensions * 2, 1.0);
+		const std::vector<byte> wkb = lineStringWkb(c.type, 2, coordinates);
+		CoordinateRuns runs;
+		FIFTYONE_DEGREES_EXCEPTION_CREATE;
+		EXPECT_EQ(2u, fiftyoneDegreesWkbIterateCoordinates(
+			wkb.data(),
+			FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+			&runs,
+			CoordinateRuns::add,
+			exception));
+		EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		ASSERT_EQ(1u, runs.runs.size()) << c.type;
+		EXPECT_EQ(c.dimensions, runs.runs[0].dimensions) << c.type;
+		EXPECT_EQ(c.hasZ, runs.runs[0].hasZ) << c.type;
+		EXPECT_EQ(c.hasM, runs.runs[0].hasM) << c.type;
+	}
+}
+
+/**
+ * Check that aligned doubles in the machine byte order are passed without
+ * copying, and that other WKB is decoded in batches in the same order.
+ */
+TEST(WKBToT, WkbIterateCoordinates_ZeroCopyAndBatches)
+{
+	const uint32_t count = 75;
+	for (byte order = 0; order < 2; order++) {
+		// Place the coordinates of the line string at an aligned address.
+		std::vector<double> storage(count * 2 + 2);
+		byte * const wkb = (byte*)storage.data() + 7;
+		wkb[0] = order;
+		const uint32_t type = 2;
+		for (int i = 0; i < 4; i++) {
+			wkb[1 + i] = (byte)(order ? type >> (8 * i) : type >> (24 - 8 * i));
+			wkb[5 + i] = (byte)(order ? count >> (8 * i) : count >> (24 - 8 * i));
+		}
+		std::vector<double> expected;
+		for (uint32_t i = 0; i < count * 2; i++) {
+			const double value = i * 1.5;
+			byte bytes[sizeof(double)];
+			memcpy(bytes, &value, sizeof(bytes));
+			for (size_t b = 0; b < sizeof(bytes); b++) {
+				wkb[9 + i * sizeof(double) + b] =
+					bytes[order ? b : sizeof(bytes) - 1 - b];
+			}
+			expected.push_back(value);
+		}
+
+		CoordinateRuns runs;
+		FIFTYONE_DEGREES_EXCEPTION_CREATE;
+		EXPECT_EQ(count, fiftyoneDegreesWkbIterateCoordinates(
+			wkb,
+			FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+			&runs,
+			CoordinateRuns::add,
+			exception));
+		EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		EXPECT_EQ(expected, runs.coordinates);
+		if (order == 1) {
+			ASSERT_EQ(1u, runs.runs.size());
+			EXPECT_EQ((const double*)(wkb + 9), runs.runs[0].coordinates);
+		} else {
+			ASSERT_EQ(3u, runs.runs.size());
+			EXPECT_EQ(0u, runs.runs[0].first);
+			EXPECT_EQ(32u, runs.runs[1].first);
+			EXPECT_EQ(64u, runs.runs[2].first);
+			EXPECT_EQ(11u, runs.runs[2].count);
+		}
+
+		// Stopping after the first run passes no more points.
+		CoordinateRuns first;
+		first.stopAfter = 1;
+		EXPECT_EQ(order == 1 ? count : 32u,
+			fiftyoneDegreesWkbIterateCoordinates(
+				wkb,
+				FIFTYONE_DEGREES_WKBToT_REDUCTION_NONE,
+				&first,
+				CoordinateRuns::add,
+				exception));
+		EXPECT_EQ(1u, first.runs.size());
+	}
+}
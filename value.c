@@ -32,6 +32,7 @@ MAP_TYPE(CollectionItem);
 typedef struct value_search_t {
 	const Collection *strings;
 	const char *valueName;
+	StoredBinaryValueTarget target;
 	PropertyValueType valueType;
 	StringBuilder *tempBuilder;
 } valueSearch;
@@ -59,10 +60,10 @@ static int compareValueByName(
 		&name,
 		exception);
 	if (value != NULL && EXCEPTION_OKAY) {
-		result = StoredBinaryValueCompareWithString(
+		result = StoredBinaryValueCompareWithTarget(
 			value,
 			search->valueType,
-			search->valueName,
+			&search->target,
 			search->tempBuilder,
 			exception);
 		COLLECTION_RELEASE(search->strings, &name);
@@ -163,6 +164,7 @@ long fiftyoneDegreesValueGetIndexByNameAndType(
 	long index;
 	DataReset(&item.data);
 	search.valueName = valueName;
+	StoredBinaryValueTargetInit(&search.target, valueName);
 	search.strings = strings;
 	search.valueType = storedValueType;
 
@@ -219,6 +221,7 @@ const Value* fiftyoneDegreesValueGetByNameAndType(
 	valueSearch search;
 	Value *value = NULL;
 	search.valueName = valueName;
+	StoredBinaryValueTargetInit(&search.target, valueName);
 	search.strings = strings;
 	search.valueType = storedValueType;
 
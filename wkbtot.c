@@ -29,16 +29,18 @@ typedef uint8_t DecimalPlacesType;
 
 typedef struct {
     CoordIndexType dimensionsCount;
+    bool hasZ;
+    bool hasM;
     const char *tag;
     size_t tagLength;
 } CoordMode;
 
 
 static const CoordMode CoordModes[] = {
-    { 2, NULL, 0 },
-    { 3, "Z", 1 },
-    { 3, "M", 1 },
-    { 4, "ZM", 2 },
+    { 2, false, false, NULL, 0 },
+    { 3, true, false, "Z", 1 },
+    { 3, false, true, "M", 1 },
+    { 4, true, true, "ZM", 2 },
 };
 
 
@@ -51,96 +53,222 @@ typedef enum {
 #define ByteOrder_NDR FIFTYONE_DEGREES_WKBToT_ByteOrder_NDR
 
 typedef uint16_t (*RawUShortReader)(const byte **wkbBytes);
-typedef int16_t (*RawShortReader)(const byte **wkbBytes);
 typedef uint32_t (*RawIntReader)(const byte **wkbBytes);
-typedef double (*RawDoubleReader)(const byte **wkbBytes);
 
-static uint8_t readUByte(const byte ** const wkbBytes) {
-    const uint8_t result = *(uint8_t *)(*wkbBytes);
-    *wkbBytes += 1;
+// Byte swaps used when the WKB byte order does not match the machine. These
+// compile to single instructions where the compiler provides an intrinsic.
+#if defined(_MSC_VER)
+#define BSWAP16(x) _byteswap_ushort(x)
+#define BSWAP32(x) _byteswap_ulong(x)
+#define BSWAP64(x) _byteswap_uint64(x)
+#elif defined(__GNUC__) || defined(__clang__)
+#define BSWAP16(x) __builtin_bswap16(x)
+#define BSWAP32(x) __builtin_bswap32(x)
+#define BSWAP64(x) __builtin_bswap64(x)
+#else
+static uint16_t BSWAP16(const uint16_t x) {
+    return (uint16_t)((x >> 8) | (x << 8));
+}
+static uint32_t BSWAP32(const uint32_t x) {
+    return ((x >> 24) & 0xFF) | ((x >> 8) & 0xFF00) |
+        ((x << 8) & 0xFF0000) | (x << 24);
+}
+static uint64_t BSWAP64(const uint64_t x) {
+    return ((uint64_t)BSWAP32((uint32_t)x) << 32) |
+        BSWAP32((uint32_t)(x >> 32));
+}
+#endif
+
+// Loads of values which might not be aligned within the WKB.
+static uint16_t loadUShort(const byte * const bytes) {
+    uint16_t result;
+    memcpy(&result, bytes, sizeof(result));
     return result;
 }
-static int8_t readSByte(const byte ** const wkbBytes) {
-    const int8_t result = *(int8_t *)(*wkbBytes);
-    *wkbBytes += 1;
+static uint32_t loadInt(const byte * const bytes) {
+    uint32_t result;
+    memcpy(&result, bytes, sizeof(result));
     return result;
 }
-static int16_t readShortMatchingByteOrder(const byte ** const wkbBytes) {
-    const int16_t result = *(int16_t *)(*wkbBytes);
-    *wkbBytes += 2;
+static uint64_t loadLong(const byte * const bytes) {
+    uint64_t result;
+    memcpy(&result, bytes, sizeof(result));
+    return result;
+}
+static double bitsToDouble(const uint64_t bits) {
+    double result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static uint8_t readUByte(const byte ** const wkbBytes) {
+    const uint8_t result = *(uint8_t *)(*wkbBytes);
+    *wkbBytes += 1;
     return result;
 }
 static uint16_t readUShortMatchingByteOrder(const byte ** const wkbBytes) {
-    const uint16_t result = *(uint16_t *)(*wkbBytes);
+    const uint16_t result = loadUShort(*wkbBytes);
     *wkbBytes += 2;
     return result;
 }
 static uint32_t readIntMatchingByteOrder(const byte ** const wkbBytes) {
-    const uint32_t result = *(uint32_t *)(*wkbBytes);
+    const uint32_t result = loadInt(*wkbBytes);
     *wkbBytes += 4;
     return result;
 }
-static double readDoubleMatchingByteOrder(const byte ** const wkbBytes) {
-    const double result = *(double *)(*wkbBytes);
-    *wkbBytes += 8;
-    return result;
-}
-
 static uint16_t readUShortMismatchingByteOrder(const byte ** const wkbBytes) {
-    byte t[2];
-    for (short i = 0; i < 2; i++) {
-        t[i] = (*wkbBytes)[2 - i];
-    }
-    *wkbBytes += 2;
-    return *(uint16_t *)t;
-}
-static int16_t readShortMismatchingByteOrder(const byte ** const wkbBytes) {
-    byte t[2];
-    for (short i = 0; i < 2; i++) {
-        t[i] = (*wkbBytes)[2 - i];
-    }
+    const uint16_t result = BSWAP16(loadUShort(*wkbBytes));
     *wkbBytes += 2;
-    return *(int16_t *)t;
+    return result;
 }
 static uint32_t readIntMismatchingByteOrder(const byte ** const wkbBytes) {
-    byte t[4];
-    for (short i = 0; i < 4; i++) {
-        t[i] = (*wkbBytes)[3 - i];
-    }
+    const uint32_t result = BSWAP32(loadInt(*wkbBytes));
     *wkbBytes += 4;
-    return *(uint32_t *)t;
-}
-static double readDoubleMismatchingByteOrder(const byte ** const wkbBytes) {
-    byte t[8];
-    for (short i = 0; i < 8; i++) {
-        t[i] = (*wkbBytes)[7 - i];
-    }
-    *wkbBytes += 8;
-    return *(double *)t;
+    return result;
 }
 typedef struct {
     const char *name;
+    bool isSwapped;
     RawUShortReader readUShort;
-    RawShortReader readShort;
     RawIntReader readInt;
-    RawDoubleReader readDouble;
 } RawValueReader;
 
 static const RawValueReader MATCHING_BYTE_ORDER_RAW_VALUE_READER = {
     "Matching Byte Order RawValueReader",
+    false,
     readUShortMatchingByteOrder,
-    readShortMatchingByteOrder,
     readIntMatchingByteOrder,
-    readDoubleMatchingByteOrder,
 };
 static const RawValueReader MISMATCHING_BYTE_ORDER_RAW_VALUE_READER = {
     "Mismatching Byte Order RawValueReader",
+    true,
     readUShortMismatchingByteOrder,
-    readShortMismatchingByteOrder,
     readIntMismatchingByteOrder,
-    readDoubleMismatchingByteOrder,
 };
 
+// Coordinate decoders used by the points writers. Each takes the first byte
+// of the coordinate and its index within the point.
+#define DECODE_FULL_MATCHING(bytes, coordIndex) \
+    bitsToDouble(loadLong(bytes))
+#define DECODE_FULL_SWAPPED(bytes, coordIndex) \
+    bitsToDouble(BSWAP64(loadLong(bytes)))
+#define DECODE_SHORT(raw, coordIndex) \
+    (((int16_t)(raw) * ((coordIndex) & 1 ? 90.0 : 180.0)) / INT16_MAX)
+#define DECODE_SHORT_MATCHING(bytes, coordIndex) \
+    DECODE_SHORT(loadUShort(bytes), coordIndex)
+#define DECODE_SHORT_SWAPPED(bytes, coordIndex) \
+    DECODE_SHORT(BSWAP16(loadUShort(bytes)), coordIndex)
+
+/**
+ * Decodes a run of points to the coordinates array, which must have room
+ * for count points. Returns the first byte after the points.
+ */
+typedef const byte *(*PointsDecoder)(
+    const byte *wkbBytes,
+    uint32_t count,
+    double *coords);
+
+/**
+ * Characters written before each point, between its coordinates and after
+ * it. Zero if no character is written. GeoJSON positions only have x, y and
+ * an optional altitude, so M values are not written.
+ */
+typedef struct {
+    char pointStart;
+    char coordSeparator;
+    char pointEnd;
+    bool withM;
+} PointsFormat;
+
+static const PointsFormat POINTS_FORMAT_WKT = { 0, ' ', 0, true };
+static const PointsFormat POINTS_FORMAT_GEOJSON = { '[', ',', ']', false };
+
+/**
+ * Writes a run of points to the builder in the format provided with points
+ * separated by commas. Only the first written coordinates of each point are
+ * added to the builder, so that trailing M values can be left out. Returns
+ * the first byte after the points.
+ */
+typedef const byte *(*PointsWriter)(
+    StringBuilder *builder,
+    const PointsFormat *format,
+    const byte *wkbBytes,
+    uint32_t count,
+    CoordIndexType written,
+    DecimalPlacesType decimalPlaces);
+
+// Number of points decoded together before they are formatted.
+#define POINTS_BATCH 32
+
+/**
+ * Defines a points decoder and a points writer for one combination of byte
+ * order, coordinate size and number of dimensions so that the decoding loop
+ * has no indirect calls and a fixed stride. The writer decodes coordinates
+ * a batch at a time into a local array before they are formatted.
+ */
+#define DEFINE_POINTS(suffix, dims, coordSize, decode) \
+static const byte *decodePoints##suffix( \
+    const byte * const wkbBytes, \
+    const uint32_t count, \
+    double * const coords) { \
+    for (uint32_t p = 0; p < count; p++) { \
+        for (uint32_t c = 0; c < (dims); c++) { \
+            coords[p * (dims) + c] = decode( \
+                wkbBytes + (p * (dims) + c) * (coordSize), c); \
+        } \
+    } \
+    return wkbBytes + count * (dims) * (coordSize); \
+} \
+static const byte *writePoints##suffix( \
+    StringBuilder * const builder, \
+    const PointsFormat * const format, \
+    const byte *wkbBytes, \
+    const uint32_t count, \
+    const CoordIndexType written, \
+    const DecimalPlacesType decimalPlaces) { \
+    double coords[POINTS_BATCH * (dims)]; \
+    for (uint32_t done = 0; done < count;) { \
+        const uint32_t batch = count - done < POINTS_BATCH ? \
+            count - done : POINTS_BATCH; \
+        wkbBytes = decodePoints##suffix(wkbBytes, batch, coords); \
+        for (uint32_t p = 0; p < batch; p++) { \
+            if (done + p) { \
+                StringBuilderAddChar(builder, ','); \
+            } \
+            if (format->pointStart) { \
+                StringBuilderAddChar(builder, format->pointStart); \
+            } \
+            for (uint32_t c = 0; c < written; c++) { \
+                if (c) { \
+                    StringBuilderAddChar(builder, format->coordSeparator); \
+                } \
+                StringBuilderAddDouble( \
+                    builder, \
+                    coords[p * (dims) + c], \
+                    decimalPlaces); \
+            } \
+            if (format->pointEnd) { \
+                StringBuilderAddChar(builder, format->pointEnd); \
+            } \
+        } \
+        done += batch; \
+    } \
+    return wkbBytes; \
+}
+
+DEFINE_POINTS(FullMatching2, 2, 8, DECODE_FULL_MATCHING)
+DEFINE_POINTS(FullMatching3, 3, 8, DECODE_FULL_MATCHING)
+DEFINE_POINTS(FullMatching4, 4, 8, DECODE_FULL_MATCHING)
+DEFINE_POINTS(FullSwapped2, 2, 8, DECODE_FULL_SWAPPED)
+DEFINE_POINTS(FullSwapped3, 3, 8, DECODE_FULL_SWAPPED)
+DEFINE_POINTS(FullSwapped4, 4, 8, DECODE_FULL_SWAPPED)
+DEFINE_POINTS(ShortMatching2, 2, 2, DECODE_SHORT_MATCHING)
+DEFINE_POINTS(ShortMatching3, 3, 2, DECODE_SHORT_MATCHING)
+DEFINE_POINTS(ShortMatching4, 4, 2, DECODE_SHORT_MATCHING)
+DEFINE_POINTS(ShortSwapped2, 2, 2, DECODE_SHORT_SWAPPED)
+DEFINE_POINTS(ShortSwapped3, 3, 2, DECODE_SHORT_SWAPPED)
+DEFINE_POINTS(ShortSwapped4, 4, 2, DECODE_SHORT_SWAPPED)
+
 static ByteOrder getMachineByteOrder() {
     byte buffer[4];
     *(uint32_t *)buffer = 1;
@@ -157,11 +285,12 @@ typedef enum {
 
 struct num_reader_t;
 typedef uint32_t (*IntReader)(const RawValueReader *rawReader, const byte **wkbBytes);
-typedef double (*DoubleReader)(const RawValueReader *rawReader, const byte **wkbBytes);
 typedef struct num_reader_t {
     const char *name;
     IntReader readInt[2]; // by IntPurpose
-    DoubleReader readDouble[4]; // by coord index
+    size_t coordSize; // bytes per coordinate
+    PointsDecoder decodePoints[2][3]; // by isSwapped, then dimensions - 2
+    PointsWriter writePoints[2][3]; // by isSwapped, then dimensions - 2
 } NumReader;
 
 static uint32_t readFullInteger(
@@ -169,19 +298,37 @@ static uint32_t readFullInteger(
     const byte ** const wkbBytes) {
     return rawReader->readInt(wkbBytes);
 }
-static double readFullDouble(
-    const RawValueReader * const rawReader,
-    const byte ** const wkbBytes) {
-    return rawReader->readDouble(wkbBytes);
-}
 static const NumReader NUM_READER_STANDARD = {
     "Standard NumReader",
-    readFullInteger,
-    readFullInteger,
-    readFullDouble,
-    readFullDouble,
-    readFullDouble,
-    readFullDouble,
+    {
+        readFullInteger,
+        readFullInteger,
+    },
+    sizeof(double),
+    {
+        {
+            decodePointsFullMatching2,
+            decodePointsFullMatching3,
+            decodePointsFullMatching4,
+        },
+        {
+            decodePointsFullSwapped2,
+            decodePointsFullSwapped3,
+            decodePointsFullSwapped4,
+        },
+    },
+    {
+        {
+            writePointsFullMatching2,
+            writePointsFullMatching3,
+            writePointsFullMatching4,
+        },
+        {
+            writePointsFullSwapped2,
+            writePointsFullSwapped3,
+            writePointsFullSwapped4,
+        },
+    },
 };
 
 static uint32_t readSingleUByte(
@@ -197,24 +344,37 @@ static uint32_t readUShort(
     const byte **wkbBytes) {
     return rawReader->readUShort(wkbBytes);
 }
-static double readShortAzimuth(
-    const RawValueReader * const rawReader,
-    const byte **wkbBytes) {
-    return (rawReader->readShort(wkbBytes) * 180.0) / INT16_MAX;
-}
-static double readShortDeclination(
-    const RawValueReader * const rawReader,
-    const byte **wkbBytes) {
-    return (rawReader->readShort(wkbBytes) * 90.0) / INT16_MAX;
-}
 static const NumReader NUM_READER_REDUCED_SHORT = {
     "Short-Reduced NumReader",
-    readSingleUByte,
-    readUShort,
-    readShortAzimuth,
-    readShortDeclination,
-    readShortAzimuth,
-    readShortDeclination,
+    {
+        readSingleUByte,
+        readUShort,
+    },
+    sizeof(int16_t),
+    {
+        {
+            decodePointsShortMatching2,
+            decodePointsShortMatching3,
+            decodePointsShortMatching4,
+        },
+        {
+            decodePointsShortSwapped2,
+            decodePointsShortSwapped3,
+            decodePointsShortSwapped4,
+        },
+    },
+    {
+        {
+            writePointsShortMatching2,
+            writePointsShortMatching3,
+            writePointsShortMatching4,
+        },
+        {
+            writePointsShortSwapped2,
+            writePointsShortSwapped3,
+            writePointsShortSwapped4,
+        },
+    },
 };
 
 static const NumReader *selectNumReader(const WkbtotReductionMode reductionMode) {
@@ -241,6 +401,7 @@ typedef struct {
     ByteOrder const machineByteOrder;
     const RawValueReader *rawValueReader;
     const NumReader * const numReader;
+    const PointsFormat * const pointsFormat;
 
     DecimalPlacesType const decimalPlaces;
     Exception * const exception;
@@ -255,13 +416,22 @@ static uint32_t readInt(
         &context->binaryBuffer);
 }
 
-static double readDouble(
+static void writePoints(
     ProcessingContext * const context,
-    const CoordIndexType coordIndex) {
+    const uint32_t count) {
 
-    return context->numReader->readDouble[coordIndex](
-        context->rawValueReader,
-        &context->binaryBuffer);
+    const CoordMode * const mode = &context->coordMode;
+    const PointsWriter writer = context->numReader->writePoints[
+        context->rawValueReader->isSwapped][
+        mode->dimensionsCount - 2];
+    context->binaryBuffer = writer(
+        context->output.stringBuilder,
+        context->pointsFormat,
+        context->binaryBuffer,
+        count,
+        (CoordIndexType)(mode->hasM && !context->pointsFormat->withM ?
+            mode->dimensionsCount - 1 : mode->dimensionsCount),
+        context->decimalPlaces);
 }
 
 static void writeEmpty(
@@ -298,6 +468,13 @@ static void writeTaggedGeometryName(
 typedef void (*LoopVisitor)(
     ProcessingContext * const context);
 
+static void handlePointSegment(
+    ProcessingContext * const context) {
+
+    writePoints(context, 1);
+    context->output.isSeparated = false;
+}
+
 static void withParenthesesIterate(
     ProcessingContext * const context,
     const LoopVisitor visitor,
@@ -307,34 +484,25 @@ static void withParenthesesIterate(
 
     StringBuilderAddChar(context->output.stringBuilder, '(');
     context->output.isSeparated = true;
-    for (uint32_t i = 0; i < count; i++) {
-        if (i) {
-            StringBuilderAddChar(context->output.stringBuilder, ',');
-            context->output.isSeparated = true;
-        }
-        visitor(context);
-        if (EXCEPTION_FAILED) {
-            return;
+    if (visitor == handlePointSegment) {
+        // Points are written in one run without a call per point.
+        writePoints(context, count);
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            if (i) {
+                StringBuilderAddChar(context->output.stringBuilder, ',');
+                context->output.isSeparated = true;
+            }
+            visitor(context);
+            if (EXCEPTION_FAILED) {
+                return;
+            }
         }
     }
     StringBuilderAddChar(context->output.stringBuilder, ')');
     context->output.isSeparated = true;
 }
 
-static void handlePointSegment(
-    ProcessingContext * const context) {
-
-    for (CoordIndexType i = 0; i < context->coordMode.dimensionsCount; i++) {
-        if (i) {
-            StringBuilderAddChar(context->output.stringBuilder, ' ');
-            context->output.isSeparated = true;
-        }
-        const double nextCoord = readDouble(context, i);
-        StringBuilderAddDouble(context->output.stringBuilder, nextCoord, context->decimalPlaces);
-        context->output.isSeparated = false;
-    }
-}
-
 static void handleLoop(
     ProcessingContext * const context,
     const LoopVisitor visitor) {
@@ -599,6 +767,7 @@ static void handleWKBRoot(
         getMachineByteOrder(),
         NULL,
         selectNumReader(reductionMode),
+        &POINTS_FORMAT_WKT,
 
         decimalPlaces,
         exception,
@@ -648,3 +817,348 @@ fiftyoneDegreesWkbtotResult fiftyoneDegreesConvertWkbToWkt(
     };
     return result;
 }
+
+// GeoJSON type of each WKB geometry code, or NULL if the geometry can't be
+// written as GeoJSON. Triangles are written as polygons, and polyhedral
+// surfaces and TINs as multi polygons, as they have the same structure.
+static const char * const GEOJSON_TYPES[] = {
+    NULL,
+    "Point",
+    "LineString",
+    "Polygon",
+    "MultiPoint",
+    "MultiLineString",
+    "MultiPolygon",
+    "GeometryCollection",
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    "MultiPolygon",
+    "MultiPolygon",
+    "Polygon",
+};
+
+#define GEOMETRY_CODE_POINT 1
+#define GEOMETRY_CODE_LINESTRING 2
+#define GEOMETRY_CODE_POLYGON 3
+#define GEOMETRY_CODE_GEOMETRYCOLLECTION 7
+#define GEOMETRY_CODE_TRIANGLE 17
+
+/**
+ * Reads the byte order and type of the next geometry and sets the coordinate
+ * mode. Returns the geometry code, or sets an exception if the geometry has
+ * no GeoJSON type.
+ */
+static uint32_t readGeometryHeader(
+    ProcessingContext * const context) {
+
+    Exception * const exception = context->exception;
+    updateWkbByteOrder(context);
+
+    const uint32_t geometryTypeFull = readInt(context, IntPurpose_WkbType);
+    const uint32_t coordType = geometryTypeFull / 1000;
+    const uint32_t geometryCode = geometryTypeFull % 1000;
+
+    static size_t const GeometriesCount =
+        sizeof(GEOJSON_TYPES) / sizeof(GEOJSON_TYPES[0]);
+    if (geometryCode >= GeometriesCount ||
+        coordType >= sizeof(CoordModes) / sizeof(CoordModes[0])) {
+        EXCEPTION_SET(UNKNOWN_GEOMETRY);
+        return 0;
+    }
+    if (!GEOJSON_TYPES[geometryCode]) {
+        EXCEPTION_SET(RESERVED_GEOMETRY);
+        return 0;
+    }
+    context->coordMode = CoordModes[coordType];
+    return geometryCode;
+}
+
+static void writeGeoJsonCoordinates(
+    ProcessingContext * const context,
+    const uint32_t geometryCode) {
+
+    Exception * const exception = context->exception;
+    StringBuilder * const builder = context->output.stringBuilder;
+    uint32_t count;
+
+    switch (geometryCode) {
+        case GEOMETRY_CODE_POINT:
+            writePoints(context, 1);
+            break;
+        case GEOMETRY_CODE_LINESTRING:
+            count = readInt(context, IntPurpose_LoopCount);
+            StringBuilderAddChar(builder, '[');
+            writePoints(context, count);
+            StringBuilderAddChar(builder, ']');
+            break;
+        case GEOMETRY_CODE_POLYGON:
+        case GEOMETRY_CODE_TRIANGLE:
+            count = readInt(context, IntPurpose_LoopCount);
+            StringBuilderAddChar(builder, '[');
+            for (uint32_t i = 0; i < count; i++) {
+                if (i) {
+                    StringBuilderAddChar(builder, ',');
+                }
+                StringBuilderAddChar(builder, '[');
+                writePoints(context, readInt(context, IntPurpose_LoopCount));
+                StringBuilderAddChar(builder, ']');
+            }
+            StringBuilderAddChar(builder, ']');
+            break;
+        default:
+            // Multi geometries where each item is a geometry with a header.
+            count = readInt(context, IntPurpose_LoopCount);
+            StringBuilderAddChar(builder, '[');
+            for (uint32_t i = 0; i < count; i++) {
+                if (i) {
+                    StringBuilderAddChar(builder, ',');
+                }
+                const uint32_t childCode = readGeometryHeader(context);
+                if (EXCEPTION_FAILED) {
+                    return;
+                }
+                writeGeoJsonCoordinates(context, childCode);
+                if (EXCEPTION_FAILED) {
+                    return;
+                }
+            }
+            StringBuilderAddChar(builder, ']');
+            break;
+    }
+}
+
+static void writeGeoJsonGeometry(
+    ProcessingContext * const context) {
+
+    static const char typeStart[] = "{\"type\":\"";
+    static const char coordinates[] = "\",\"coordinates\":";
+    static const char geometries[] = "\",\"geometries\":[";
+    Exception * const exception = context->exception;
+    StringBuilder * const builder = context->output.stringBuilder;
+
+    const uint32_t geometryCode = readGeometryHeader(context);
+    if (EXCEPTION_FAILED) {
+        return;
+    }
+    const char * const type = GEOJSON_TYPES[geometryCode];
+    StringBuilderAddChars(builder, typeStart, sizeof(typeStart) - 1);
+    StringBuilderAddChars(builder, type, strlen(type));
+    if (geometryCode == GEOMETRY_CODE_GEOMETRYCOLLECTION) {
+        StringBuilderAddChars(builder, geometries, sizeof(geometries) - 1);
+        const uint32_t count = readInt(context, IntPurpose_LoopCount);
+        for (uint32_t i = 0; i < count; i++) {
+            if (i) {
+                StringBuilderAddChar(builder, ',');
+            }
+            writeGeoJsonGeometry(context);
+            if (EXCEPTION_FAILED) {
+                return;
+            }
+        }
+        StringBuilderAddChar(builder, ']');
+    } else {
+        StringBuilderAddChars(builder, coordinates, sizeof(coordinates) - 1);
+        writeGeoJsonCoordinates(context, geometryCode);
+        if (EXCEPTION_FAILED) {
+            return;
+        }
+    }
+    StringBuilderAddChar(builder, '}');
+}
+
+void fiftyoneDegreesWriteWkbAsGeoJsonToStringBuilder(
+    unsigned const char * const wellKnownBinary,
+    const WkbtotReductionMode reductionMode,
+    const DecimalPlacesType decimalPlaces,
+    fiftyoneDegreesStringBuilder * const builder,
+    fiftyoneDegreesException * const exception) {
+
+    ProcessingContext context = {
+        wellKnownBinary,
+        {
+            builder,
+            true,
+        },
+
+        CoordModes[0],
+        ~*wellKnownBinary,
+        getMachineByteOrder(),
+        NULL,
+        selectNumReader(reductionMode),
+        &POINTS_FORMAT_GEOJSON,
+
+        decimalPlaces,
+        exception,
+    };
+
+    writeGeoJsonGeometry(&context);
+}
+
+fiftyoneDegreesWkbtotResult fiftyoneDegreesConvertWkbToGeoJson(
+    const byte * const wellKnownBinary,
+    const WkbtotReductionMode reductionMode,
+    char * const buffer, size_t const length,
+    DecimalPlacesType const decimalPlaces,
+    Exception * const exception) {
+
+    StringBuilder stringBuilder = { buffer, length };
+    StringBuilderInit(&stringBuilder);
+
+    fiftyoneDegreesWriteWkbAsGeoJsonToStringBuilder(
+        wellKnownBinary,
+        reductionMode,
+        decimalPlaces,
+        &stringBuilder,
+        exception);
+
+    StringBuilderComplete(&stringBuilder);
+
+    const fiftyoneDegreesWkbtotResult result = {
+        stringBuilder.added,
+        stringBuilder.full,
+    };
+    return result;
+}
+
+typedef struct {
+    ProcessingContext context;
+    WkbCoordinatesCallback callback;
+    void *state;
+    WkbCoordinates current;
+    uint32_t points;
+    bool stopped;
+} CoordinatesIterator;
+
+/**
+ * Passes the next count points to the callback. Where the coordinates are
+ * doubles in the machine byte order and aligned then the callback is given
+ * the coordinates in the WKB. Otherwise they are decoded a batch at a time.
+ */
+static void iteratePoints(
+    CoordinatesIterator * const iterator,
+    const uint32_t count) {
+
+    ProcessingContext * const context = &iterator->context;
+    WkbCoordinates * const current = &iterator->current;
+    const CoordIndexType dims = context->coordMode.dimensionsCount;
+    const bool isSwapped = context->rawValueReader->isSwapped;
+
+    current->dimensions = dims;
+    current->hasZ = context->coordMode.hasZ;
+    current->hasM = context->coordMode.hasM;
+    current->first = 0;
+    if (context->numReader->coordSize == sizeof(double) &&
+        !isSwapped &&
+        (uintptr_t)context->binaryBuffer % sizeof(double) == 0) {
+        if (count) {
+            current->count = count;
+            current->coordinates = (const double *)context->binaryBuffer;
+            iterator->stopped = !iterator->callback(iterator->state, current);
+            iterator->points += count;
+        }
+        context->binaryBuffer += (size_t)count * dims * sizeof(double);
+        return;
+    }
+
+    const PointsDecoder decoder =
+        context->numReader->decodePoints[isSwapped][dims - 2];
+    double coords[POINTS_BATCH * 4];
+    current->coordinates = coords;
+    while (current->first < count && !iterator->stopped) {
+        current->count = count - current->first < POINTS_BATCH ?
+            count - current->first : POINTS_BATCH;
+        context->binaryBuffer = decoder(
+            context->binaryBuffer,
+            current->count,
+            coords);
+        iterator->stopped = !iterator->callback(iterator->state, current);
+        iterator->points += current->count;
+        current->first += current->count;
+    }
+}
+
+static void iterateGeometry(
+    CoordinatesIterator * const iterator) {
+
+    ProcessingContext * const context = &iterator->context;
+    Exception * const exception = context->exception;
+
+    const uint32_t geometryCode = readGeometryHeader(context);
+    if (EXCEPTION_FAILED) {
+        return;
+    }
+    iterator->current.geometryCode = geometryCode;
+    iterator->current.ringIndex = 0;
+    switch (geometryCode) {
+        case GEOMETRY_CODE_POINT:
+            iteratePoints(iterator, 1);
+            iterator->current.geometryIndex++;
+            break;
+        case GEOMETRY_CODE_LINESTRING:
+            iteratePoints(iterator, readInt(context, IntPurpose_LoopCount));
+            iterator->current.geometryIndex++;
+            break;
+        case GEOMETRY_CODE_POLYGON:
+        case GEOMETRY_CODE_TRIANGLE: {
+            const uint32_t rings = readInt(context, IntPurpose_LoopCount);
+            for (uint32_t i = 0; i < rings && !iterator->stopped; i++) {
+                iterator->current.ringIndex = i;
+                iteratePoints(
+                    iterator,
+                    readInt(context, IntPurpose_LoopCount));
+            }
+            iterator->current.geometryIndex++;
+            break;
+        }
+        default: {
+            const uint32_t count = readInt(context, IntPurpose_LoopCount);
+            for (uint32_t i = 0;
+                i < count && !iterator->stopped && EXCEPTION_OKAY;
+                i++) {
+                iterateGeometry(iterator);
+            }
+            break;
+        }
+    }
+}
+
+uint32_t fiftyoneDegreesWkbIterateCoordinates(
+    const unsigned char * const wellKnownBinary,
+    const WkbtotReductionMode reductionMode,
+    void * const state,
+    const WkbCoordinatesCallback callback,
+    fiftyoneDegreesException * const exception) {
+
+    CoordinatesIterator iterator = {
+        {
+            wellKnownBinary,
+            {
+                NULL,
+                true,
+            },
+
+            CoordModes[0],
+            ~*wellKnownBinary,
+            getMachineByteOrder(),
+            NULL,
+            selectNumReader(reductionMode),
+            &POINTS_FORMAT_WKT,
+
+            0,
+            exception,
+        },
+        callback,
+        state,
+        { 0, 0, false, false, 0, 0, 0, 0, NULL },
+        0,
+        false,
+    };
+
+    iterateGeometry(&iterator);
+    return iterator.points;
+}
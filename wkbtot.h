@@ -86,4 +86,98 @@ fiftyoneDegreesConvertWkbToWkt
  uint8_t decimalPlaces,
  fiftyoneDegreesException *exception);
 
+/**
+ * Converts WKB geometry bytes to a GeoJSON geometry object and writes it to
+ * string builder. Triangles are written as polygons, and polyhedral surfaces
+ * and TINs as multi polygons. Z values are written as the third member of
+ * each position. M values are not written, as RFC 7946 positions have no
+ * member for them, so XYM geometries are written with two dimensional
+ * positions and XYZM geometries with three.
+ * @param wellKnownBinary bytes of WKB geometry.
+ * @param reductionMode type/value reduction applied to decrease WKB size.
+ * @param decimalPlaces precision for numbers (places after the decimal dot).
+ * @param builder string builder to write GeoJSON into.
+ * @param exception pointer to the exception struct.
+ */
+EXTERNAL void
+fiftyoneDegreesWriteWkbAsGeoJsonToStringBuilder
+(const unsigned char *wellKnownBinary,
+ fiftyoneDegreesWkbtotReductionMode reductionMode,
+ uint8_t decimalPlaces,
+ fiftyoneDegreesStringBuilder *builder,
+ fiftyoneDegreesException *exception);
+
+/**
+ * Converts WKB geometry bytes to a GeoJSON geometry object written into
+ * provided buffer.
+ * @param wellKnownBinary bytes of WKB geometry.
+ * @param reductionMode type/value reduction applied to decrease WKB size.
+ * @param buffer buffer to write GeoJSON geometry into.
+ * @param length length available in the buffer.
+ * @param decimalPlaces precision for numbers (places after the decimal dot).
+ * @param exception pointer to the exception struct.
+ * @return How many bytes were written to the buffer and if it was too small.
+ */
+EXTERNAL fiftyoneDegreesWkbtotResult
+fiftyoneDegreesConvertWkbToGeoJson
+(const unsigned char *wellKnownBinary,
+ fiftyoneDegreesWkbtotReductionMode reductionMode,
+ char *buffer, size_t length,
+ uint8_t decimalPlaces,
+ fiftyoneDegreesException *exception);
+
+/**
+ * Run of decoded points passed to a #fiftyoneDegreesWkbCoordinatesCallback.
+ */
+typedef struct fiftyone_degrees_wkb_coordinates_t {
+	uint32_t geometryCode; /**< WKB code of the point, line string, polygon or
+	                       triangle the points belong to */
+	uint8_t dimensions; /**< Coordinates per point, 2 for x y, 3 for x y z or
+	                    x y m, and 4 for x y z m */
+	bool hasZ; /**< True if the third coordinate of each point is z */
+	bool hasM; /**< True if the last coordinate of each point is m */
+	uint32_t geometryIndex; /**< Index of the geometry among the points, line
+	                        strings, polygons and triangles in the WKB */
+	uint32_t ringIndex; /**< Index of the ring within a polygon or triangle,
+	                    otherwise 0 */
+	uint32_t first; /**< Index of the first point within the ring or line
+	                string */
+	uint32_t count; /**< Number of points */
+	const double *coordinates; /**< count * dimensions coordinates with those
+	                           of each point next to each other. Only valid
+	                           during the callback */
+} fiftyoneDegreesWkbCoordinates;
+
+/**
+ * Called with each run of points in a WKB geometry.
+ * @param state pointer provided to the iterate method
+ * @param coordinates the points
+ * @return true to continue with the next run, or false to stop
+ */
+typedef bool (*fiftyoneDegreesWkbCoordinatesCallback)(
+	void *state,
+	const fiftyoneDegreesWkbCoordinates *coordinates);
+
+/**
+ * Passes the coordinates of every point in the WKB geometry to the callback
+ * without forming any text. Where the WKB holds doubles in the byte order of
+ * the machine, and they are aligned, the coordinates passed point into the
+ * WKB and a whole line string or ring is passed in one call. Otherwise up to
+ * 32 points are decoded at a time into memory on the stack and passed in
+ * order, with first set to the index of the first point.
+ * @param wellKnownBinary bytes of WKB geometry.
+ * @param reductionMode type/value reduction applied to decrease WKB size.
+ * @param state pointer passed to the callback.
+ * @param callback method called with each run of points.
+ * @param exception pointer to the exception struct.
+ * @return the number of points passed to the callback.
+ */
+EXTERNAL uint32_t
+fiftyoneDegreesWkbIterateCoordinates
+(const unsigned char *wellKnownBinary,
+ fiftyoneDegreesWkbtotReductionMode reductionMode,
+ void *state,
+ fiftyoneDegreesWkbCoordinatesCallback callback,
+ fiftyoneDegreesException *exception);
+
 #endif //FIFTYONE_DEGREES_WKBTOT_H_INCLUDED
@@ -0,0 +1,169 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2025 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence (EUPL)
+ * v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "wkbtotCache.h"
+#include "fiftyone.h"
+
+MAP_TYPE(Collection)
+
+// Combines the parts of the key into a single 64 bit value. The low bits
+// vary least so the value is mixed before it is used as the hash code.
+static int64_t getKey(
+	uint32_t offset,
+	WkbtotReductionMode reductionMode,
+	uint8_t decimalPlaces) {
+	return (int64_t)(
+		((uint64_t)offset << 16) |
+		((uint64_t)(reductionMode & 0xFF) << 8) |
+		(uint64_t)decimalPlaces);
+}
+
+// Loads the WKT for the key into the cache node data by converting the WKB
+// value from the strings collection.
+static void loadWkt(
+	const void* state,
+	Data* data,
+	const void* key,
+	Exception* exception) {
+	const WkbtotCache* cache = (const WkbtotCache*)state;
+	const uint64_t parts = *(const uint64_t*)key;
+	const WkbtotReductionMode reductionMode = 
+		(WkbtotReductionMode)((parts >> 8) & 0xFF);
+	const StoredBinaryValue* value;
+	char buffer[REASONABLE_WKT_STRING_LENGTH];
+	StringBuilder builder = { buffer, sizeof(buffer) };
+	Item item;
+
+	// Set the data used to 0 in case the conversion fails for any reason.
+	data->used = 0;
+
+	DataReset(&item.data);
+	value = StoredBinaryValueGet(
+		cache->strings,
+		(uint32_t)(parts >> 16),
+		reductionMode == FIFTYONE_DEGREES_WKBToT_REDUCTION_SHORT ?
+			FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB_R :
+			FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
+		&item,
+		exception);
+	if (value == NULL || EXCEPTION_FAILED) {
+		return;
+	}
+
+	// Convert in a single pass starting with the buffer on the stack and
+	// then copy the text into the node.
+	StringBuilderInitGrowable(&builder, NULL);
+	WriteWkbAsWktToStringBuilder(
+		&value->byteArrayValue.firstByte,
+		reductionMode,
+		(uint8_t)(parts & 0xFF),
+		&builder,
+		exception);
+	StringBuilderComplete(&builder);
+	COLLECTION_RELEASE(cache->strings, &item);
+	if (EXCEPTION_OKAY && (builder.full || builder.added > UINT32_MAX)) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+	}
+	if (EXCEPTION_OKAY) {
+		if (DataMalloc(data, builder.added) != NULL) {
+			memcpy(data->ptr, builder.ptr, builder.added);
+			data->used = (uint32_t)builder.added;
+		}
+		else {
+			EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		}
+	}
+	StringBuilderFree(&builder);
+}
+
+fiftyoneDegreesWkbtotCache* fiftyoneDegreesWkbtotCacheCreate(
+	const fiftyoneDegreesCollection* strings,
+	uint32_t capacity,
+	uint16_t concurrency,
+	fiftyoneDegreesException* exception) {
+	WkbtotCache* cache = (WkbtotCache*)Malloc(sizeof(WkbtotCache));
+	if (cache == NULL) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return NULL;
+	}
+	cache->strings = strings;
+	cache->cache = CacheCreate(
+		capacity,
+		concurrency,
+		loadWkt,
+		CacheHash64Mixed,
+		cache);
+	if (cache->cache == NULL) {
+		EXCEPTION_SET(INVALID_CONFIG);
+		Free(cache);
+		return NULL;
+	}
+	return cache;
+}
+
+void fiftyoneDegreesWkbtotCacheFree(fiftyoneDegreesWkbtotCache* cache) {
+	CacheFree(cache->cache);
+	Free(cache);
+}
+
+fiftyoneDegreesCacheNode* fiftyoneDegreesWkbtotCacheGet(
+	fiftyoneDegreesWkbtotCache* cache,
+	uint32_t offset,
+	fiftyoneDegreesWkbtotReductionMode reductionMode,
+	uint8_t decimalPlaces,
+	fiftyoneDegreesException* exception) {
+	const int64_t key = getKey(offset, reductionMode, decimalPlaces);
+	CacheNode* node = CacheGet(cache->cache, &key, exception);
+	if (node != NULL && EXCEPTION_FAILED) {
+		CacheRelease(node);
+		return NULL;
+	}
+	return node;
+}
+
+void fiftyoneDegreesWkbtotCacheWriteToStringBuilder(
+	fiftyoneDegreesWkbtotCache* cache,
+	uint32_t offset,
+	fiftyoneDegreesWkbtotReductionMode reductionMode,
+	uint8_t decimalPlaces,
+	fiftyoneDegreesStringBuilder* builder,
+	fiftyoneDegreesException* exception) {
+	CacheNode* node = WkbtotCacheGet(
+		cache,
+		offset,
+		reductionMode,
+		decimalPlaces,
+		exception);
+	if (node == NULL) {
+		if (EXCEPTION_OKAY) {
+			EXCEPTION_SET(INSUFFICIENT_CAPACITY);
+		}
+		return;
+	}
+	if (node->data.used > 0) {
+		StringBuilderAddChars(
+			builder,
+			(const char*)node->data.ptr,
+			node->data.used - 1);
+	}
+	CacheRelease(node);
+}
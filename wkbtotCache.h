@@ -0,0 +1,142 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2025 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence (EUPL)
+ * v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_WKBTOT_CACHE_H_INCLUDED
+#define FIFTYONE_DEGREES_WKBTOT_CACHE_H_INCLUDED
+
+/**
+ * @ingroup FiftyOneDegreesCommon
+ * @defgroup FiftyOneDegreesWkbtotCache WKT Cache
+ *
+ * Cache of well known text converted from well known binary values.
+ *
+ * ## Introduction
+ *
+ * Values in a data set never change, so the well known text (WKT) for a
+ * geometry stored as well known binary (WKB) is the same every time it is
+ * requested. A WKT cache is created for a data set's strings collection and
+ * converts each geometry the first time it is requested. Later requests for
+ * the same geometry copy the text from the cache rather than parsing the
+ * WKB and formatting each coordinate again.
+ *
+ * ## Keys
+ *
+ * Entries are keyed by the offset of the value in the strings collection,
+ * the reduction mode, and the number of decimal places. The same geometry
+ * requested with a different precision is a different entry.
+ *
+ * ## Capacity
+ *
+ * The cache is a #fiftyoneDegreesCache so it is bounded, thread safe, and
+ * evicts the least recently used entries when full. The capacity must be at
+ * least the concurrency squared as described in cache.h.
+ *
+ * @{
+ */
+
+#include <stdint.h>
+#include "cache.h"
+#include "collection.h"
+#include "stringBuilder.h"
+#include "wkbtot.h"
+#include "exceptions.h"
+#include "common.h"
+
+/**
+ * WKT cache for the geometries in a strings collection.
+ */
+typedef struct fiftyone_degrees_wkbtot_cache_t {
+	fiftyoneDegreesCache* cache; /**< Cache of WKT keyed by offset, reduction
+								 mode and decimal places */
+	const fiftyoneDegreesCollection* strings; /**< Collection the WKB values
+											  are read from */
+} fiftyoneDegreesWkbtotCache;
+
+/**
+ * Creates a WKT cache for the geometries in the strings collection. The
+ * cache must be freed with #fiftyoneDegreesWkbtotCacheFree before the
+ * collection is freed.
+ * @param strings collection containing the WKB values
+ * @param capacity maximum number of converted geometries to keep
+ * @param concurrency expected number of concurrent operations
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return pointer to the new cache, or NULL if it could not be created
+ */
+EXTERNAL fiftyoneDegreesWkbtotCache* fiftyoneDegreesWkbtotCacheCreate(
+	const fiftyoneDegreesCollection* strings,
+	uint32_t capacity,
+	uint16_t concurrency,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Frees the cache and all the text it contains.
+ * @param cache to free
+ */
+EXTERNAL void fiftyoneDegreesWkbtotCacheFree(
+	fiftyoneDegreesWkbtotCache* cache);
+
+/**
+ * Gets the null terminated WKT for the WKB value at the offset, converting
+ * it if it is not already in the cache. The text is at data.ptr of the node
+ * returned, and data.used includes the null terminator. The node must be
+ * released with #fiftyoneDegreesCacheRelease.
+ * @param cache to get the text from
+ * @param offset of the WKB value in the strings collection
+ * @param reductionMode of the stored value
+ * @param decimalPlaces precision for numbers (places after the decimal dot)
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return the node containing the text, or NULL if there are no free nodes
+ */
+EXTERNAL fiftyoneDegreesCacheNode* fiftyoneDegreesWkbtotCacheGet(
+	fiftyoneDegreesWkbtotCache* cache,
+	uint32_t offset,
+	fiftyoneDegreesWkbtotReductionMode reductionMode,
+	uint8_t decimalPlaces,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Writes the WKT for the WKB value at the offset to the builder, using the
+ * cache to avoid converting the same geometry again. The builder is not
+ * completed.
+ * @param cache to get the text from
+ * @param offset of the WKB value in the strings collection
+ * @param reductionMode of the stored value
+ * @param decimalPlaces precision for numbers (places after the decimal dot)
+ * @param builder string builder to write WKT into
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ */
+EXTERNAL void fiftyoneDegreesWkbtotCacheWriteToStringBuilder(
+	fiftyoneDegreesWkbtotCache* cache,
+	uint32_t offset,
+	fiftyoneDegreesWkbtotReductionMode reductionMode,
+	uint8_t decimalPlaces,
+	fiftyoneDegreesStringBuilder* builder,
+	fiftyoneDegreesException* exception);
+
+/**
+ * @}
+ */
+
+#endif
@@ -27,13 +27,19 @@
 
 #include "wkbtot_pp.hpp"
 
-#include <memory>
-
 #include "fiftyone.h"
 
 namespace FiftyoneDegrees::Common {
 
-    WkbtotResult writeWkbStringToStringStream(
+    typedef void (*WkbWriter)(
+        const unsigned char *wellKnownBinary,
+        WkbtotReductionMode reductionMode,
+        uint8_t decimalPlaces,
+        StringBuilder *builder,
+        Exception *exception);
+
+    static WkbtotResult writeWkbStringToStream(
+        const WkbWriter writer,
         const VarLengthByteArray * const wkbString,
         WkbtotReductionMode reductionMode,
         std::stringstream &stream,
@@ -56,33 +62,12 @@ namespace FiftyoneDegrees::Common {
         }
 
         {
+            // Start with the buffer on the stack and only allocate memory if
+            // the text is longer so that it is always produced in one pass.
             char buffer[REASONABLE_WKT_STRING_LENGTH];
             StringBuilder builder = { buffer, REASONABLE_WKT_STRING_LENGTH };
-            StringBuilderInit(&builder);
-            WriteWkbAsWktToStringBuilder(
-                wkbBytes,
-                reductionMode,
-                decimalPlaces,
-                &builder,
-                exception
-                );
-            StringBuilderComplete(&builder);
-            toWktResult = {
-                builder.added,
-                builder.full,
-            };
-            if (EXCEPTION_OKAY && !toWktResult.bufferTooSmall) {
-                stream << buffer;
-                return toWktResult;
-            }
-        }
-        if (toWktResult.bufferTooSmall) {
-            EXCEPTION_CLEAR;
-            const size_t requiredSize = toWktResult.written + 1;
-            const std::unique_ptr<char[]> buffer = std::make_unique<char[]>(requiredSize);
-            StringBuilder builder = { buffer.get(), requiredSize };
-            StringBuilderInit(&builder);
-            WriteWkbAsWktToStringBuilder(
+            StringBuilderInitGrowable(&builder, nullptr);
+            writer(
                 wkbBytes,
                 reductionMode,
                 decimalPlaces,
@@ -95,10 +80,64 @@ namespace FiftyoneDegrees::Common {
                 builder.full,
             };
             if (EXCEPTION_OKAY && !toWktResult.bufferTooSmall) {
-                stream << buffer.get();
-                return toWktResult;
+                stream << builder.ptr;
             }
+            StringBuilderFree(&builder);
         }
         return toWktResult;
     }
+
+    WkbtotResult writeWkbStringToStringStream(
+        const VarLengthByteArray * const wkbString,
+        WkbtotReductionMode reductionMode,
+        std::stringstream &stream,
+        const uint8_t decimalPlaces,
+        Exception * const exception) {
+        return writeWkbStringToStream(
+            WriteWkbAsWktToStringBuilder,
+            wkbString,
+            reductionMode,
+            stream,
+            decimalPlaces,
+            exception);
+    }
+
+    WkbtotResult writeWkbStringAsGeoJsonToStringStream(
+        const VarLengthByteArray * const wkbString,
+        WkbtotReductionMode reductionMode,
+        std::stringstream &stream,
+        const uint8_t decimalPlaces,
+        Exception * const exception) {
+        return writeWkbStringToStream(
+            WriteWkbAsGeoJsonToStringBuilder,
+            wkbString,
+            reductionMode,
+            stream,
+            decimalPlaces,
+            exception);
+    }
+
+    static bool callFunction(
+        void * const state,
+        const WkbCoordinates * const coordinates) {
+        return (*(const std::function<bool(const WkbCoordinates&)>*)state)(
+            *coordinates);
+    }
+
+    uint32_t iterateWkbStringCoordinates(
+        const VarLengthByteArray * const wkbString,
+        WkbtotReductionMode reductionMode,
+        const std::function<bool(const WkbCoordinates&)> &callback,
+        Exception * const exception) {
+        if (!wkbString || !exception) {
+            EXCEPTION_SET(FIFTYONE_DEGREES_STATUS_NULL_POINTER);
+            return 0;
+        }
+        return WkbIterateCoordinates(
+            &wkbString->firstByte,
+            reductionMode,
+            (void*)&callback,
+            callFunction,
+            exception);
+    }
 }
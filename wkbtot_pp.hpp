@@ -26,6 +26,7 @@
 #include "wkbtot.h"
 #include "string.h"
 #include <sstream>
+#include <functional>
 
 namespace FiftyoneDegrees::Common {
     /**
@@ -43,6 +44,40 @@ namespace FiftyoneDegrees::Common {
         std::stringstream &stream,
         uint8_t decimalPlaces,
         fiftyoneDegreesException *exception);
+
+    /**
+     * Converts WKB "string" to a GeoJSON geometry object and pushes it into
+     * a string stream.
+     * @param wkbString "string" containing WKB geometry.
+     * @param reductionMode type/value reduction applied to decrease WKB size.
+     * @param stream string stream to push GeoJSON into.
+     * @param decimalPlaces precision for numbers (places after the decimal dot).
+     * @param exception pointer to the exception struct.
+     * @return How many bytes were written to the buffer and if it was too small.
+     */
+    fiftyoneDegreesWkbtotResult writeWkbStringAsGeoJsonToStringStream(
+        const fiftyoneDegreesVarLengthByteArray *wkbString,
+        fiftyoneDegreesWkbtotReductionMode reductionMode,
+        std::stringstream &stream,
+        uint8_t decimalPlaces,
+        fiftyoneDegreesException *exception);
+
+    /**
+     * Passes the coordinates of every point in the WKB "string" to the
+     * callback without forming any text. See
+     * fiftyoneDegreesWkbIterateCoordinates.
+     * @param wkbString "string" containing WKB geometry.
+     * @param reductionMode type/value reduction applied to decrease WKB size.
+     * @param callback called with each run of points, returns false to stop.
+     * @param exception pointer to the exception struct.
+     * @return the number of points passed to the callback.
+     */
+    uint32_t iterateWkbStringCoordinates(
+        const fiftyoneDegreesVarLengthByteArray *wkbString,
+        fiftyoneDegreesWkbtotReductionMode reductionMode,
+        const std::function<bool(const fiftyoneDegreesWkbCoordinates&)>
+            &callback,
+        fiftyoneDegreesException *exception);
 }
 
 #endif //FIFTYONE_DEGREES_WKBTOT_HPP_INCLUDED